@@ -0,0 +1,72 @@
+/*
+  bench.h - Tiny timing harness shared by the host benchmarks
+ */
+#pragma once
+#include <chrono>
+#include <stdio.h>
+#include <stdint.h>
+
+// Sample ISS TLE used across benchmarks
+static const char BENCH_TLE_LINE1[] = "1 25544U 98067A   23066.54791667  .00016717  00000+0  30197-3 0  9996";
+static const char BENCH_TLE_LINE2[] = "2 25544  51.6416 152.6744 0005895  32.5834  53.5373 15.49425626385923";
+
+// Unix time (s) of the sample TLE epoch (2023 day 66.54791667)
+#define BENCH_TLE_EPOCH_UNIX 1678194540UL
+
+// Overwrite column 69 of a TLE line with the correct modulo-10 checksum
+inline void benchFixChecksum(char* line) {
+    int sum = 0;
+    for (int i = 0; i < 68; ++i) {
+        if (line[i] >= '0' && line[i] <= '9') sum += line[i] - '0';
+        else if (line[i] == '-') sum += 1;
+    }
+    line[68] = char('0' + sum % 10);
+}
+
+// Keep the compiler from discarding a result
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Time `iters` calls of fn and return the mean cost in nanoseconds per call
+template <typename Fn>
+double benchNs(uint64_t iters, Fn&& fn) {
+    // Warm up caches & branch predictors
+    for (uint64_t i = 0; i < iters / 10 + 1; ++i) fn(i);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iters; ++i) fn(i);
+    auto t1 = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(iters);
+}
+
+// Print one result row in a format that diffs cleanly across commits
+inline void benchReport(const char* name, double nsPerCall) {
+    printf("%-32s %12.1f ns/call\n", name, nsPerCall);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+// Timestamp-counter ticks per nanosecond, measured once against steady_clock
+inline double tscPerNs() {
+    static double ratio = 0;
+    if (ratio == 0) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = __rdtsc();
+        while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(20)) {}
+        uint64_t c1 = __rdtsc();
+        auto t1 = std::chrono::steady_clock::now();
+        ratio = double(c1 - c0) / std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    return ratio;
+}
+#else
+inline double tscPerNs() { return 0; }
+#endif
+
+// Same as benchReport, plus an approximate cycle count from the timestamp counter where available
+inline void benchReportCycles(const char* name, double nsPerCall) {
+    printf("%-32s %12.1f ns/call %10.0f cycles\n", name, nsPerCall, nsPerCall * tscPerNs());
+}
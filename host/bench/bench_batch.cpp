@@ -0,0 +1,86 @@
+/*
+  bench_batch.cpp - Scalar Orbit::calcPosVelECI vs. OrbitBatch over synthetic catalogs
+ */
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "orbit_batch.h"
+
+// Build a catalog of random but physically plausible orbits around the sample TLE epoch
+static std::vector<Orbit> makeCatalog(size_t count, uint32_t seed) {
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(line1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(line2));
+    Orbit base{};
+    base.initFromTLE(line1, line2);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<Orbit> cat(count, base);
+    for (Orbit& o : cat) {
+        o.incl  = u(rng) * PI;
+        o.Omega = u(rng) * TWO_PI;
+        o.omega = u(rng) * TWO_PI;
+        o.M0    = u(rng) * TWO_PI;
+        o.ecc   = u(rng) < 0.9 ? u(rng) * 0.02 : u(rng) * 0.75;
+        o.n     = (1. + u(rng) * 15.) * TWO_PI / SECONDS_PER_DAY;
+        o.a     = pow(MU_EARTH / (o.n*o.n), 1./3.);
+        o.epoch = base.epoch - int64_t(u(rng) * 3. * NS_PER_DAY);
+    }
+    return cat;
+}
+
+int main() {
+    const double t = BENCH_TLE_EPOCH_UNIX + 3600.;
+
+    printf("%-8s %14s %14s %10s %14s\n", "N", "scalar ns/sat", "batch ns/sat", "speedup", "max |dr| [m]");
+    for (size_t count : {100, 1000, 10000, 50000}) {
+        std::vector<Orbit> cat = makeCatalog(count, 1234);
+        OrbitBatch batch;
+        batch.reserve(count);
+        for (const Orbit& o : cat) batch.add(o);
+
+        BatchState st;
+        std::vector<Vec3> pos(count), vel(count);
+        const uint64_t reps = 2000000 / count + 1;
+
+        double tScalar = benchNs(reps, [&](uint64_t) {
+            for (size_t i = 0; i < count; ++i)
+                cat[i].calcPosVelECI(t - batch.epochUnix[i], pos[i], vel[i]);
+            doNotOptimize(pos[0].x);
+        }) / double(count);
+
+        double tBatch = benchNs(reps, [&](uint64_t) {
+            batch.propagate(t, st);
+            doNotOptimize(st.x[0]);
+        }) / double(count);
+
+        double maxErr = 0.;
+        for (size_t i = 0; i < count; ++i) {
+            Vec3 d = pos[i] - Vec3{st.x[i], st.y[i], st.z[i]};
+            maxErr = fmax(maxErr, norm(d));
+        }
+        printf("%-8zu %14.1f %14.1f %9.2fx %14.3e\n", count, tScalar, tBatch, tScalar / tBatch, maxErr);
+    }
+
+    // Convergence of the fixed-iteration Kepler solve against the open-ended scalar Newton loop
+    const size_t nK = 100000;
+    std::vector<double> M(nK), e(nK), E(nK);
+    for (size_t i = 0; i < nK; ++i) {
+        M[i] = TWO_PI * double(i) / nK - PI;
+        e[i] = 0.9 * double(i % 1000) / 1000.;
+    }
+    eccAnomalyFromMeanBatch(M.data(), e.data(), E.data(), nK);
+    double maxRes = 0.;
+    for (size_t i = 0; i < nK; ++i) {
+        double res = E[i] - e[i]*sin(E[i]) - M[i];
+        maxRes = fmax(maxRes, fabs(res - TWO_PI * floor(res / TWO_PI + 0.5)));
+    }
+    printf("\nKepler residual, %d fixed iterations, ecc <= 0.9: %.3e rad\n", BATCH_KEPLER_ITERS, maxRes);
+    benchReport("eccAnomalyFromMeanBatch", benchNs(200, [&](uint64_t) {
+        eccAnomalyFromMeanBatch(M.data(), e.data(), E.data(), nK);
+        doNotOptimize(E[0]);
+    }) / double(nK));
+
+    return 0;
+}
@@ -0,0 +1,350 @@
+/*
+  bench_boot.cpp - Orbit snapshot storage checks & a boot simulation on the virtual clock, cold and warm
+    The snapshot load, orbit init and first pointing solution are run for real and timed. Each boot then runs
+    setup()'s network steps through the sketch's NetLink, and its Scheduler, PointingSolver and Pedestal, against
+    a scripted AP, time server and Celestrak until the first pointing command. The task wrappers mirror the
+    sketch's, which needs WiFiNINA, and the steps before networking (display, servo test, compass) are charged
+    a fixed time. Warm boots are also run with setup() waiting on the network as it did before the boot timeouts.
+ */
+#include "bench.h"
+#include "orbit_snapshot.h"
+#include "orbit_tracker.h"
+#include "net_link.h"
+#include "pointing.h"
+#include "pedestal.h"
+#include "scheduler.h"
+
+#define NEVER -1.0
+
+// Assumed setup() cost before networking: OLED power-up & splash, servo range test, 3 compass attempts
+#define HW_SETUP_MS             (250 + 250 + 1000 + 4000 + 3 * 1500)
+#define WIFI_CONNECTED_MS       (1000 + 100)    // delays after association & before NTP
+#define WIFI_BEGIN_TIMEOUT_MS   10000   // WiFi.begin() gives up after this while it blocks in setup()
+#define COST_SPI_US             300     // One command to the WiFi co-processor
+#define COST_WIFI_BEGIN_US      2000    // Non-blocking begin once the tasks run
+#define TLE_CONNECT_MS          150     // DNS & TCP handshake in client.connect()
+#define LOOP_US                 100     // loop() overhead per scheduler pass
+#define SIM_LIMIT_MS            (10 * 60 * 1000)
+#define BOOT_UNIX               (BENCH_TLE_EPOCH_UNIX + 7200)
+
+struct Scenario {
+    const char* name;
+    double apUpMs;          // AP accepts associations from this time after power-up
+    double assocMs;         // Duration of a successful association
+    double ntpUpMs;         // Time server answers requests sent from this time
+    int ntpLost;            // Replies lost before one arrives
+    double ntpRttMs;
+    double tleMs;           // Celestrak response time, NEVER if unreachable
+};
+
+static const Scenario scenarios[] = {
+    {"nominal",                 0,      2500, 0,     0, 40, 1200},
+    {"Celestrak unreachable",   0,      2500, 0,     0, 40, NEVER},
+    {"one NTP reply lost",      0,      2500, 0,     1, 40, 1200},
+    {"time server down 60 s",   0,      2500, 60000, 0, 40, 1200},
+    {"AP up 30 s after boot",   30000,  2500, 0,     0, 40, 1200},
+    {"AP down 5 min",           300000, 2500, 0,     0, 40, 1200},
+};
+
+// One boot, with the sketch state its tasks touch
+struct BootSim {
+    const Scenario* s;
+    bool inSetup;           // WiFi.begin() blocks until setup() calls WiFi.setTimeout(0)
+    bool connected;
+    double assocDoneMs;     // Association in progress completes at this time, NEVER if it won't
+    uint8_t request[NTP_PACKET_SIZE];
+    int nNtpAnswered;
+    double ntpReplyMs;      // Arrival of the reply to the outstanding request, NEVER if none is coming
+    double tleDoneMs;
+    bool tleOk;
+
+    NtpClock clock;
+    NetLink net;
+    Scheduler sched;
+    int ntpTaskId;
+    OrbitSnapshot snapshot;
+    bool orbitReady;
+    bool snapshotPending;
+    OrbitModel orb;
+    PointingSolver pointing;
+    Pedestal ped;
+
+    double setupMs;         // setup() returned & the stepper is serviced
+    double trackMs;         // First pointing command
+};
+
+static const Vec3 llaRef = {42.36, -71.06, 0};
+
+static double nowMs() { return hostClockUs / 1e3; }
+static uint32_t simMillis() { return millis(); }
+static uint32_t simMicros() { return micros(); }
+
+// Scripted network hooks, each charged its SPI round trip so busy-wait loops advance the clock
+static bool simWifiBegin(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    bool apUp = nowMs() >= b.s->apUpMs;
+    if (b.inSetup) {
+        delay(uint32_t(apUp ? b.s->assocMs : WIFI_BEGIN_TIMEOUT_MS));
+        b.connected = apUp;
+        return b.connected;
+    }
+    delayMicroseconds(COST_WIFI_BEGIN_US);
+    b.connected = false;
+    b.assocDoneMs = apUp ? nowMs() + b.s->assocMs : NEVER;
+    return false;
+}
+
+static bool simWifiConnected(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    delayMicroseconds(COST_SPI_US);
+    if (!b.connected && b.assocDoneMs != NEVER && nowMs() >= b.assocDoneMs) b.connected = true;
+    return b.connected;
+}
+
+static void simNtpSend(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    delayMicroseconds(COST_SPI_US);
+    b.clock.buildRequest(b.request, millis());
+    bool answered = nowMs() >= b.s->ntpUpMs && b.nNtpAnswered++ >= b.s->ntpLost;
+    b.ntpReplyMs = answered ? nowMs() + b.s->ntpRttMs : NEVER;
+}
+
+// Stratum 2 reply stamped with true time, half a round trip before it arrives
+static bool simNtpReceive(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    delayMicroseconds(COST_SPI_US);
+    if (b.ntpReplyMs == NEVER || nowMs() < b.ntpReplyMs) return false;
+    int64_t t = int64_t(BOOT_UNIX) * 1000000 + int64_t((b.ntpReplyMs - b.s->ntpRttMs / 2) * 1e3);
+    b.ntpReplyMs = NEVER;
+
+    uint8_t reply[NTP_PACKET_SIZE] = {};
+    reply[0] = 0b00100100;      // LI 0, version 4, mode 4 (server)
+    reply[1] = 2;
+    reply[2] = b.request[2];
+    reply[3] = 0xE9;
+    memcpy(reply + 12, "GPS\0", 4);
+    memcpy(reply + 24, b.request + 40, 8);
+    unixUsToNtp(t - 16000000, reply + 16);
+    unixUsToNtp(t, reply + 32);
+    unixUsToNtp(t, reply + 40);
+    return b.clock.processReply(reply, NTP_PACKET_SIZE, millis()) != NTP_INVALID;
+}
+
+static void simTleSend(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    delay(TLE_CONNECT_MS);
+    b.tleOk = b.s->tleMs != NEVER;
+    b.tleDoneMs = b.tleOk ? nowMs() + b.s->tleMs : nowMs();
+}
+
+static bool simTleReceive(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    delayMicroseconds(COST_SPI_US);
+    return nowMs() >= b.tleDoneMs;
+}
+
+static bool simTleApply(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    if (!b.tleOk) return false;
+    b.orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    b.pointing.orbitUpdated();
+    b.orbitReady = true;
+    b.snapshotPending = false;
+    return true;
+}
+
+static void useSnapshot(BootSim& b) {
+    b.snapshotPending = false;
+    if (!b.snapshot.fresh(uint32_t(b.clock.utcMs(millis()) / 1000))) return;
+    b.orb.initFromTLE(b.snapshot.line1, b.snapshot.line2);
+    b.pointing.orbitUpdated();
+    b.orbitReady = true;
+}
+
+// Task wrappers, as in the sketch
+static void stepperIdle(void* ctx) { ((BootSim*)ctx)->ped.runStepper(); }
+static void wifiTask(void* ctx) { ((BootSim*)ctx)->net.wifiTask(); }
+static void tleTask(void* ctx) { ((BootSim*)ctx)->net.tleTask(); }
+
+static void ntpTask(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    b.net.ntpTask();
+    b.sched.setPeriod(b.ntpTaskId, b.net.ntpPacketSent ? 0 : NET_POLL_MS);
+    if (b.snapshotPending && b.clock.synced) useSnapshot(b);
+}
+
+static void ephemTask(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    if (!b.orbitReady || !b.clock.synced) return;
+    b.pointing.fitEphem(b.clock.utcMs(millis()));
+}
+
+static void orbitTask(void* ctx) {
+    BootSim& b = *(BootSim*)ctx;
+    if (!b.orbitReady || !b.clock.synced) return;
+    if (!b.pointing.solve(b.clock.utcMs(millis()))) return;
+    b.ped.point(b.pointing.aer, b.pointing.rates);
+    if (b.trackMs == NEVER) b.trackMs = nowMs();
+}
+
+// Power up, run setup()'s network steps, then the task loop until the first pointing command or SIM_LIMIT_MS.
+// bounded selects the warm-start timeouts, which apply only when a snapshot was loaded
+static void runBoot(BootSim& b, const Scenario& s, bool warm, bool bounded) {
+    hostClockUs = 0;
+    b.s = &s;
+    b.inSetup = true;
+    b.assocDoneMs = b.ntpReplyMs = b.tleDoneMs = NEVER;
+    b.setupMs = b.trackMs = NEVER;
+
+    b.ped.begin();
+    b.pointing.begin(llaRef, b.orb);
+    delay(HW_SETUP_MS);
+    b.ped.stepper.setCurrentPosition(0);
+
+    b.snapshotPending = warm && loadOrbitSnapshot(b.snapshot) == 0;
+    NetHooks hooks = {&b, simWifiBegin, simWifiConnected, simNtpSend, simNtpReceive, simTleSend, simTleReceive,
+                      simTleApply};
+    b.clock.begin();
+    b.net.begin(hooks, b.clock);
+    bool limitWaits = bounded && b.snapshotPending;
+    if (b.net.associate(limitWaits)) delay(WIFI_CONNECTED_MS);
+    if (b.net.waitForNtp(limitWaits) && b.snapshotPending) useSnapshot(b);
+    b.inSetup = false;
+    b.setupMs = nowMs();
+
+    b.sched.begin(simMillis, simMicros, stepperIdle, &b);
+    b.sched.add("wifi", wifiTask, &b, WIFI_TASK_MS);
+    b.ntpTaskId = b.sched.add("ntp", ntpTask, &b, NET_POLL_MS);
+    b.sched.add("tle", tleTask, &b, NET_POLL_MS);
+    b.sched.add("orbit", orbitTask, &b, ORBIT_REFRESH_DELAY_MS, ORBIT_REFRESH_DELAY_MS/2);
+    b.sched.add("ephem", ephemTask, &b, EPHEM_TASK_MS);
+    while (b.trackMs == NEVER && nowMs() < SIM_LIMIT_MS) {
+        b.sched.runOnce();
+        delayMicroseconds(LOOP_US);
+    }
+}
+
+static void printMs(double ms) {
+    if (ms == NEVER) printf(" %8s", "never");
+    else printf(" %6.1f s", ms / 1e3);
+}
+
+int main() {
+    int failures = 0;
+    remove(SNAPSHOT_PATH);
+
+    // Storage round trip & rejection of damaged records
+    OrbitSnapshot snap, loaded;
+    snap.fill(BENCH_TLE_LINE1, BENCH_TLE_LINE2, BENCH_TLE_EPOCH_UNIX + 3600);
+    bool missing = loadOrbitSnapshot(loaded) != 0;
+    bool saved = saveOrbitSnapshot(snap) == 0 && loadOrbitSnapshot(loaded) == 0 &&
+                 memcmp(&snap, &loaded, sizeof(snap)) == 0;
+
+    OrbitSnapshot bad = snap;
+    bad.line2[20] ^= 1;
+    bool corrupt = !bad.valid();
+    bad = snap;
+    bad.version = SNAPSHOT_VERSION + 1;
+    bad.crc = crc32(&bad, offsetof(OrbitSnapshot, crc));
+    bool versioned = !bad.valid();
+
+    FILE* fp = fopen(SNAPSHOT_PATH, "r+b");
+    if (fp) {
+        fseek(fp, 40, SEEK_SET);
+        fputc('#', fp);
+        fclose(fp);
+    }
+    bool flipped = loadOrbitSnapshot(loaded) != 0;
+
+    // Age bound: trusted up to SNAPSHOT_MAX_AGE_H after the TLE epoch, not beyond it or before it, whenever saved
+    uint32_t maxAge = uint32_t(SNAPSHOT_MAX_AGE_H) * 3600;
+    uint32_t epoch = BENCH_TLE_EPOCH_UNIX;
+    bool aged = snap.fresh(epoch) && snap.fresh(epoch + maxAge) && !snap.fresh(epoch + maxAge + 1) &&
+                !snap.fresh(epoch - 1);
+
+    // Hourly refreshes of the same TLE must not rewrite the store, new elements must
+    saveOrbitSnapshot(snap);
+    OrbitSnapshot later;
+    later.fill(BENCH_TLE_LINE1, BENCH_TLE_LINE2, snap.savedUnix + 3600);
+    bool kept = saveOrbitSnapshot(later) == 0 && loadOrbitSnapshot(loaded) == 0 && loaded.savedUnix == snap.savedUnix;
+    char newLine1[sizeof(BENCH_TLE_LINE1)];
+    memcpy(newLine1, BENCH_TLE_LINE1, sizeof(newLine1));
+    newLine1[24] = '6';     // Epoch a tenth of a day later
+    benchFixChecksum(newLine1);
+    later.fill(newLine1, BENCH_TLE_LINE2, snap.savedUnix + 7200);
+    bool rewritten = saveOrbitSnapshot(later) == 0 && loadOrbitSnapshot(loaded) == 0 &&
+                     loaded.savedUnix == later.savedUnix;
+
+    printf("Snapshot record: %zu bytes\n", sizeof(OrbitSnapshot));
+    printf("  missing store rejected:   %s\n", missing ? "yes" : "NO");
+    printf("  save/load round trip:     %s\n", saved ? "ok" : "FAILED");
+    printf("  corrupted TLE rejected:   %s\n", corrupt ? "yes" : "NO");
+    printf("  newer version rejected:   %s\n", versioned ? "yes" : "NO");
+    printf("  flipped file byte rejected: %s\n", flipped ? "yes" : "NO");
+    printf("  TLE epoch older than %d h distrusted: %s\n", SNAPSHOT_MAX_AGE_H, aged ? "yes" : "NO");
+    printf("  same TLE not rewritten:   %s\n", kept ? "yes" : "NO");
+    printf("  new TLE rewritten:        %s\n\n", rewritten ? "yes" : "NO");
+    failures += !missing + !saved + !corrupt + !versioned + !flipped + !aged + !kept + !rewritten;
+    remove(SNAPSHOT_PATH);
+    saveOrbitSnapshot(snap);
+
+    // Real cost of going from stored record to the first Az/El solution
+    ObserverFrame observer;
+    observer.init(llaRef, DEGREES);
+    Orbit orb;
+    OrbitTracker tracker;
+    Vec3 posECI, velECI, aer;
+    uint64_t UTC_ms = uint64_t(BENCH_TLE_EPOCH_UNIX + 7200) * 1000;
+    double warmNs = benchNs(2000, [&](uint64_t) {
+        loadOrbitSnapshot(loaded);
+        orb.initFromTLE(loaded.line1, loaded.line2);
+        tracker.init(orb);
+        tracker.update(UTC_ms, posECI, velECI);
+        aer = observer.lookAngles(tracker.eci2ecef(posECI));
+        doNotOptimize(aer);
+    });
+
+    // Warm-started pointing must match a fresh parse of the same TLE
+    Orbit fresh;
+    fresh.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    OrbitTracker freshTracker;
+    freshTracker.init(fresh);
+    Vec3 freshPos;
+    freshTracker.update(UTC_ms, freshPos, velECI);
+    Vec3 freshAer = observer.lookAngles(freshTracker.eci2ecef(freshPos));
+    bool same = aer.x == freshAer.x && aer.y == freshAer.y && aer.z == freshAer.z;
+    failures += !same;
+    printf("Snapshot load + init + first Az/El: %.1f us on host, matches fresh TLE: %s\n\n",
+           warmNs / 1e3, same ? "yes" : "NO");
+
+    // Boot runs: cold, warm with setup() blocking on the network as before, and warm with the boot timeouts
+    printf("Boot on the virtual clock, time to setup() done / first pointing command (%d min limit)\n",
+           SIM_LIMIT_MS / 60000);
+    printf("%-24s %18s %18s %18s\n", "scenario", "cold", "warm, no timeouts", "warm");
+    double setupLimitMs = HW_SETUP_MS + WIFI_BEGIN_TIMEOUT_MS + WIFI_CONNECTED_MS + BOOT_NTP_WAIT_MS + 100;
+    for (const Scenario& s : scenarios) {
+        BootSim* runs[3];
+        for (int i = 0; i < 3; ++i) {
+            runs[i] = new BootSim();
+            runBoot(*runs[i], s, i > 0, i == 2);
+        }
+        const BootSim &blocking = *runs[1], &warm = *runs[2];
+
+        // The warm start must leave setup() within its bounds, track whenever it can, and never later than
+        // blocking would have, give or take a reconnect attempt
+        bool ok = warm.setupMs <= setupLimitMs && warm.trackMs != NEVER &&
+                  (blocking.trackMs == NEVER || warm.trackMs <= blocking.trackMs + WIFI_CONNECT_TIMEOUT_MS);
+        failures += !ok;
+        printf("%-24s", s.name);
+        for (int i = 0; i < 3; ++i) {
+            printMs(runs[i]->setupMs);
+            printMs(runs[i]->trackMs);
+            delete runs[i];
+        }
+        printf("%s\n", ok ? "" : "  FAIL");
+    }
+
+    remove(SNAPSHOT_PATH);
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
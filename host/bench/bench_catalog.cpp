@@ -0,0 +1,90 @@
+/*
+  bench_catalog.cpp - Throughput of the zero-copy catalog scanner on a synthetic Celestrak-sized 3LE file
+ */
+#include <stdlib.h>
+#include <vector>
+#include "bench.h"
+#include "mapped_file.h"
+#include "orbit_batch.h"
+#include "tle_catalog.h"
+
+// Write `count` 3LE records derived from the sample ISS TLE, with a few corrupted ones mixed in
+static bool writeCatalog(const char* path, int count, int everyNthBad) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) return false;
+    srand(7);
+    for (int i = 0; i < count; ++i) {
+        char l1[TLE_LEN + 1], l2[TLE_LEN + 1];
+        memcpy(l1, BENCH_TLE_LINE1, sizeof(l1));
+        memcpy(l2, BENCH_TLE_LINE2, sizeof(l2));
+        char cat[6];
+        snprintf(cat, sizeof(cat), "%05d", i % 100000);
+        memcpy(l1 + 2, cat, 5);
+        memcpy(l2 + 2, cat, 5);
+        char buf[9];
+        snprintf(buf, sizeof(buf), "%8.4f", (rand() % 3600000) / 10000.0);
+        memcpy(l2 + 17, buf, 8);
+        snprintf(buf, sizeof(buf), "%8.4f", (rand() % 3600000) / 10000.0);
+        memcpy(l2 + 43, buf, 8);
+        benchFixChecksum(l1);
+        benchFixChecksum(l2);
+        if (everyNthBad && i % everyNthBad == everyNthBad - 1) l2[TLE_LEN - 1] = l2[TLE_LEN - 1] == '0' ? '1' : '0';
+        fprintf(fp, "SAT-%05d               \r\n%s\r\n%s\r\n", i, l1, l2);
+    }
+    fclose(fp);
+    return true;
+}
+
+int main() {
+    const char* path = "bench_catalog.txt";
+    const int count = 12000;
+    if (!writeCatalog(path, count, 1000)) {
+        printf("Couldn't write %s\n", path);
+        return 1;
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        printf("Couldn't map %s\n", path);
+        return 1;
+    }
+
+    TleCatalogReader reader;
+    TleRecord rec;
+    reader.begin(file.data, file.size);
+    while (reader.next(rec)) {}
+    printf("%s: %zu bytes, %u valid records, %u rejected\n\n", path, file.size, reader.nRecords, reader.nBad);
+
+    double scanNs = benchNs(50, [&](uint64_t) {
+        reader.begin(file.data, file.size);
+        while (reader.next(rec)) doNotOptimize(rec.line1);
+    });
+
+    std::vector<Orbit> orbits(count);
+    double initNs = benchNs(50, [&](uint64_t) {
+        reader.begin(file.data, file.size);
+        size_t n = 0;
+        while (reader.next(rec)) orbits[n++].initFromTLE(rec.line1, rec.line2);
+        doNotOptimize(orbits[0].a);
+    });
+
+    OrbitBatch batch;
+    double batchNs = benchNs(50, [&](uint64_t) {
+        batch.clear();
+        reader.begin(file.data, file.size);
+        Orbit orb;
+        while (reader.next(rec)) {
+            orb.initFromTLE(rec.line1, rec.line2);
+            batch.add(orb);
+        }
+        doNotOptimize(batch.a[0]);
+    });
+
+    printf("%-32s %10.3f ms %10.1f MB/s\n", "scan + checksum", scanNs / 1e6, file.size / scanNs * 1e3);
+    printf("%-32s %10.3f ms %10.1f MB/s\n", "scan + Orbit::initFromTLE", initNs / 1e6, file.size / initNs * 1e3);
+    printf("%-32s %10.3f ms %10.1f MB/s\n", "scan + init + OrbitBatch::add", batchNs / 1e6, file.size / batchNs * 1e3);
+
+    file.close();
+    remove(path);
+    return 0;
+}
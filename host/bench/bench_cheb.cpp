@@ -0,0 +1,102 @@
+/*
+  bench_cheb.cpp - Chebyshev ephemeris cache fit error and per-tick cost vs. the direct propagation chain
+ */
+#include "bench.h"
+#include "cheb_cache.h"
+#include "sgp4.h"
+
+static int orbitSource(void* ctx, double unixSec, Vec3& posECI) {
+    Orbit* orb = (Orbit*)ctx;
+    orb->calcPosECI_UTC(UtcTime::fromUnixSeconds(unixSec), posECI);
+    return 0;
+}
+
+// Source that stops propagating partway through the window, like an element set that decays
+static double failAfterSec;
+static int failingSource(void* ctx, double unixSec, Vec3& posECI) {
+    if (unixSec > failAfterSec) return SGP4_ERR_DECAYED;
+    return orbitSource(ctx, unixSec, posECI);
+}
+
+int main() {
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(line1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(line2));
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+
+    const Vec3 llaRef = {42.36, -71.06, 0};
+    const uint64_t start_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+
+    static ChebCache cache;
+    cache.begin(orbitSource, &orb, llaRef, start_ms);
+
+    int nCalls = 0;
+    double fitNs = benchNs(1, [&](uint64_t) {
+        cache.begin(orbitSource, &orb, llaRef, start_ms);
+        nCalls = 0;
+        while (cache.fitNextSegment(start_ms)) nCalls++;
+    });
+
+    printf("Window: %d x %d s segments, degree %d, %u bytes\n",
+           CHEB_N_SEGMENTS, CHEB_SEGMENT_S, CHEB_DEGREE, unsigned(sizeof(cache.seg)));
+    for (int i = 0; i < CHEB_N_SEGMENTS; ++i)
+        printf("  segment %d: max fit error %8.3f m %s\n", i, cache.seg[i].maxErr, cache.seg[i].valid ? "" : "(rejected)");
+
+    // Independent error check on a dense 0.5 s grid: position and resulting look angles
+    double maxPosErr = 0, maxAngErr = 0;
+    const uint64_t span_ms = uint64_t(CHEB_N_SEGMENTS) * CHEB_SEGMENT_S * 1000;
+    for (uint64_t t = start_ms; t < start_ms + span_ms; t += 500) {
+        Vec3 fit;
+        if (!cache.eval(t, fit)) continue;
+        Vec3 ref;
+        directNED(orbitSource, &orb, cache.obs, double(t) / 1e3, ref);
+        maxPosErr = fmax(maxPosErr, norm(fit - ref));
+        Vec3 aerFit = ned2AzElRng(fit), aerRef = ned2AzElRng(ref);
+        if (aerRef.y > 0) {
+            double dAz = fabs(aerFit.x - aerRef.x);
+            dAz = fmin(dAz, 360 - dAz) * cos(aerRef.y * DEG_TO_RAD);
+            maxAngErr = fmax(maxAngErr, fmax(dAz, fabs(aerFit.y - aerRef.y)));
+        }
+    }
+    printf("Dense check: max |dNED| %.3f m, max look-angle error above horizon %.2e deg\n", maxPosErr, maxAngErr);
+
+    // A source error stops fitting at the failing segment and is reported, earlier segments stay usable
+    static ChebCache failCache;
+    failAfterSec = double(start_ms) / 1e3 + 2.5 * CHEB_SEGMENT_S;
+    failCache.begin(failingSource, &orb, llaRef, start_ms);
+    while (failCache.fitNextSegment(start_ms)) {}
+    int nFitted = failCache.nextSeg;
+    Vec3 ned;
+    bool failOk = nFitted == 2 && failCache.srcErr == SGP4_ERR_DECAYED && !failCache.fitNextSegment(start_ms)
+                  && failCache.eval(start_ms + uint64_t(CHEB_SEGMENT_S) * 1500, ned)
+                  && !failCache.eval(start_ms + uint64_t(CHEB_SEGMENT_S) * 2500, ned);
+    printf("Source error 2.5 segments in: %d segments fitted, srcErr %d %s\n\n",
+           nFitted, failCache.srcErr, failOk ? "" : "(FAIL)");
+
+    benchReportCycles("cache fit (whole window)", fitNs);
+    printf("  in %d calls of %d propagations\n", nCalls, CHEB_EVALS_PER_TICK);
+    benchReportCycles("cache fit (one call)", fitNs / nCalls);
+    benchReportCycles("direct NED + AzElRng", benchNs(200000, [&](uint64_t i) {
+        uint64_t t = start_ms + i * 500 % span_ms;
+        Vec3 ned;
+        directNED(orbitSource, &orb, cache.obs, double(t) / 1e3, ned);
+        Vec3 aer = ned2AzElRng(ned);
+        doNotOptimize(aer.y);
+    }));
+    benchReportCycles("cached NED + AzElRng", benchNs(200000, [&](uint64_t i) {
+        uint64_t t = start_ms + i * 500 % span_ms;
+        Vec3 ned;
+        cache.eval(t, ned);
+        Vec3 aer = ned2AzElRng(ned);
+        doNotOptimize(aer.y);
+    }));
+    benchReportCycles("cached NED only", benchNs(200000, [&](uint64_t i) {
+        uint64_t t = start_ms + i * 500 % span_ms;
+        Vec3 ned;
+        cache.eval(t, ned);
+        doNotOptimize(ned.x);
+    }));
+
+    return failOk ? 0 : 1;
+}
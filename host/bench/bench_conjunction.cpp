@@ -0,0 +1,110 @@
+/*
+  bench_conjunction.cpp - Hash-grid vs. all-pairs conjunction screening over growing LEO catalogs
+    The catalog is a crowded LEO shell plus a few planted pairs that share a node & reach it within seconds
+    of each other, so every size has some close approaches to find. Wherever the all-pairs reference runs,
+    the grid must report exactly the same conjunctions.
+ */
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "conjunction.h"
+
+#define PLANTED_PAIRS   16
+
+// Random near-circular orbits between ~400 and ~1100 km, with planted crossing pairs at the end
+static std::vector<Orbit> makeShell(size_t count, uint32_t seed) {
+    Orbit base{};
+    base.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<Orbit> cat(count, base);
+    for (Orbit& o : cat) {
+        o.incl  = u(rng) * PI;
+        o.Omega = u(rng) * TWO_PI;
+        o.omega = u(rng) * TWO_PI;
+        o.M0    = u(rng) * TWO_PI;
+        o.ecc   = u(rng) * 0.01;
+        o.n     = (14. + u(rng) * 1.8) * TWO_PI / SECONDS_PER_DAY;
+        o.a     = pow(MU_EARTH / (o.n*o.n), 1./3.);
+        o.epoch = base.epoch - int64_t(u(rng) * 3. * NS_PER_DAY);
+    }
+    // Same plane node & radius, different inclination, node reached up to ~2 s apart
+    for (size_t p = 0; p < PLANTED_PAIRS; ++p) {
+        Orbit& a = cat[count - 2*p - 1];
+        Orbit& b = cat[count - 2*p - 2];
+        a.ecc = b.ecc = 0;
+        a.omega = b.omega = 0;
+        b = a;
+        b.incl = fmod(a.incl + 0.3 + u(rng), PI);
+        b.M0 = a.M0 + (u(rng) - 0.5) * 4e-3;
+    }
+    return cat;
+}
+
+static bool sameConjunctions(const std::vector<Conjunction>& x, const std::vector<Conjunction>& y) {
+    if (x.size() != y.size()) return false;
+    for (size_t i = 0; i < x.size(); ++i)
+        if (x[i].a != y[i].a || x[i].b != y[i].b || x[i].tca.ns != y[i].tca.ns || x[i].miss != y[i].miss)
+            return false;
+    return true;
+}
+
+int main() {
+    Orbit base{};
+    base.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    // One ~100 min orbit at 30 s, 10 km threshold
+    ConjunctionQuery q = {base.epoch + 3600 * NS_PER_SEC, 30 * NS_PER_SEC, 200, 10e3};
+
+    printf("%-7s %12s %9s %13s %11s %8s %7s %12s %8s %s\n", "N", "grid ms/step", "growth", "tests/step",
+           "candidates", "refined", "found", "pairs ms/step", "speedup", "match");
+    int failures = 0;
+    double tPrev = 0, nPrev = 0;
+    for (uint32_t count : {1000u, 2000u, 5000u, 10000u, 20000u}) {
+        std::vector<Orbit> cat = makeShell(count, 1234);
+        ConjunctionScreen cs;
+        cs.begin(cat.data(), count);
+
+        std::vector<Conjunction> grid, ref;
+        double tGrid = benchNs(2, [&](uint64_t) { cs.screen(q, grid); }) / q.nSteps;
+        size_t nCand = cs.candidates.size();
+        uint64_t nTests = cs.nPairTests / q.nSteps, nRefined = cs.nRefined;
+
+        // Scaling exponent from the previous size: 1 is linear, 2 quadratic
+        char growth[16] = "-";
+        if (tPrev > 0) snprintf(growth, sizeof(growth), "N^%.2f", log(tGrid / tPrev) / log(count / nPrev));
+        tPrev = tGrid;
+        nPrev = count;
+
+        if (count <= 5000) {
+            double tPairs = benchNs(1, [&](uint64_t) { cs.screen(q, ref, CONJ_ALL_PAIRS); }) / q.nSteps;
+            bool match = sameConjunctions(grid, ref);
+            failures += !match;
+            printf("%-7u %12.3f %9s %13llu %11zu %8llu %7zu %12.3f %7.1fx %s\n", count, tGrid / 1e6, growth,
+                   (unsigned long long)nTests, nCand, (unsigned long long)nRefined, grid.size(), tPairs / 1e6,
+                   tPairs / tGrid, match ? "yes" : "NO");
+        } else {
+            printf("%-7u %12.3f %9s %13llu %11zu %8llu %7zu %12s %8s %s\n", count, tGrid / 1e6, growth,
+                   (unsigned long long)nTests, nCand, (unsigned long long)nRefined, grid.size(), "-", "-", "-");
+        }
+        // Planted pairs that meet their common node close enough in time must turn up
+        uint32_t planted = 0;
+        for (const Conjunction& c : grid)
+            planted += c.a >= count - 2*PLANTED_PAIRS && (count - c.a) % 2 == 0 && c.b == c.a + 1;
+        if (planted < PLANTED_PAIRS) {
+            printf("  only %u planted approaches found at N=%u\n", planted, count);
+            failures++;
+        }
+        if (count == 20000) {
+            printf("\nClosest at N=%u:\n", count);
+            std::sort(grid.begin(), grid.end(), [](const Conjunction& x, const Conjunction& y) { return x.miss < y.miss; });
+            for (size_t i = 0; i < grid.size() && i < 5; ++i)
+                printf("  %5u x %5u  TCA +%8.3f s  miss %8.1f m  %7.1f m/s\n", grid[i].a, grid[i].b,
+                       grid[i].tca.secondsSince(q.start), grid[i].miss, grid[i].relSpeed);
+        }
+    }
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+/*
+  bench_core.cpp - Per-call timings for the orbit & coordinate math core
+ */
+#include <string.h>
+#include "bench.h"
+#include "coord.h"
+#include "orbit_utils.h"
+
+int main() {
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(BENCH_TLE_LINE1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(BENCH_TLE_LINE2));
+
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+
+    const uint64_t N = 200000;
+    const Vec3 llaRef = {42.36, -71.06, 0};
+
+    benchReport("Orbit::initFromTLE", benchNs(N, [&](uint64_t) {
+        orb.initFromTLE(line1, line2);
+        doNotOptimize(orb.a);
+    }));
+
+    benchReport("Orbit::calcPosVelECI", benchNs(N, [&](uint64_t i) {
+        Vec3 pos, vel;
+        orb.calcPosVelECI(double(i % 5400), pos, vel);
+        doNotOptimize(pos.x);
+        doNotOptimize(vel.x);
+    }));
+
+    // Precompute a ring of ECEF positions so the coordinate benchmarks see varied inputs
+    const size_t nPts = 1024;
+    static Vec3 ecef[nPts];
+    for (size_t i = 0; i < nPts; ++i) {
+        Vec3 pos, vel;
+        orb.calcPosVelECI(double(i) * 5.0, pos, vel);
+        ecef[i] = eci2ecef(pos, (orb.epoch + int64_t(i) * 5 * NS_PER_SEC).era());
+    }
+
+    benchReport("eci2ecef", benchNs(N, [&](uint64_t i) {
+        Vec3 v = eci2ecef(ecef[i % nPts], double(i) * 1e-4);
+        doNotOptimize(v.x);
+    }));
+
+    benchReport("ecef2lla", benchNs(N, [&](uint64_t i) {
+        Vec3 v = ecef2lla(ecef[i % nPts], DEGREES);
+        doNotOptimize(v.x);
+    }));
+
+    benchReport("ecef2ned", benchNs(N, [&](uint64_t i) {
+        Vec3 v = ecef2ned(ecef[i % nPts], llaRef, DEGREES);
+        doNotOptimize(v.x);
+    }));
+
+    benchReport("ned2AzElRng", benchNs(N, [&](uint64_t i) {
+        Vec3 v = ned2AzElRng(ecef[i % nPts]);
+        doNotOptimize(v.x);
+    }));
+
+    return 0;
+}
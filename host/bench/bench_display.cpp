@@ -0,0 +1,160 @@
+/*
+  bench_display.cpp - I2C traffic & bus blocking time of the status screen, full refresh vs changed cells only
+    A day of once-per-second updates with the live Az/El from the pointing solver is rendered both ways.
+    A model SH1107 on the Wire stub applies every transfer, and its contents are checked against the
+    framebuffer after each update so a missed region shows up as a mismatch.
+ */
+#include "bench.h"
+#include "display_frame.h"
+#include "pointing.h"
+#include "defs.h"
+
+#define SIM_DAY_S       86400
+#define INVALIDATE_S    21600   // Something else draws over the screen this often (e.g. the WiFi message)
+
+// SH1107 side of the bus: page & column addressing with auto-incrementing data writes
+struct PanelModel {
+    uint8_t mem[OLED_PAGES * OLED_COLS];
+    uint8_t page, col;
+};
+
+static void panelSink(void* ctx, uint8_t addr, const uint8_t* data, uint32_t len) {
+    PanelModel& p = *(PanelModel*)ctx;
+    if (addr != OLED_ADDR || len == 0) return;
+    if (data[0] == 0x00) {
+        for (uint32_t i = 1; i < len; ++i) {
+            uint8_t b = data[i];
+            if ((b & 0xF0) == 0xB0) p.page = b & 0x0F;
+            else if ((b & 0xF0) == 0x10) p.col = (p.col & 0x0F) | ((b & 0x0F) << 4);
+            else if ((b & 0xF0) == 0x00) p.col = (p.col & 0xF0) | (b & 0x0F);
+        }
+    } else if (data[0] == 0x40) {
+        for (uint32_t i = 1; i < len; ++i) {
+            if (p.col < OLED_COLS) p.mem[p.page * OLED_COLS + p.col] = data[i];
+            p.col++;
+        }
+    }
+}
+
+// The original displayCurrTime(): clear, redraw everything, send the whole frame
+static void fullRefresh(Adafruit_SH1107& d, int hh, int mm, const char* wday, int mon, int dd, double az,
+                        double el) {
+    d.clearDisplay();
+    d.setTextColor(SH110X_WHITE);
+    d.setCursor(1, 2);
+    d.setTextSize(3);
+    d.printf("%02i:%02i", hh, mm);
+    d.writeFastHLine(0, 28, d.width(), SH110X_WHITE);
+    d.setTextSize(1);
+    d.setCursor(98, 2);
+    d.print(wday);
+    d.setCursor(98, 16);
+    d.printf("%02i/%02i", mon, dd);
+    d.setCursor(0, 32);
+    d.setTextSize(2);
+    d.printf("Az:%03.1f\nEl:%03.1f", az, el);
+    d.display();
+}
+
+struct Traffic {
+    double sumBytes, sumUs, maxUs;
+    uint32_t maxBytes, nIdle, n;
+
+    void add(uint32_t bytes, double us) {
+        sumBytes += bytes;
+        sumUs += us;
+        if (bytes > maxBytes) maxBytes = bytes;
+        if (us > maxUs) maxUs = us;
+        nIdle += bytes == 0;
+        n++;
+    }
+    void print(const char* name) const {
+        printf("%-16s %10.1f %10u %10.3f %10.3f %9.1f%%\n", name, sumBytes / n, maxBytes, sumUs / n / 1e3,
+               maxUs / 1e3, 100.0 * nIdle / n);
+    }
+};
+
+int main() {
+    static const char* wdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+
+    OrbitModel orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    PointingSolver pointing;
+    pointing.begin(Vec3{42.36, -71.06, 0}, orb);
+    pointing.orbitUpdated();
+
+    TwoWire wireOld = {}, wireNew = {};
+    PanelModel panelOld = {}, panelNew = {};
+    wireOld.sink = panelSink;
+    wireOld.sinkCtx = &panelOld;
+    wireNew.sink = panelSink;
+    wireNew.sinkCtx = &panelNew;
+
+    Adafruit_SH1107 dispOld(64, 128, &wireOld), dispNew(64, 128, &wireNew);
+    dispOld.begin(OLED_ADDR, true);
+    dispNew.begin(OLED_ADDR, true);
+    dispOld.setRotation(1);
+    dispNew.setRotation(1);
+    StatusScreen screen;
+    screen.begin();
+
+    Traffic before = {}, after = {};
+    int failures = 0;
+    uint32_t mismatches = 0, pixelDiffs = 0;
+    uint64_t start_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+    for (uint32_t s = 0; s < SIM_DAY_S; s += DISPLAY_TASK_MS / 1000) {
+        uint64_t UTC_ms = start_ms + uint64_t(s) * 1000;
+        pointing.fitEphem(UTC_ms);
+        pointing.solve(UTC_ms);
+        uint32_t sec = uint32_t(UTC_ms / 1000);
+        int hh = sec / 3600 % 24, mm = sec / 60 % 60;
+        const char* wday = wdays[(sec / 86400 + 4) % 7];
+        int mon = 3, dd = 7 + int(s / 86400);
+
+        if (s % INVALIDATE_S == INVALIDATE_S / 2) {
+            dispNew.clearDisplay();
+            dispNew.display();
+            screen.invalidate();
+        }
+
+        uint32_t bytes0 = wireOld.nBytes;
+        double us0 = wireOld.busUs;
+        fullRefresh(dispOld, hh, mm, wday, mon, dd, pointing.aer.x, pointing.aer.y);
+        before.add(wireOld.nBytes - bytes0, wireOld.busUs - us0);
+
+        bytes0 = wireNew.nBytes;
+        us0 = wireNew.busUs;
+        screen.update(dispNew, wireNew, hh, mm, wday, mon, dd, pointing.aer.x, pointing.aer.y);
+        after.add(wireNew.nBytes - bytes0, wireNew.busUs - us0);
+
+        // Panel must show the framebuffer, and the framebuffer must match the original rendering
+        mismatches += memcmp(panelNew.mem, dispNew.getBuffer(), sizeof(panelNew.mem)) != 0;
+        pixelDiffs += memcmp(dispOld.getBuffer(), dispNew.getBuffer(), sizeof(panelNew.mem)) != 0;
+    }
+
+    printf("%u updates at %u ms over one day, I2C at %u kHz during transfers\n\n", before.n, DISPLAY_TASK_MS,
+           OLED_CLK_DURING / 1000);
+    printf("%-16s %10s %10s %10s %10s %10s\n", "refresh", "bytes avg", "bytes max", "block ms", "max ms", "no xfer");
+    before.print("full frame");
+    after.print("changed cells");
+    printf("\nPanel out of sync with framebuffer: %u updates, frame differs from full redraw: %u updates\n",
+           mismatches, pixelDiffs);
+
+    failures += mismatches != 0;
+    failures += pixelDiffs != 0;
+    failures += after.sumBytes >= before.sumBytes / 4;
+    failures += after.nIdle == 0;
+
+    // An unchanged frame must not touch the bus
+    uint32_t bytes0 = wireNew.nBytes;
+    const TextField& t = screen.time;
+    int sent = screen.update(dispNew, wireNew, atoi(t.text), atoi(t.text + 3), screen.wday.text,
+                             atoi(screen.date.text), atoi(screen.date.text + 3), atof(screen.az.text + 3),
+                             atof(screen.el.text + 3));
+    bool quiet = sent == 0 && wireNew.nBytes == bytes0;
+    failures += !quiet;
+    printf("Repeat of the last frame: %s\n", quiet ? "nothing sent" : "SENT DATA");
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
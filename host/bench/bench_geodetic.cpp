@@ -0,0 +1,82 @@
+/*
+  bench_geodetic.cpp - Accuracy & timing of ecef2lla against the previous float fixed-point iteration
+ */
+#include "bench.h"
+#include "coord.h"
+
+// Previous ecef2lla, kept verbatim (float state, 1e-10 tolerance, 1000 iteration cap) for comparison
+static Vec3 ecef2llaLegacy(const Vec3& ecef)
+{
+    const float a = 6378137.0, f = 1.0 / 298.257223563;
+    const float ecc_sqrd = pow(8.1819190842622e-2f, 2);
+    float x = ecef.x, y = ecef.y, z = ecef.z;
+    float x_sqrd = pow(x, 2), y_sqrd = pow(y, 2);
+    float lon = atan2(y, x);
+    float lat = 400;
+    float s = sqrt(x_sqrd + y_sqrd);
+    float beta = atan2(z, (1 - f) * s);
+    float mu_bar = atan2(z + (((ecc_sqrd * (1 - f)) / (1 - ecc_sqrd)) * a * pow(sin(beta), 3)),
+                        s - (ecc_sqrd * a * pow(cos(beta), 3)));
+    size_t iter = 0;
+    while (abs(lat - mu_bar) > 1e-10)
+    {
+        lat  = mu_bar;
+        beta = atan2((1 - f) * sin(lat), cos(lat));
+        mu_bar = atan2(z + (((ecc_sqrd * (1 - f)) / (1 - ecc_sqrd)) * a * pow(sin(beta), 3)),
+                      s - (ecc_sqrd * a * pow(cos(beta), 3)));
+        iter++;
+        if (iter > 1e3) break;
+    }
+    lat = mu_bar;
+    float N = a / sqrt(1 - (ecc_sqrd * pow(sin(lat), 2)));
+    float h = (s * cos(lat)) + ((z + (ecc_sqrd * N * sin(lat))) * sin(lat)) - N;
+    return Vec3{lat * RAD_TO_DEG, lon * RAD_TO_DEG, h};
+}
+
+// Exact double-precision forward transform used as ground truth
+static Vec3 llaToEcefExact(double latDeg, double lonDeg, double h) {
+    double lat = latDeg * DEG_TO_RAD, lon = lonDeg * DEG_TO_RAD;
+    double N = a / sqrt(1 - ecc_sqrd * sin(lat) * sin(lat));
+    return Vec3{(N + h) * cos(lat) * cos(lon), (N + h) * cos(lat) * sin(lon), (N * (1 - ecc_sqrd) + h) * sin(lat)};
+}
+
+struct ErrStats { double lat_m, h_m; };
+
+int main() {
+    const double alts[] = {-1000, 0, 10e3, 420e3, 2000e3, 20200e3, 35786e3};
+    const int nLat = 3601;
+
+    static Vec3 pts[sizeof(alts)/sizeof(alts[0]) * nLat];
+    size_t nPts = 0;
+
+    printf("%-12s %16s %16s %16s %16s\n", "alt [km]", "new lat err [m]", "new h err [m]", "old lat err [m]", "old h err [m]");
+    for (double h : alts) {
+        ErrStats eNew = {0, 0}, eOld = {0, 0};
+        for (int i = 0; i < nLat; ++i) {
+            double lat = -90.0 + 180.0 * i / (nLat - 1);
+            double lon = fmod(i * 7.3, 360.0) - 180.0;
+            Vec3 ecef = llaToEcefExact(lat, lon, h);
+            pts[nPts++] = ecef;
+
+            Vec3 lNew = ecef2lla(ecef, DEGREES);
+            Vec3 lOld = ecef2llaLegacy(ecef);
+            eNew.lat_m = fmax(eNew.lat_m, fabs(lNew.x - lat) * DEG_TO_RAD * a);
+            eNew.h_m   = fmax(eNew.h_m,   fabs(lNew.z - h));
+            eOld.lat_m = fmax(eOld.lat_m, fabs(lOld.x - lat) * DEG_TO_RAD * a);
+            eOld.h_m   = fmax(eOld.h_m,   fabs(lOld.z - h));
+        }
+        printf("%-12.0f %16.3e %16.3e %16.3e %16.3e\n", h / 1e3, eNew.lat_m, eNew.h_m, eOld.lat_m, eOld.h_m);
+    }
+    printf("\n");
+
+    benchReport("ecef2lla (closed form)", benchNs(400000, [&](uint64_t i) {
+        Vec3 v = ecef2lla(pts[i % nPts], DEGREES);
+        doNotOptimize(v.x);
+    }));
+    benchReport("ecef2lla (legacy iterative)", benchNs(100000, [&](uint64_t i) {
+        Vec3 v = ecef2llaLegacy(pts[i % nPts]);
+        doNotOptimize(v.x);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+  bench_ground_track.cpp - Ground-track cost & map frame render time on the SH1107 framebuffer stub
+    The batch is checked point by point against the direct chain with an exact ERA per point, and the
+    interpolated position against a fresh propagation at every frame. The host point cost is paired with an
+    M0 estimate from op_count.h, which is what sizes GT_POINTS_PER_TICK. A day of 1 Hz frames runs through
+    MapScreen. Every so often its framebuffer must equal a from-scratch render of the same state, which
+    catches a marker that was not cleanly erased. A TLE change part way through must force a new track, and
+    the old one must stay on the map while the new one is built.
+ */
+#include "bench.h"
+#include "map_screen.h"
+#include "op_count.h"
+
+#define SIM_DAY_S       86400
+#define CHECK_EVERY_S   97      // Frames compared against a from-scratch render
+#define M0_HZ           48e6
+#define BUILD_TICKS     ((GT_POINTS + GT_POINTS_PER_TICK - 1) / GT_POINTS_PER_TICK)
+
+int main() {
+    int failures = 0;
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    const Vec3 site = {42.36, -71.06, 0};
+    UtcTime t0 = orb.epoch + 3600 * NS_PER_SEC;
+
+    // Batch vs. the per-point chain
+    GroundTrack gt;
+    gt.begin();
+    gt.compute(orb, t0);
+    double maxErr = 0;
+    for (uint16_t k = 0; k < GT_POINTS; ++k) {
+        UtcTime t = gt.start + int64_t(k) * gt.step_ns;
+        Vec3 posECI;
+        orb.calcPosECI_UTC(t, posECI);
+        Vec3 lla = ecef2lla(eci2ecef(posECI, -t.era()), DEGREES);
+        double dLon = fabs(lla.y - gt.lon[k]);
+        maxErr = fmax(maxErr, fmax(fabs(lla.x - gt.lat[k]), fmin(dLon, 360 - dLon)));
+    }
+    printf("%d points, %.1f s apart, max error vs. per-point chain %.2e deg\n", GT_POINTS, gt.step_ns / 1e9, maxErr);
+    failures += maxErr > 1e-4;
+
+    double tBatch = benchNs(2000, [&](uint64_t i) {
+        gt.compute(orb, t0 + int64_t(i));
+        doNotOptimize(gt.lat[GT_POINTS - 1]);
+    });
+    benchReport("track batch", tBatch);
+    benchReport("  per point", tBatch / GT_POINTS);
+
+    // The same point chain in soft-float double, priced for the M0
+    OrbitT<Counted<double>> corb;
+    corb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    uint32_t ops[OP_N];
+    double pointCycles = countOps(COST_DOUBLE, ops, [&] {
+        Vec3T<Counted<double>> posECI;
+        corb.calcPosECI_UTC(t0, posECI);
+        ecef2lla(eci2ecef(posECI, Counted<double>(-t0.era())), DEGREES);
+    });
+    double pointMs = pointCycles / M0_HZ * 1e3;
+    printf("M0 estimate: %.0f cycles per point, %.1f ms at 48 MHz; %.1f ms per display tick (%d points), "
+           "%.0f ms for the whole track in one call\n", pointCycles, pointMs, pointMs * GT_POINTS_PER_TICK,
+           GT_POINTS_PER_TICK, pointMs * GT_POINTS);
+
+    // Framebuffer stub as the firmware sets it up
+    TwoWire wire = {}, wireRef = {};
+    Adafruit_SH1107 disp(64, 128, &wire), ref(64, 128, &wireRef);
+    disp.setRotation(1);
+    ref.setRotation(1);
+    MapScreen map;
+    map.begin(site);
+
+    // A day of frames at 1 Hz, with new elements (same orbit, later epoch) at noon
+    Orbit next = orb;
+    next.epoch = orb.epoch + 12 * 3600 * NS_PER_SEC;
+    next.M0 = fmod(orb.M0 + orb.n * 12 * 3600, TWO_PI);
+    OrbitModel* cur = &orb;
+    double maxInterp = 0, frameNs = 0, frameMaxNs = 0;
+    uint32_t nFrames = 0, nIdle = 0, nChecks = 0, mismatches = 0, tracksAtTle = 0;
+    bool oldKept = true, newBuilt = false;
+    uint64_t bytes = 0;
+    for (uint32_t s = 0; s < SIM_DAY_S; ++s) {
+        UtcTime t = t0 + int64_t(s) * NS_PER_SEC;
+        if (s == SIM_DAY_S / 2) {
+            cur = &next;
+            tracksAtTle = map.track.nComputed;
+        }
+        uint32_t bytes0 = wire.nBytes;
+        auto c0 = std::chrono::steady_clock::now();
+        map.update(disp, wire, *cur, t);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - c0).count();
+        frameNs += ns;
+        frameMaxNs = fmax(frameMaxNs, ns);
+        nFrames++;
+        nIdle += wire.nBytes == bytes0;
+        bytes += wire.nBytes - bytes0;
+        if (s >= SIM_DAY_S / 2 && s < SIM_DAY_S / 2 + BUILD_TICKS - 1)
+            oldKept = oldKept && map.track.valid && map.track.epoch.ns == orb.epoch.ns;
+        if (s == SIM_DAY_S / 2 + BUILD_TICKS - 1)
+            newBuilt = map.track.epoch.ns == next.epoch.ns && map.track.nComputed == tracksAtTle + 1;
+
+        float lat, lon;
+        if (map.track.subPoint(t, lat, lon)) {
+            Vec3 posECI;
+            cur->calcPosECI_UTC(t, posECI);
+            Vec3 lla = ecef2lla(eci2ecef(posECI, -t.era()), DEGREES);
+            double dLon = fabs(lla.y - lon);
+            maxInterp = fmax(maxInterp, fmax(fabs(lla.x - lat), fmin(dLon, 360 - dLon)));
+        }
+
+        if (s % CHECK_EVERY_S == 0) {
+            ref.clearDisplay();
+            map.drawBase(ref);
+            if (map.markX >= 0)
+                ref.fillRect(map.markX - MAP_MARK_R, map.markY - MAP_MARK_R, 2*MAP_MARK_R + 1, 2*MAP_MARK_R + 1,
+                             SH110X_INVERSE);
+            mismatches += memcmp(ref.getBuffer(), disp.getBuffer(), MAP_W * MAP_H / 8) != 0;
+            nChecks++;
+        }
+    }
+
+    // Map redraw after a new track, on its own
+    benchReport("full base redraw", benchNs(2000, [&](uint64_t) {
+        ref.clearDisplay();
+        map.drawBase(ref);
+        doNotOptimize(ref.getBuffer()[0]);
+    }));
+
+    // What sending the whole frame every second would cost
+    uint32_t fullBytes0 = wireRef.nBytes;
+    ref.display();
+    uint32_t fullBytes = wireRef.nBytes - fullBytes0;
+
+    double periodMin = orbitPeriodSec(orb) / 60;
+    printf("\n%u frames: %u tracks computed (orbit %.1f min), %u map redraws\n", nFrames, map.track.nComputed,
+           periodMin, map.nRedraws);
+    printf("frame render + flush: avg %.0f ns, max %.1f us\n", frameNs / nFrames, frameMaxNs / 1e3);
+    printf("I2C: avg %.1f bytes/frame vs. %u for a full frame, %.1f%% of frames send nothing\n",
+           double(bytes) / nFrames, fullBytes, 100.0 * nIdle / nFrames);
+    printf("interpolated position vs. propagation: max %.3f deg (%.2f px)\n", maxInterp,
+           maxInterp * MAP_W / 360);
+    printf("framebuffer vs. from-scratch render: %u of %u checks differ\n", mismatches, nChecks);
+    printf("new elements: %s, %s after %d frames\n", oldKept ? "old track kept" : "OLD TRACK DROPPED",
+           newBuilt ? "new track" : "NO NEW TRACK", BUILD_TICKS);
+
+    // Track refreshes every GT_REFRESH_ORBITS, plus one for the new elements. The first frame draws the map
+    // before any track exists
+    uint32_t expected = uint32_t(SIM_DAY_S / (orbitPeriodSec(orb) * GT_REFRESH_ORBITS)) + 2;
+    failures += map.track.nComputed > expected + 1 || map.track.nComputed + 2 < expected;
+    failures += map.nRedraws != map.track.nComputed + 1;
+    failures += mismatches != 0;
+    failures += !oldKept || !newBuilt;
+    failures += maxInterp * MAP_W / 360 > 0.5;
+    failures += bytes >= uint64_t(fullBytes) * nFrames / 20;
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
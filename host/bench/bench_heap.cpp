@@ -0,0 +1,253 @@
+/*
+  bench_heap.cpp - Zero-heap check of the firmware's steady state & static RAM per subsystem
+    The firmware task set runs for a simulated day on the virtual clock: NTP exchanges and hourly TLE responses
+    through the sketch's NetLink sequencing and stream parser, ephemeris fits, pointing, the pedestal, and both
+    display screens. The sketch itself needs WiFiNINA, so its orbit, ephemeris & display task bodies are
+    re-created here around the same library calls, and the network hooks answer from stand-in servers.
+    malloc & friends are interposed here and report to heapNote() the way newlib's lock hook does on target,
+    so any allocation after heapLock() fails the run. The RAM table is sizeof() of each subsystem's static
+    state in this host build: pointers are 8 bytes here & 4 on the M0, everything else lays out the same.
+    flash_budget.txt ranks subsystems by flash from this host binary's link map, not the M0 image (see README).
+ */
+#include "bench.h"
+#include "heap_guard.h"
+#include "http_tle_stream.h"
+#include "map_screen.h"
+#include "net_link.h"
+#include "ntp_clock.h"
+#include "orbit_snapshot.h"
+#include "pedestal.h"
+#include "pointing.h"
+#include "scheduler.h"
+
+#define SIM_DAY_S       86400
+#define IDLE_STEP_US    5000    // Virtual time per scheduler pass
+#define NTP_RTT_MS      30
+#define COST_SPI_US     300     // One poll of the WiFi co-processor
+
+// Every allocator entry point reports before forwarding to glibc
+static uint32_t nBeforeLock;
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+static void noteAlloc() {
+    if (heapGuard.locked) heapNote();
+    else nBeforeLock++;
+}
+extern "C" void* malloc(size_t n) { noteAlloc(); return __libc_malloc(n); }
+extern "C" void* calloc(size_t n, size_t size) { noteAlloc(); return __libc_calloc(n, size); }
+extern "C" void* realloc(void* p, size_t n) { noteAlloc(); return __libc_realloc(p, n); }
+extern "C" void free(void* p) { if (p) noteAlloc(); __libc_free(p); }
+
+// Firmware state, as the sketch declares it
+static OrbitModel orb;
+static PointingSolver pointing;
+static Pedestal ped;
+static NtpClock ntp;
+static uint8_t ntpPacket[NTP_PACKET_SIZE];
+static HttpTleStream stream;
+static char tleLine1[TLE_LEN], tleLine2[TLE_LEN];
+static bool tleFound;
+static OrbitSnapshot snapshot;
+static TwoWire wire;
+static Adafruit_SH1107 display(64, 128, &wire);
+static StatusScreen statusScreen;
+static MapScreen mapScreen;
+static Scheduler sched;
+static NetLink net;
+static bool orbitReady;
+
+static const int64_t trueStartUs = int64_t(BENCH_TLE_EPOCH_UNIX) * 1000000 + 7200 * 1000000LL;
+static uint32_t ntpSentMs;
+static uint32_t nNtp, nTle, nFrames;
+
+static uint32_t schedMillis() { return millis(); }
+static uint32_t schedMicros() { return micros(); }
+static uint64_t currUTCms() { return ntp.utcMs(millis()); }
+
+// Stand-in server: true time is the virtual clock from the start instant
+static void ntpReply(uint8_t* pkt) {
+    uint8_t req[8];
+    memcpy(req, pkt + 40, 8);
+    int64_t t = trueStartUs + int64_t(hostClockUs) - NTP_RTT_MS * 500;
+    memset(pkt, 0, NTP_PACKET_SIZE);
+    pkt[0] = 0b00100100;
+    pkt[1] = 2;
+    memcpy(pkt + 24, req, 8);
+    unixUsToNtp(t, pkt + 32);
+    unixUsToNtp(t + 100, pkt + 40);
+}
+
+static void onTleRecord(void*, const TleRecord& rec) {
+    size_t nameLen = strlen(HEADER_STR);
+    if (tleFound || !rec.name || rec.nameLen < nameLen || memcmp(rec.name, HEADER_STR, nameLen) != 0) return;
+    memcpy(tleLine1, rec.line1, TLE_LEN);
+    memcpy(tleLine2, rec.line2, TLE_LEN);
+    tleFound = true;
+}
+
+// Network hooks: the AP is always up, NTP answers after NTP_RTT_MS, and Celestrak's reply arrives whole
+static bool netWifiBegin(void*) { return true; }
+static bool netWifiConnected(void*) { return true; }
+
+static void netNtpSend(void*) {
+    ntp.buildRequest(ntpPacket, millis());
+    ntpSentMs = millis();
+}
+
+static bool netNtpReceive(void*) {
+    delayMicroseconds(COST_SPI_US);
+    if (!ntp.pending || millis() - ntpSentMs < NTP_RTT_MS) return false;
+    ntpReply(ntpPacket);
+    if (ntp.processReply(ntpPacket, NTP_PACKET_SIZE, millis()) == NTP_INVALID) return false;
+    nNtp++;
+    return true;
+}
+
+static void netTleSend(void*) {
+    tleFound = false;
+    stream.begin(onTleRecord, NULL);
+}
+
+// Celestrak's reply, fed in RCV_CHUNK pieces as the sketch's rcvData() reads them
+static bool netTleReceive(void*) {
+    static char resp[512];
+    static int respLen = -1;
+    if (respLen < 0) {
+        char body[256];
+        int n = snprintf(body, sizeof(body), "%s\r\n%s\r\n%s\r\n", HEADER_STR, BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+        respLen = snprintf(resp, sizeof(resp), "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+                           "Content-Length: %d\r\n\r\n%s", n, body);
+    }
+    for (int i = 0; i < respLen && !stream.done() && !stream.failed(); i += RCV_CHUNK) {
+        uint8_t chunk[RCV_CHUNK];
+        int n = respLen - i < RCV_CHUNK ? respLen - i : RCV_CHUNK;
+        memcpy(chunk, resp + i, n);
+        stream.feed((const char*)chunk, n);
+    }
+    if (!stream.done()) stream.finish();
+    return true;
+}
+
+static bool netTleApply(void*) {
+    if (!tleFound) return false;
+    orb.initFromTLE(tleLine1, tleLine2);
+    pointing.orbitUpdated();
+    orbitReady = true;
+    // The target writes flash; the host stand-in goes through stdio, so only the record is built here
+    snapshot.fill(tleLine1, tleLine2, uint32_t(currUTCms() / 1000));
+    nTle++;
+    return true;
+}
+
+static void stepperIdle(void*) {
+    ped.runStepper();
+    hostClockUs += IDLE_STEP_US;
+}
+
+static void wifiTask(void*) { net.wifiTask(); }
+static void ntpTask(void*) { net.ntpTask(); }
+static void tleTask(void*) { net.tleTask(); }
+
+static void orbitTask(void*) {
+    if (!orbitReady || !ntp.synced) return;
+    pointing.solve(currUTCms());
+    ped.point(pointing.aer, pointing.rates);
+}
+
+static void ephemTask(void*) {
+    if (!orbitReady || !ntp.synced) return;
+    pointing.fitEphem(currUTCms());
+}
+
+// The two screens take turns a minute each, so both see their invalidate & redraw paths
+static void displayTask(void*) {
+    uint64_t utc = currUTCms();
+    uint32_t sec = uint32_t(utc / 1000);
+    if (sec / 60 % 2 && orbitReady) {
+        if (statusScreen.valid) {
+            statusScreen.invalidate();
+            display.clearDisplay();
+        }
+        mapScreen.update(display, wire, orb, UtcTime::fromUnixMs(utc));
+    } else {
+        if (mapScreen.valid) {
+            mapScreen.invalidate();
+            display.clearDisplay();
+        }
+        statusScreen.update(display, wire, sec / 3600 % 24, sec / 60 % 60, "Tue", 3, 7, pointing.aer.x,
+                            pointing.aer.y);
+    }
+    nFrames++;
+}
+
+int main() {
+    int failures = 0;
+
+    // setup(): everything here may allocate
+    const Vec3 site = {42.36, -71.06, 0};
+    display.begin(OLED_ADDR, true);
+    display.setRotation(1);
+    statusScreen.begin();
+    mapScreen.begin(site);
+    ped.begin();
+    ped.stepper.setCurrentPosition(0);
+    pointing.begin(site, orb);
+    ntp.begin();
+    NetHooks hooks = {NULL, netWifiBegin, netWifiConnected, netNtpSend, netNtpReceive, netTleSend, netTleReceive,
+                      netTleApply};
+    net.begin(hooks, ntp);
+    net.associate(false);
+    net.waitForNtp(false);
+
+    sched.begin(schedMillis, schedMicros, stepperIdle, NULL);
+    sched.add("wifi",    wifiTask,    NULL, WIFI_TASK_MS);
+    sched.add("ntp",     ntpTask,     NULL, NET_POLL_MS);
+    sched.add("tle",     tleTask,     NULL, NET_POLL_MS);
+    sched.add("orbit",   orbitTask,   NULL, ORBIT_REFRESH_DELAY_MS, ORBIT_REFRESH_DELAY_MS/2);
+    sched.add("ephem",   ephemTask,   NULL, EPHEM_TASK_MS);
+    sched.add("display", displayTask, NULL, DISPLAY_TASK_MS);
+    heapLock();
+    uint32_t setupCalls = nBeforeLock;
+
+    // loop()
+    uint64_t startUs = hostClockUs;
+    while (hostClockUs - startUs < uint64_t(SIM_DAY_S) * 1000000) sched.runOnce();
+    heapGuard.locked = false;
+
+    printf("setup: %u allocator calls (library & host runtime)\n", setupCalls);
+    printf("simulated day: %u NTP replies, %u TLE updates, %u frames, %u map redraws\n", nNtp, nTle, nFrames,
+           mapScreen.nRedraws);
+    printf("allocator calls after heapLock(): %u%s\n", heapGuard.nCalls, heapGuard.nCalls ? "  <-- HEAP USED" : "");
+    failures += heapGuard.nCalls != 0;
+    failures += nTle < SIM_DAY_S / (TLE_REFRESH_DELAY_MIN * 60) - 1 || nNtp < 10 || mapScreen.nRedraws < 100;
+
+    // Static RAM by subsystem
+    struct Row { const char* name; size_t bytes; } rows[] = {
+        {"orbit model",         sizeof(orb)},
+        {"pointing & ephem",    sizeof(pointing)},
+        {"  of which cache",    sizeof(pointing.ephem)},
+        {"pedestal",            sizeof(ped)},
+        {"ntp clock + packet",  sizeof(ntp) + sizeof(ntpPacket)},
+        {"net link",            sizeof(net)},
+        {"tle stream + lines",  sizeof(stream) + sizeof(tleLine1) + sizeof(tleLine2)},
+        {"orbit snapshot",      sizeof(snapshot)},
+        {"framebuffer",         size_t(MAP_W * MAP_H / 8)},
+        {"status screen",       sizeof(statusScreen)},
+        {"map screen",          sizeof(mapScreen)},
+        {"  of which track",    sizeof(mapScreen.track)},
+        {"scheduler",           sizeof(sched)},
+        {"heap guard",          sizeof(heapGuard)},
+    };
+    size_t total = 0;
+    printf("\n%-22s %8s\n", "static RAM", "bytes");
+    for (const Row& r : rows) {
+        printf("%-22s %8zu\n", r.name, r.bytes);
+        if (r.name[0] != ' ') total += r.bytes;
+    }
+    printf("%-22s %8zu  of 32768 on the SAMD21\n", "total", total);
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
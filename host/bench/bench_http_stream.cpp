@@ -0,0 +1,212 @@
+/*
+  bench_http_stream.cpp - Streaming HTTP/TLE parser against a loopback stand-in for Celestrak
+    A local server thread replays canned catalog responses (Content-Length, chunked and close-delimited)
+    in TCP writes of various sizes; the client feeds whatever each recv() returns straight into the parser.
+ */
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench.h"
+#include "http_tle_stream.h"
+
+#define CATALOG_COUNT   400
+#define CATALOG_BAD_NTH 97      // Every Nth record gets a corrupted checksum
+#define ISS_INDEX       251     // Position of the "ISS (ZARYA)" record in the catalog
+#define HTTP_CHUNK_LEN  500     // Transfer-encoding chunk size used by the stand-in server
+
+enum BodyMode { BODY_LENGTH, BODY_CHUNKED, BODY_CLOSE };
+static const char* modeNames[] = {"content-length", "chunked", "close-delimited"};
+
+// Build a 3LE catalog from the sample TLE with unique catalog numbers
+static std::string makeCatalog(int count, int everyNthBad) {
+    std::string out;
+    for (int i = 0; i < count; ++i) {
+        char l1[TLE_LEN + 1], l2[TLE_LEN + 1], name[32];
+        memcpy(l1, BENCH_TLE_LINE1, sizeof(l1));
+        memcpy(l2, BENCH_TLE_LINE2, sizeof(l2));
+        if (i != ISS_INDEX) {
+            char cat[6];
+            snprintf(cat, sizeof(cat), "%05d", 30000 + i);
+            memcpy(l1 + 2, cat, 5);
+            memcpy(l2 + 2, cat, 5);
+            benchFixChecksum(l1);
+            benchFixChecksum(l2);
+            if (i % everyNthBad == everyNthBad - 1) l2[TLE_LEN - 1] = l2[TLE_LEN - 1] == '0' ? '1' : '0';
+            snprintf(name, sizeof(name), "SAT-%05d", 30000 + i);
+        } else {
+            snprintf(name, sizeof(name), "ISS (ZARYA)");
+        }
+        char rec[3 * 80];
+        snprintf(rec, sizeof(rec), "%-24s\r\n%s\r\n%s\r\n", name, l1, l2);
+        out += rec;
+    }
+    return out;
+}
+
+// Wrap a body into a full HTTP response
+static std::string makeResponse(const std::string& body, BodyMode mode, int status = 200) {
+    char head[160];
+    std::string out;
+    snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nServer: stand-in\r\nContent-Type: text/plain; charset=utf-8\r\n",
+             status, status == 200 ? "OK" : "Not Found");
+    out += head;
+    if (mode == BODY_LENGTH) {
+        snprintf(head, sizeof(head), "Content-Length: %zu\r\n\r\n", body.size());
+        out += head;
+        out += body;
+    } else if (mode == BODY_CHUNKED) {
+        out += "Transfer-Encoding: chunked\r\n\r\n";
+        for (size_t i = 0; i < body.size(); i += HTTP_CHUNK_LEN) {
+            size_t n = body.size() - i < HTTP_CHUNK_LEN ? body.size() - i : HTTP_CHUNK_LEN;
+            // Exercise chunk extensions on one chunk
+            snprintf(head, sizeof(head), i == HTTP_CHUNK_LEN ? "%zX;name=value\r\n" : "%zx\r\n", n);
+            out += head;
+            out.append(body, i, n);
+            out += "\r\n";
+        }
+        out += "0\r\nX-Trailer: done\r\n\r\n";
+    } else {
+        out += "Connection: close\r\n\r\n";
+        out += body;
+    }
+    return out;
+}
+
+// Receiver state mirroring TleQueryHandler
+struct Receiver {
+    HttpTleStream stream;
+    bool found;
+    char line1[TLE_LEN];
+    char line2[TLE_LEN];
+};
+
+static void onRecord(void* ctx, const TleRecord& rec) {
+    Receiver* rx = (Receiver*)ctx;
+    if (rec.name && rec.nameLen >= 11 && memcmp(rec.name, "ISS (ZARYA)", 11) == 0) {
+        memcpy(rx->line1, rec.line1, TLE_LEN);
+        memcpy(rx->line2, rec.line2, TLE_LEN);
+        rx->found = true;
+    }
+}
+
+// Serve one response over loopback in writes of `writeSize` bytes and parse it on the client side
+static bool serveAndParse(const std::string& response, size_t writeSize, Receiver& rx) {
+    int lsock = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (lsock < 0 || bind(lsock, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(lsock, 1) != 0 ||
+        getsockname(lsock, (sockaddr*)&addr, &addrLen) != 0) {
+        perror("loopback server");
+        return false;
+    }
+
+    std::thread server([&]() {
+        int conn = accept(lsock, NULL, NULL);
+        if (conn < 0) return;
+        int one = 1;
+        setsockopt(conn, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        for (size_t i = 0; i < response.size(); i += writeSize) {
+            size_t n = response.size() - i < writeSize ? response.size() - i : writeSize;
+            if (send(conn, response.data() + i, n, 0) < 0) break;
+        }
+        close(conn);
+    });
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = connect(sock, (sockaddr*)&addr, sizeof(addr)) == 0;
+
+    rx.found = false;
+    rx.stream.begin(onRecord, &rx);
+    char chunk[RCV_CHUNK];
+    while (ok && !rx.stream.done() && !rx.stream.failed()) {
+        ssize_t n = recv(sock, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            rx.stream.finish();
+            break;
+        }
+        rx.stream.feed(chunk, size_t(n));
+    }
+
+    close(sock);
+    server.join();
+    close(lsock);
+    return ok && rx.stream.done();
+}
+
+int main() {
+    std::string body = makeCatalog(CATALOG_COUNT, CATALOG_BAD_NTH);
+    int expectBad = CATALOG_COUNT / CATALOG_BAD_NTH;
+    int expectGood = CATALOG_COUNT - expectBad;
+    const size_t writeSizes[] = {1, 7, 64, 536, 1460, 65536};
+
+    printf("Catalog: %zu bytes, %d records (%d corrupted), parser state %zu bytes\n\n",
+           body.size(), CATALOG_COUNT, expectBad, sizeof(HttpTleStream));
+    printf("%-16s %8s %8s %6s %5s %10s\n", "encoding", "write", "records", "bad", "ISS", "time ms");
+
+    int failures = 0;
+    Receiver rx;
+    for (int mode = BODY_LENGTH; mode <= BODY_CLOSE; ++mode) {
+        std::string response = makeResponse(body, BodyMode(mode));
+        for (size_t w : writeSizes) {
+            auto t0 = std::chrono::steady_clock::now();
+            bool ok = serveAndParse(response, w, rx);
+            auto t1 = std::chrono::steady_clock::now();
+            ok = ok && rx.found && int(rx.stream.nRecords) == expectGood && int(rx.stream.nBad) == expectBad &&
+                 memcmp(rx.line1, BENCH_TLE_LINE1, TLE_LEN) == 0 && memcmp(rx.line2, BENCH_TLE_LINE2, TLE_LEN) == 0;
+            failures += !ok;
+            printf("%-16s %8zu %8u %6u %5s %10.3f%s\n", modeNames[mode], w, rx.stream.nRecords, rx.stream.nBad,
+                   rx.found ? "yes" : "no", std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                   ok ? "" : "  MISMATCH");
+        }
+    }
+
+    // Error responses must be rejected without emitting records
+    serveAndParse(makeResponse(body, BODY_LENGTH, 404), 64, rx);
+    bool rejected = rx.stream.failed() && rx.stream.nRecords == 0;
+    failures += !rejected;
+    printf("\nHTTP 404 response: %s (status %d)\n", rejected ? "rejected" : "NOT REJECTED", rx.stream.status);
+
+    // A connection dropped mid-body must not count as a complete response
+    std::string truncated = makeResponse(body, BODY_CHUNKED);
+    truncated.resize(truncated.size() / 2);
+    bool complete = serveAndParse(truncated, 1460, rx);
+    failures += complete;
+    printf("Truncated chunked response: %s\n", complete ? "ACCEPTED" : "flagged incomplete");
+
+    // A body whose last TLE line has no newline must still yield that record in every encoding
+    std::string unterminated = body.substr(0, body.size() - 2);
+    for (int mode = BODY_LENGTH; mode <= BODY_CLOSE; ++mode) {
+        bool ok = serveAndParse(makeResponse(unterminated, BodyMode(mode)), 536, rx);
+        ok = ok && rx.found && int(rx.stream.nRecords) == expectGood;
+        failures += !ok;
+        printf("Unterminated last line, %-16s %s\n", modeNames[mode], ok ? "all records" : "RECORD LOST");
+    }
+
+    // Chunk sizes beyond 32 bits are an error, not a wrapped length
+    rx.stream.begin(onRecord, &rx);
+    const char* huge = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n100000000\r\n1 ";
+    rx.stream.feed(huge, strlen(huge));
+    failures += !rx.stream.failed();
+    printf("Chunk size 0x100000000: %s\n\n", rx.stream.failed() ? "rejected" : "NOT REJECTED");
+
+    // Parser cost alone, fed from memory in receive-sized pieces
+    std::string response = makeResponse(body, BODY_CHUNKED);
+    double parseNs = benchNs(200, [&](uint64_t) {
+        rx.stream.begin(onRecord, &rx);
+        for (size_t i = 0; i < response.size(); i += RCV_CHUNK) {
+            size_t n = response.size() - i < RCV_CHUNK ? response.size() - i : RCV_CHUNK;
+            rx.stream.feed(response.data() + i, n);
+        }
+        doNotOptimize(rx.stream.nRecords);
+    });
+    printf("%-32s %10.3f ms %10.1f MB/s\n", "in-memory parse (chunked)", parseNs / 1e6, response.size() / parseNs * 1e3);
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+/*
+  bench_ntp.cpp - NTP clock discipline against a loopback stand-in time server, over a simulated day
+    Time is virtual: the client's millis() runs from a drifting crystal model (45 ppm, with a daily
+    +-1.5 ppm temperature swing, started just before the 32-bit wrap), and each request crosses a modelled
+    network with jitter, asymmetric queueing spikes and loss. The datagrams themselves are real UDP on
+    loopback, answered by a server thread that also sometimes replays a stale reply or sends kiss-o'-death.
+    The original client (integer seconds from the transmit timestamp, raw millis() extrapolation, 10 min
+    refresh) is modelled over the same network for comparison.
+ */
+#include <atomic>
+#include <random>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench.h"
+#include "ntp_clock.h"
+
+#define SIM_S               86400
+#define SETTLE_S            600         // Error stats exclude the first 10 min after boot
+#define SAMPLE_S            10
+#define OLD_REFRESH_S       600
+#define CRYSTAL_PPM         45.0
+#define CRYSTAL_SWING_PPM   1.5
+#define PATH_US             12000       // One-way base delay
+#define JITTER_US           1500        // Mean of the exponential jitter per direction
+#define SPIKE_PROB          0.08        // Queueing spike on one direction
+#define LOSS_PROB           0.03
+#define STALE_PROB          0.02        // Server replays its previous reply first
+#define KOD_PROB            0.01
+#define SERVER_PROC_US      200
+
+// Virtual true UTC [us] and the local crystal
+static int64_t trueUs;
+static int64_t bootTrueUs;
+static const double localStartMs = 4294967296.0 - 300000.0;    // millis() wraps 5 min after boot
+
+static uint32_t simMillis() {
+    double t = (trueUs - bootTrueUs) / 1e6;
+    double w = TWO_PI / 86400.0;
+    double local_s = t * (1 + CRYSTAL_PPM * 1e-6) + CRYSTAL_SWING_PPM * 1e-6 * (1 - cos(w * t)) / w;
+    return uint32_t(uint64_t(localStartMs + local_s * 1000.0));
+}
+
+// Network conditions for the exchange in flight, set by the client before it sends
+struct Exchange {
+    std::atomic<int64_t> sendTrueUs;
+    std::atomic<int64_t> upUs;
+    std::atomic<bool> lose, stale, kod;
+    std::atomic<bool> stop;
+};
+static Exchange ex;
+
+static void putStamp(uint8_t* p, int64_t unix_us) { unixUsToNtp(unix_us, p); }
+
+// Stratum 2 reply to req, received at t2 and sent at t3
+static void buildReply(const uint8_t* req, int64_t t2, int64_t t3, uint8_t* reply) {
+    memset(reply, 0, NTP_PACKET_SIZE);
+    reply[0] = 0b00100100;      // LI 0, version 4, mode 4 (server)
+    reply[1] = 2;
+    reply[2] = req[2];
+    reply[3] = 0xE9;
+    memcpy(reply + 12, "GPS\0", 4);
+    memcpy(reply + 24, req + 40, 8);
+    putStamp(reply + 16, t2 - 16000000);
+    putStamp(reply + 32, t2);
+    putStamp(reply + 40, t3);
+}
+
+// Stand-in stratum 2 server: answers each request with true time at its arrival & departure
+static void serverLoop(int sock) {
+    uint8_t req[NTP_PACKET_SIZE], reply[NTP_PACKET_SIZE], prev[NTP_PACKET_SIZE];
+    bool havePrev = false;
+    while (!ex.stop) {
+        sockaddr_in from;
+        socklen_t fromLen = sizeof(from);
+        ssize_t n = recvfrom(sock, req, sizeof(req), 0, (sockaddr*)&from, &fromLen);
+        if (n < NTP_PACKET_SIZE) continue;
+
+        int64_t t2 = ex.sendTrueUs + ex.upUs;
+        buildReply(req, t2, t2 + SERVER_PROC_US, reply);
+        if (ex.kod) {
+            reply[1] = 0;
+            memcpy(reply + 12, "RATE", 4);
+        }
+
+        if (ex.stale && havePrev) sendto(sock, prev, sizeof(prev), 0, (sockaddr*)&from, fromLen);
+        if (!ex.lose) sendto(sock, reply, sizeof(reply), 0, (sockaddr*)&from, fromLen);
+        memcpy(prev, reply, sizeof(prev));
+        havePrev = true;
+    }
+}
+
+struct ErrStats {
+    double sumSq, maxAbs;
+    uint32_t n;
+
+    void add(double errUs) {
+        sumSq += errUs * errUs;
+        if (fabs(errUs) > maxAbs) maxAbs = fabs(errUs);
+        n++;
+    }
+    double rmsMs() const { return n ? sqrt(sumSq / n) / 1e3 : 0; }
+};
+
+int main() {
+    int srv = socket(AF_INET, SOCK_DGRAM, 0), cli = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (srv < 0 || cli < 0 || bind(srv, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        getsockname(srv, (sockaddr*)&addr, &addrLen) != 0) {
+        perror("loopback server");
+        return 1;
+    }
+    timeval tv = {0, 100000};
+    setsockopt(srv, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::thread server(serverLoop, srv);
+
+    std::mt19937_64 rng(17);
+    std::uniform_real_distribution<double> uni(0, 1);
+    std::exponential_distribution<double> jitter(1.0 / JITTER_US);
+    auto oneWay = [&]() { return int64_t(PATH_US + jitter(rng)); };
+
+    int failures = 0;
+    bootTrueUs = trueUs = int64_t(BENCH_TLE_EPOCH_UNIX) * 1000000 + 123457;
+    NtpClock clock;
+    clock.begin();
+
+    // Original client state
+    int64_t oldEpoch_s = 0;
+    uint32_t oldRxMillis = 0;
+    bool oldSynced = false;
+
+    ErrStats newErr = {}, oldErr = {}, newSettle = {};
+    uint32_t oldQueries = 0, exchanges = 0, lost = 0, spikes = 0;
+    int64_t nextPoll = trueUs, nextOldPoll = trueUs, nextSample = trueUs;
+    int64_t endUs = bootTrueUs + int64_t(SIM_S) * 1000000;
+    bool crossedWrap = false;
+    uint32_t prevMillis = simMillis();
+
+    while (trueUs < endUs) {
+        if (trueUs >= nextPoll) {
+            // One exchange of the new client, over loopback
+            int64_t up = oneWay(), down = oneWay();
+            if (uni(rng) < SPIKE_PROB) {
+                (uni(rng) < 0.5 ? up : down) += int64_t(80000 + uni(rng) * 220000);
+                spikes++;
+            }
+            ex.sendTrueUs = trueUs;
+            ex.upUs = up;
+            ex.lose = uni(rng) < LOSS_PROB;
+            ex.stale = uni(rng) < STALE_PROB;
+            ex.kod = uni(rng) < KOD_PROB;
+            lost += ex.lose;
+            exchanges++;
+
+            uint8_t pkt[NTP_PACKET_SIZE];
+            clock.buildRequest(pkt, simMillis());
+            sendto(cli, pkt, sizeof(pkt), 0, (sockaddr*)&addr, sizeof(addr));
+            int64_t sendUs = trueUs;
+            bool answered = false;
+            pollfd pfd = {cli, POLLIN, 0};
+            while (!answered && poll(&pfd, 1, 50) > 0) {
+                ssize_t n = recv(cli, pkt, sizeof(pkt), 0);
+                trueUs = sendUs + up + SERVER_PROC_US + down;
+                answered = clock.processReply(pkt, size_t(n), simMillis()) != NTP_INVALID;
+            }
+            nextPoll = answered ? trueUs + int64_t(clock.pollInterval_ms()) * 1000
+                                : sendUs + int64_t(NTP_RETRY_DELAY_MS) * 1000;
+            if (!answered) trueUs = sendUs;
+            continue;
+        }
+        if (trueUs >= nextOldPoll) {
+            // Original client: integer seconds of the transmit timestamp, stamped with millis() at receipt
+            int64_t t3 = trueUs + oneWay() + SERVER_PROC_US;
+            int64_t rx = t3 + oneWay();
+            oldEpoch_s = t3 / 1000000;
+            int64_t save = trueUs;
+            trueUs = rx;
+            oldRxMillis = simMillis();
+            trueUs = save;
+            oldSynced = true;
+            oldQueries++;
+            nextOldPoll = rx + int64_t(OLD_REFRESH_S) * 1000000;
+        }
+        if (trueUs >= nextSample) {
+            uint32_t ms = simMillis();
+            crossedWrap |= ms < prevMillis;
+            prevMillis = ms;
+            bool settled = trueUs - bootTrueUs >= int64_t(SETTLE_S) * 1000000;
+            if (clock.synced) {
+                double err = double(clock.utcUs(ms) - trueUs);
+                (settled ? newErr : newSettle).add(err);
+            }
+            if (oldSynced && settled) {
+                int64_t oldUtc = oldEpoch_s * 1000000 + int64_t(uint32_t(ms - oldRxMillis)) * 1000;
+                oldErr.add(double(oldUtc - trueUs));
+            }
+            nextSample += int64_t(SAMPLE_S) * 1000000;
+        }
+        trueUs = nextPoll < nextOldPoll ? nextPoll : nextOldPoll;
+        if (nextSample < trueUs) trueUs = nextSample;
+    }
+    ex.stop = true;
+    server.join();
+    close(srv);
+    close(cli);
+
+    printf("One day, crystal %+.0f ppm +-%.1f ppm, one-way delay %.0f ms + %.1f ms jitter, millis() wrap crossed: %s\n",
+           CRYSTAL_PPM, CRYSTAL_SWING_PPM, PATH_US / 1e3, JITTER_US / 1e3, crossedWrap ? "yes" : "no");
+    printf("Exchanges %u: %u accepted, %u filtered, %u invalid, %u lost, %u delay spikes injected\n\n", exchanges,
+           clock.nAccepted, clock.nFiltered, clock.nInvalid, lost, spikes);
+    printf("%-28s %8s %12s %12s\n", "client", "queries", "rms err ms", "max err ms");
+    printf("%-28s %8u %12.3f %12.3f\n", "original (10 min, int sec)", oldQueries, oldErr.rmsMs(), oldErr.maxAbs / 1e3);
+    printf("%-28s %8u %12.3f %12.3f\n", "disciplined", exchanges, newErr.rmsMs(), newErr.maxAbs / 1e3);
+    printf("%-28s %8s %12.3f %12.3f\n", "  first 10 min", "", newSettle.rmsMs(), newSettle.maxAbs / 1e3);
+    printf("\nEstimated drift %.2f ppm, final poll interval %u s\n", clock.drift_ppb / 1e3, clock.poll_s);
+
+    // Timestamp conversion round trip, including the 2036 era rollover
+    uint8_t ts[8];
+    bool convOk = true;
+    for (int64_t u : {int64_t(0), int64_t(1678194540123456LL), int64_t(2085978496000000LL), int64_t(2200000000999999LL)}) {
+        unixUsToNtp(u, ts);
+        convOk &= llabs(ntpToUnixUs(ts) - u) <= 1;
+    }
+    printf("NTP timestamp round trip across the 2036 rollover: %s\n", convOk ? "ok" : "FAILED");
+
+    // A new server address drops the old samples, the clock holds its time until the new server answers and
+    // its first reply restarts the fit even though it is within NTP_STEP_US of the old server
+    uint32_t ms = simMillis();
+    int64_t before = clock.utcUs(ms);
+    clock.serverChanged();
+    bool held = clock.synced && clock.utcUs(ms) == before;
+    uint8_t req[NTP_PACKET_SIZE], reply[NTP_PACKET_SIZE];
+    clock.buildRequest(req, ms);
+    int64_t newServerUs = before + 20000;
+    buildReply(req, newServerUs, newServerUs, reply);
+    bool restarted = clock.processReply(reply, sizeof(reply), ms) == NTP_ACCEPTED && clock.nFit == 1 &&
+                     llabs(clock.utcUs(ms) - newServerUs) <= 1000;
+    printf("Server change: time held %s, fit restarted on the new server %s\n", held ? "yes" : "NO",
+           restarted ? "yes" : "NO");
+
+    failures += !convOk || !crossedWrap || !held || !restarted;
+    failures += newErr.maxAbs > 10000 || newErr.rmsMs() > 3.0;
+    failures += exchanges >= oldQueries;
+    failures += clock.nInvalid == 0 || clock.nFiltered == 0;
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+/*
+  bench_observers.cpp - Look-angle cost per observer/target with precomputed ObserverFrames vs. ecef2ned
+ */
+#include <initializer_list>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "coord.h"
+
+int main() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> u(0., 1.);
+    const Vec3 satECEF = {4.0e6, -3.0e6, 4.5e6};
+
+    printf("One target, many observers\n");
+    printf("%-8s %18s %18s %10s %14s\n", "N", "ecef2ned ns/obs", "frame ns/obs", "speedup", "max |dAER|");
+    for (size_t count : {1, 10, 100, 1000, 10000, 100000}) {
+        std::vector<Vec3> lla(count);
+        std::vector<ObserverFrame> obs(count);
+        std::vector<Vec3> aerA(count), aerB(count);
+        for (size_t i = 0; i < count; ++i) {
+            lla[i] = Vec3{u(rng) * 180. - 90., u(rng) * 360. - 180., u(rng) * 3000.};
+            obs[i].init(lla[i], DEGREES);
+        }
+        const uint64_t reps = 1000000 / count + 1;
+
+        double tDirect = benchNs(reps, [&](uint64_t) {
+            for (size_t i = 0; i < count; ++i)
+                aerA[i] = ned2AzElRng(ecef2ned(satECEF, lla[i], DEGREES));
+            doNotOptimize(aerA[0].x);
+        }) / double(count);
+        double tFrame = benchNs(reps, [&](uint64_t) {
+            lookAnglesMultiObserver(satECEF, obs.data(), count, aerB.data());
+            doNotOptimize(aerB[0].x);
+        }) / double(count);
+
+        double maxDiff = 0;
+        for (size_t i = 0; i < count; ++i)
+            maxDiff = fmax(maxDiff, fabs(aerA[i].y - aerB[i].y) + fabs(aerA[i].z - aerB[i].z));
+        printf("%-8zu %18.1f %18.1f %9.2fx %14.3e\n", count, tDirect, tFrame, tDirect / tFrame, maxDiff);
+    }
+
+    printf("\nMany targets, one observer\n");
+    ObserverFrame site;
+    const Vec3 siteLLA = {42.36, -71.06, 0};
+    site.init(siteLLA, DEGREES);
+    for (size_t count : {1000, 100000}) {
+        std::vector<Vec3> pos(count), aer(count);
+        for (size_t i = 0; i < count; ++i)
+            pos[i] = Vec3{u(rng) * 2e7 - 1e7, u(rng) * 2e7 - 1e7, u(rng) * 2e7 - 1e7};
+        const uint64_t reps = 1000000 / count + 1;
+
+        double tDirect = benchNs(reps, [&](uint64_t) {
+            for (size_t i = 0; i < count; ++i)
+                aer[i] = ned2AzElRng(ecef2ned(pos[i], siteLLA, DEGREES));
+            doNotOptimize(aer[0].x);
+        }) / double(count);
+        double tFrame = benchNs(reps, [&](uint64_t) {
+            lookAnglesMultiTarget(site, pos.data(), count, aer.data());
+            doNotOptimize(aer[0].x);
+        }) / double(count);
+        printf("%-8zu %18.1f %18.1f %9.2fx\n", count, tDirect, tFrame, tDirect / tFrame);
+    }
+
+    return 0;
+}
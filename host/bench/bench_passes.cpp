@@ -0,0 +1,129 @@
+/*
+  bench_passes.cpp - Cost of predicting a week of ISS passes, checked against a brute-force 1 s scan
+    The float overload is checked against the double search. Both are priced for the M0 as evaluations times
+    the op-counted cost of one look-angle evaluation (op_count.h); the search logic around it is negligible.
+ */
+#include <time.h>
+#include "bench.h"
+#include "op_count.h"
+#include "pass_predict.h"
+
+#define MAX_PASSES      64
+#define M0_HZ           48e6
+#define FLOAT_TIME_TOL_S 1.0    // AOS/LOS agreement of the float search with the double one
+#define FLOAT_EL_TOL_DEG 0.05   // Peak elevation agreement, float look angles drift to ~0.02 deg over the week
+
+// Estimated M0 cycles of one pass-search look-angle evaluation in T
+template <typename T>
+static double evalCycles(const Vec3& llaRef, uint64_t UTC_ms) {
+    OrbitT<Counted<T>> corb;
+    corb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrameT<Counted<T>> cobs;
+    cobs.init(llaRef, DEGREES);
+    UtcTime utc = UtcTime::fromUnixMs(UTC_ms);
+    uint32_t ops[OP_N];
+    return countOps(sizeof(T) == sizeof(float) ? COST_FLOAT : COST_DOUBLE, ops, [&] {
+        Vec3T<Counted<T>> posECI;
+        corb.calcPosECI_UTC(utc, posECI);
+        cobs.lookAngles(eci2ecef(posECI, Counted<T>(-utc.era())));
+    });
+}
+
+static void printUTC(uint64_t UTC_ms) {
+    time_t t = time_t(UTC_ms / 1000);
+    struct tm tmv;
+    gmtime_r(&t, &tmv);
+    printf("%02d-%02d %02d:%02d:%02d", tmv.tm_mon + 1, tmv.tm_mday, tmv.tm_hour, tmv.tm_min, tmv.tm_sec);
+}
+
+int main() {
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(line1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(line2));
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+
+    const Vec3 llaRef = {42.36, -71.06, 0};
+    const uint64_t start_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+    const double week = 7 * SECONDS_PER_DAY;
+
+    Pass passes[MAX_PASSES];
+    uint32_t nEvals = 0;
+    int nPasses = predictPasses(orb, llaRef, start_ms, week, passes, MAX_PASSES, 0.0, &nEvals);
+
+    printf("%d passes in one week, %u look-angle evaluations\n\n", nPasses, nEvals);
+    printf("%-16s %-16s %-16s %8s\n", "AOS", "MAX", "LOS", "maxEl");
+    for (int i = 0; i < nPasses && i < 8; ++i) {
+        printUTC(passes[i].aosUTC_ms); printf("   ");
+        printUTC(passes[i].maxUTC_ms); printf("   ");
+        printUTC(passes[i].losUTC_ms);
+        printf(" %8.2f\n", passes[i].maxEl);
+    }
+
+    // Brute-force reference: sample elevation every second over the whole week
+    int nRef = 0;
+    double maxAosErr = 0, maxMaxElErr = 0;
+    bool up = false;
+    double bestEl = -90;
+    uint64_t aos = 0;
+    for (uint64_t t = start_ms; t < start_ms + uint64_t(week) * 1000; t += 1000) {
+        Vec3 posECI;
+        UtcTime utc = UtcTime::fromUnixMs(t);
+        orb.calcPosECI_UTC(utc, posECI);
+        Vec3 aer = ned2AzElRng(ecef2ned(eci2ecef(posECI, -utc.era()),
+                                        llaRef, DEGREES));
+        if (aer.y >= 0 && !up) { up = true; aos = t; bestEl = aer.y; }
+        if (up) bestEl = fmax(bestEl, aer.y);
+        if (aer.y < 0 && up) {
+            up = false;
+            if (nRef < nPasses) {
+                maxAosErr = fmax(maxAosErr, fabs(double(int64_t(aos - passes[nRef].aosUTC_ms))) / 1e3);
+                maxMaxElErr = fmax(maxMaxElErr, passes[nRef].maxEl - bestEl);
+            }
+            nRef++;
+        }
+    }
+    printf("\nBrute-force 1 s scan found %d passes, max |AOS diff| %.2f s (1 s grid), "
+           "maxEl excess %.4f deg\n", nRef, maxAosErr, maxMaxElErr);
+
+    // Float search against the double one
+    OrbitT<float> orbF;
+    orbF.initFromTLE(line1, line2);
+    Pass passesF[MAX_PASSES];
+    uint32_t nEvalsF = 0;
+    int nPassesF = predictPasses(orbF, llaRef, start_ms, week, passesF, MAX_PASSES, 0.0, &nEvalsF);
+    double maxTimeErrF = 0, maxElErrF = 0;
+    for (int i = 0; i < nPasses && i < nPassesF; ++i) {
+        maxTimeErrF = fmax(maxTimeErrF, fabs(double(int64_t(passesF[i].aosUTC_ms - passes[i].aosUTC_ms))) / 1e3);
+        maxTimeErrF = fmax(maxTimeErrF, fabs(double(int64_t(passesF[i].losUTC_ms - passes[i].losUTC_ms))) / 1e3);
+        maxElErrF = fmax(maxElErrF, fabs(passesF[i].maxEl - passes[i].maxEl));
+    }
+    bool floatOk = nPassesF == nPasses && maxTimeErrF <= FLOAT_TIME_TOL_S && maxElErrF <= FLOAT_EL_TOL_DEG;
+    printf("Float search: %d passes, %u evaluations, max |AOS/LOS diff| %.3f s, max |maxEl diff| %.4f deg%s\n",
+           nPassesF, nEvalsF, maxTimeErrF, maxElErrF, floatOk ? "" : "  FAILED");
+
+    // M0 estimate for the whole week
+    double cycD = evalCycles<double>(llaRef, start_ms + 3600000), cycF = evalCycles<float>(llaRef, start_ms + 3600000);
+    printf("M0 estimate: %.0f / %.0f cycles per double / float evaluation, one week %.1f s / %.1f s at 48 MHz\n\n",
+           cycD, cycF, nEvals * cycD / M0_HZ, nEvalsF * cycF / M0_HZ);
+
+    benchReport("predictPasses (1 week)", benchNs(20, [&](uint64_t) {
+        int n = predictPasses(orb, llaRef, start_ms, week, passes, MAX_PASSES);
+        doNotOptimize(n);
+    }));
+    benchReport("predictPasses float (1 week)", benchNs(20, [&](uint64_t) {
+        int n = predictPasses(orbF, llaRef, start_ms, week, passesF, MAX_PASSES);
+        doNotOptimize(n);
+    }));
+    benchReport("look-angle evaluation", benchNs(200000, [&](uint64_t i) {
+        uint64_t t = start_ms + i * 1000;
+        Vec3 posECI;
+        UtcTime utc = UtcTime::fromUnixMs(t);
+        orb.calcPosECI_UTC(utc, posECI);
+        Vec3 aer = ned2AzElRng(ecef2ned(eci2ecef(posECI, -utc.era()),
+                                        llaRef, DEGREES));
+        doNotOptimize(aer.y);
+    }));
+
+    return floatOk ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+/*
+  bench_pedestal_sim.cpp - A day of ISS passes through the simulated pedestal, per tracking configuration
+    Usage: bench_pedestal_sim [series.csv]   (writes the feed-forward in-pass error time series)
+ */
+#include <chrono>
+#include "bench.h"
+#include "pedestal.h"
+#include "pedestal_sim.h"
+
+#define SIM_DAY_S       86400.0
+#define SAMPLE_MS       100.0
+#define ON_TARGET_DEG   1.0
+
+struct SimCase {
+    const char* name;
+    bool feedForward;
+    bool useCache;
+};
+
+static const SimCase cases[] = {
+    {"step targets, cache",  false, true},
+    {"feed-forward, cache",  true,  true},
+    {"feed-forward, direct", true,  false},
+};
+
+static void printPass(const PointingStats& p, uint64_t start_ms) {
+    printf("  %7.2f h %6.1f min  max el %5.1f | az %7.3f / %8.3f | el %6.3f / %6.3f | pt %6.3f / %7.3f | %5.1f%%\n",
+           (p.aos_ms - start_ms) / 3.6e6, (p.los_ms - p.aos_ms) / 6e4, p.maxEl, p.rmsAz(), p.maxErrAz, p.rmsEl(),
+           p.maxErrEl, p.rmsPt(), p.maxErrPt, 100 * p.onTarget());
+}
+
+int main(int argc, char** argv) {
+    OrbitModel orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+
+    PedSimConfig cfg = {};
+    cfg.llaRef = Vec3{42.36, -71.06, 0};
+    cfg.startUTC_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+    cfg.duration_s = SIM_DAY_S;
+    cfg.sample_ms = SAMPLE_MS;
+    cfg.onTargetDeg = ON_TARGET_DEG;
+
+    FILE* csv = NULL;
+    if (argc > 1) {
+        csv = fopen(argv[1], "w");
+        if (!csv) {
+            printf("Couldn't open %s\n", argv[1]);
+            return 1;
+        }
+        fprintf(csv, "utc_s,truth_az,truth_el,ptr_az,ptr_el,err_az,err_el,err_pt\n");
+    }
+
+    printf("One day from the TLE epoch at %.2f, %.2f; errors in deg (rms / max), on target = within %.1f deg\n\n",
+           cfg.llaRef.x, cfg.llaRef.y, ON_TARGET_DEG);
+
+    int failures = 0;
+    double rmsPt[3] = {};
+    for (int c = 0; c < 3; ++c) {
+        cfg.feedForward = cases[c].feedForward;
+        cfg.useCache = cases[c].useCache;
+        cfg.csv = (c == 1) ? csv : NULL;
+
+        PedSimResult res;
+        auto t0 = std::chrono::steady_clock::now();
+        int rc = runPedestalSim(orb, cfg, res);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        failures += rc != 0 || res.nPasses == 0;
+        rmsPt[c] = res.total.rmsPt();
+
+        printf("%s: %d passes, %u steps, %.2f s wall (%.0fx real time)\n", cases[c].name, res.nPasses, res.nSteps,
+               wall, SIM_DAY_S / wall);
+        for (int i = 0; i < res.nPasses; ++i) printPass(res.passes[i], cfg.startUTC_ms);
+        const PointingStats& t = res.total;
+        printf("  %-30s | az %7.3f / %8.3f | el %6.3f / %6.3f | pt %6.3f / %7.3f | %5.1f%%\n\n", "all passes",
+               t.rmsAz(), t.maxErrAz, t.rmsEl(), t.maxErrEl, t.rmsPt(), t.maxErrPt, 100 * t.onTarget());
+    }
+    if (csv) fclose(csv);
+
+    // Turning feed-forward off at run time must hand the stepper back to step targets
+    Pedestal ped;
+    ped.begin();
+    ped.stepper.setCurrentPosition(0);
+    ped.feedForward = true;
+    ped.point(Vec3{10, 30, 0}, Vec3{0.5, 0, 0});
+    for (int i = 0; i < 5000; ++i, hostClockUs += 1000) ped.runStepper();
+    ped.feedForward = false;
+    ped.point(Vec3{90, 30, 0}, Vec3{0, 0, 0});
+    for (int i = 0; i < 30000; ++i, hostClockUs += 1000) ped.runStepper();
+    double azErr = fabs(wrapDeg180(steps2deg(ped.stepper.currentPosition()) - 90));
+    bool switched = azErr < 0.1 && !ped.track.active;
+    failures += !switched;
+    printf("feed-forward turned off mid-track: %s (az error %.3f deg)\n", switched ? "steps to target" : "STILL TRACKING",
+           azErr);
+
+    // Feed-forward should beat stop-and-go, and the cache shouldn't cost visible pointing accuracy
+    failures += rmsPt[1] >= rmsPt[0];
+    failures += fabs(rmsPt[1] - rmsPt[2]) > 0.01;
+    if (failures) printf("%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
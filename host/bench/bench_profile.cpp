@@ -0,0 +1,70 @@
+/*
+  bench_profile.cpp - Stage latency histograms from a simulated day of tracking, plus the timer's own cost
+    Built with ENABLE_PROFILING so the instrumented firmware sources record into the profiler; the dump is
+    the same text the firmware prints over Serial. The display & TLE receive stages need the hardware.
+ */
+#include "bench.h"
+#include "pedestal_sim.h"
+#include "profile.h"
+
+#define SIM_DAY_S   86400.0
+
+static const uint8_t simStages[] = {PROF_PROPAGATE, PROF_ECEF2LLA, PROF_ECEF2NED, PROF_CACHE_EVAL, PROF_EPHEM_FIT,
+                                    PROF_SET_TARGET_AZ};
+
+// Every sample must land in exactly one bucket, and the summary must be ordered
+static bool stageConsistent(const ProfStage& s) {
+    uint32_t sum = 0;
+    for (int k = 0; k < PROF_N_BUCKETS; ++k) sum += s.hist[k];
+    return sum == s.count && s.minTicks <= s.maxTicks && s.totalTicks >= uint64_t(s.minTicks) * s.count &&
+           s.totalTicks <= uint64_t(s.maxTicks) * s.count;
+}
+
+int main() {
+    OrbitModel orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+
+    PedSimConfig cfg = {};
+    cfg.llaRef = Vec3{42.36, -71.06, 0};
+    cfg.startUTC_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+    cfg.duration_s = SIM_DAY_S;
+    cfg.sample_ms = 1000;
+    cfg.onTargetDeg = 1.0;
+
+    int failures = 0;
+    profileBegin();
+
+    // Cached pointing with step targets exercises the cache, fit & setTargetAz stages, direct the full chain
+    PedSimResult res;
+    cfg.feedForward = false;
+    cfg.useCache = true;
+    failures += runPedestalSim(orb, cfg, res) != 0;
+    cfg.feedForward = true;
+    cfg.useCache = false;
+    failures += runPedestalSim(orb, cfg, res) != 0;
+
+    printf("One simulated day per pointing mode, host timings\n\n");
+    Serial.echo = true;
+    profileDump();
+    Serial.echo = false;
+
+    for (uint8_t id : simStages) {
+        bool ok = profStages[id].count > 0 && stageConsistent(profStages[id]);
+        failures += !ok;
+        if (!ok) printf("stage %u: no samples or inconsistent histogram\n", id);
+    }
+
+    // Cost of one scope: two tick reads & a histogram update
+    profileReset();
+    double scopeNs = benchNs(10000000, [](uint64_t) { PROFILE_SCOPE(PROF_PROPAGATE); });
+    printf("\n");
+    benchReport("PROFILE_SCOPE, empty body", scopeNs);
+    printf("Histogram storage: %zu bytes static (%d stages x %zu), none with ENABLE_PROFILING false\n",
+           sizeof(profStages), PROF_N_STAGES, sizeof(ProfStage));
+
+    profileReset();
+    failures += profStages[PROF_PROPAGATE].count != 0;
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
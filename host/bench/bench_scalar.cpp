@@ -0,0 +1,162 @@
+/*
+  bench_scalar.cpp - Accuracy vs cost of the ECI -> az/el pipeline per scalar instantiation
+    Every row is checked against the double pipeline over one day of the sample TLE. The host has an FPU, so
+    host ns says little about the M0; each row also counts its scalar ops through a wrapper type and prices
+    them with the soft-float / integer cost table in op_count.h to estimate M0+ cycles per fix.
+ */
+#include "bench.h"
+#include "orbit_utils.h"
+#include "fixed_point.h"
+#include "op_count.h"
+#include "track_control.h"
+
+#define SIM_DAY_S       86400
+#define STEP_S          10
+#define TOL_DEG         (180.0 / STEPS_PER_REV)     // Half an azimuth step
+
+struct Fix {
+    double utc_s;
+    double era;
+    Vec3 eci;       // Double-precision propagation [m]
+    Vec3 aer;       // Double-precision look angles, the reference
+};
+
+// Rows are declared by name & cost column; the accumulators start at zero
+struct Row {
+    const char* name;
+    CostRow cost;
+    double sumSqAz = 0, sumSqEl = 0, maxAz = 0, maxEl = 0, maxAll = 0;
+    uint32_t nPass = 0;
+    double ns = 0;
+    uint32_t ops[OP_N] = {};
+    double m0Cycles = 0;
+};
+
+static void addSample(Row& row, const Fix& f, double az, double el) {
+    double dAz = fabs(wrapDeg180(az - f.aer.x)) * cos(f.aer.y * DEG_TO_RAD);    // Cross-elevation az error
+    double dEl = fabs(el - f.aer.y);
+    double err = fmax(dAz, dEl);
+    row.maxAll = fmax(row.maxAll, err);
+    if (f.aer.y <= 0) return;
+    row.sumSqAz += dAz*dAz;
+    row.sumSqEl += dEl*dEl;
+    row.maxAz = fmax(row.maxAz, dAz);
+    row.maxEl = fmax(row.maxEl, dEl);
+    row.nPass++;
+}
+
+// Price one call of fn in ops and estimated M0 cycles
+template <typename Fn>
+static void countRowOps(Row& row, Fn&& fn) {
+    row.m0Cycles = countOps(row.cost, row.ops, fn);
+}
+
+// ECI -> az/el through the T pipeline, with lengths scaled by `scale` (km for Q-format)
+template <typename T>
+static Vec3 pipeline(const ObserverFrameT<T>& obs, const Vec3& eci, double era, double scale) {
+    Vec3T<T> ecef = eci2ecef(Vec3T<T>(eci * scale), T(era));
+    return Vec3(obs.lookAngles(ecef));
+}
+
+template <typename T>
+static void runPipeline(Row& row, const Vec3& lla, const Fix* fixes, size_t n, double scale) {
+    ObserverFrameT<T> obs;
+    obs.init(lla, DEGREES, scale);
+    for (size_t i = 0; i < n; ++i) {
+        Vec3 aer = pipeline(obs, fixes[i].eci, fixes[i].era, scale);
+        addSample(row, fixes[i], aer.x, aer.y);
+    }
+    row.ns = benchNs(200000, [&](uint64_t i) {
+        doNotOptimize(pipeline(obs, fixes[i % n].eci, fixes[i % n].era, scale));
+    });
+
+    ObserverFrameT<Counted<T>> cobs;
+    cobs.init(lla, DEGREES, scale);
+    countRowOps(row, [&] { pipeline(cobs, fixes[n / 2].eci, fixes[n / 2].era, scale); });
+}
+
+// Propagation + pipeline, both in T
+template <typename T>
+static Vec3 endToEnd(OrbitT<T>& orb, const ObserverFrameT<T>& obs, const Fix& f) {
+    Vec3T<T> eci;
+    orb.calcPosECI(T(UtcTime::fromUnixSeconds(f.utc_s).secondsSince(orb.epoch)), eci);
+    return Vec3(obs.lookAngles(eci2ecef(eci, T(f.era))));
+}
+
+template <typename T>
+static void runEndToEnd(Row& row, const Vec3& lla, const Fix* fixes, size_t n) {
+    OrbitT<T> orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrameT<T> obs;
+    obs.init(lla, DEGREES);
+    for (size_t i = 0; i < n; ++i) {
+        Vec3 aer = endToEnd(orb, obs, fixes[i]);
+        addSample(row, fixes[i], aer.x, aer.y);
+    }
+    row.ns = benchNs(200000, [&](uint64_t i) { doNotOptimize(endToEnd(orb, obs, fixes[i % n])); });
+
+    OrbitT<Counted<T>> corb;
+    corb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrameT<Counted<T>> cobs;
+    cobs.init(lla, DEGREES);
+    countRowOps(row, [&] { endToEnd(corb, cobs, fixes[n / 2]); });
+}
+
+int main() {
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    Vec3 lla = {42.36, -71.06, 0};
+    ObserverFrame obs;
+    obs.init(lla, DEGREES);
+
+    // Reference fixes over a day
+    const size_t n = SIM_DAY_S / STEP_S;
+    static Fix fixes[n];
+    for (size_t i = 0; i < n; ++i) {
+        Fix& f = fixes[i];
+        f.utc_s = double(BENCH_TLE_EPOCH_UNIX) + double(i * STEP_S);
+        UtcTime utc = UtcTime::fromUnixSeconds(f.utc_s);
+        f.era = utc.era();
+        orb.calcPosECI_UTC(utc, f.eci);
+        f.aer = obs.lookAngles(eci2ecef(f.eci, f.era));
+    }
+
+    Row rows[] = {
+        {"double pipeline",        COST_DOUBLE},
+        {"float pipeline",         COST_FLOAT},
+        {"Q47.16 pipeline (km)",   COST_FIXED},
+        {"Q39.24 pipeline (km)",   COST_FIXED},
+        {"double end-to-end",      COST_DOUBLE},
+        {"float end-to-end",       COST_FLOAT},
+    };
+    runPipeline<double>(rows[0], lla, fixes, n, 1);
+    runPipeline<float>(rows[1], lla, fixes, n, 1);
+    runPipeline<FixedQ<16>>(rows[2], lla, fixes, n, 1e-3);
+    runPipeline<Fixed>(rows[3], lla, fixes, n, 1e-3);
+    runEndToEnd<double>(rows[4], lla, fixes, n);
+    runEndToEnd<float>(rows[5], lla, fixes, n);
+
+    printf("One day at %d s from %.2f, %.2f; errors vs double in deg, az scaled by cos(el); tolerance %.4f deg\n",
+           STEP_S, lla.x, lla.y, TOL_DEG);
+    printf("Pipeline = ECI -> ECEF -> NED -> az/el; end-to-end adds Kepler propagation from the TLE\n\n");
+    printf("%-22s | %-21s | %-21s | %9s | %8s %7s | %5s %5s %5s %5s %7s %5s %5s | %9s | %s\n", "scalar",
+           "az rms / max (pass)", "el rms / max (pass)", "max (all)", "host ns", "cycles", opNames[0], opNames[1],
+           opNames[2], opNames[3], opNames[4], opNames[5], opNames[6], "M0 cyc*", "ok");
+    int failures = 0;
+    for (Row& r : rows) {
+        bool ok = fmax(r.maxAz, r.maxEl) <= TOL_DEG;
+        printf("%-22s | %9.2e / %9.2e | %9.2e / %9.2e | %9.2e | %8.1f %7.0f | %5u %5u %5u %5u %7u %5u %5u | %9.0f | %s\n",
+               r.name, sqrt(r.sumSqAz / r.nPass), r.maxAz, sqrt(r.sumSqEl / r.nPass), r.maxEl, r.maxAll, r.ns,
+               r.ns * tscPerNs(), r.ops[0], r.ops[1], r.ops[2], r.ops[3], r.ops[4], r.ops[5], r.ops[6], r.m0Cycles,
+               ok ? "yes" : "no");
+        failures += r.nPass == 0;
+    }
+    printf("\n* estimated from the op counts and the assumed per-op M0+ costs in op_count.h\n");
+
+    // The double rows are the reference itself; float & Q39.24 are expected to stay within tolerance
+    failures += rows[0].maxAll != 0 || rows[4].maxAll != 0;
+    failures += fmax(rows[1].maxAz, rows[1].maxEl) > TOL_DEG;
+    failures += fmax(rows[3].maxAz, rows[3].maxEl) > TOL_DEG;
+    if (failures) printf("%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/*
+  bench_scheduler.cpp - Cooperative scheduler on a virtual clock
+    Runs the firmware's task set with modelled Feather M0 task costs across millis() and micros() wraparound
+    and a WiFi outage, and compares the worst stepper service gap against the original polling loop().
+    The orbit and ephemeris fit costs are priced from op counts of their math (op_count.h), so they move
+    together with the per-propagation cost rather than being set independently.
+ */
+#include "bench.h"
+#include "scheduler.h"
+#include "defs.h"
+#include "cheb_cache.h"
+#include "op_count.h"
+
+// Virtual time in microseconds, started just before millis() wraps
+static uint64_t simUs = ((1ULL << 32) - 5000) * 1000;
+
+static uint32_t simMillis() { return uint32_t(simUs / 1000); }
+static uint32_t simMicros() { return uint32_t(simUs); }
+static void simDelay(double ms) { simUs += uint64_t(ms * 1000); }
+
+// Modelled task costs on the M0 (ms)
+#define COST_STEPPER    0.02
+#define COST_NET_POLL   0.3     // SPI round trip to the WiFi co-processor
+#define COST_WIFI_BEGIN 2.0     // Non-blocking begin, just the SPI command
+#define COST_DISPLAY    24.0    // Full 1 KB frame over 400 kHz I2C
+#define M0_HZ           48e6
+#define FIT_STEP_MAX_MS 10.0    // Budget for one fitNextSegment() call
+
+// Orbit task and ephemeris fit costs (ms), priced from op counts by priceOrbitCosts()
+static double costOrbit;        // Propagation + ECEF + LLA + look angles
+static double costFitStep;      // One fitNextSegment() call, CHEB_EVALS_PER_TICK propagations
+static double costFitSegment;   // A whole segment in one call, as before the fit was split
+
+// Original loop() blocking costs during an outage: WiFi.begin() timeout then delay(10000)
+#define OLD_BEGIN_MS    5000
+#define OLD_DELAY_MS    10000
+
+#define SIM_HOURS       2
+#define OUTAGE_START_S  1800
+#define OUTAGE_LEN_S    120
+
+static uint64_t simStartUs;
+static uint32_t stepperCalls;
+
+static bool wifiDown() {
+    double t = double(simUs - simStartUs) / 1e6;
+    return t >= OUTAGE_START_S && t < OUTAGE_START_S + OUTAGE_LEN_S;
+}
+
+static void stepperIdle(void*) { stepperCalls++; simDelay(COST_STEPPER); }
+static void wifiTask(void*) { simDelay(wifiDown() ? COST_WIFI_BEGIN : COST_NET_POLL); }
+static void netTask(void*) { if (!wifiDown()) simDelay(COST_NET_POLL); }
+static void orbitTask(void*) { simDelay(costOrbit); }
+static void ephemTask(void*) { simDelay(costFitStep); }
+static void displayTask(void*) { simDelay(COST_DISPLAY); }
+static void stallTask(void* ctx) { simDelay(*(double*)ctx); }
+
+// Largest gap between stepper calls for the original loop(), which did orbit, fit & display in one pass
+// and blocked in the reconnect loop for the whole outage
+static double oldLoopMaxGapMs() {
+    double gap = COST_NET_POLL * 3 + costOrbit + costFitSegment + COST_DISPLAY;
+    double outage = 0;
+    while (outage < OUTAGE_LEN_S * 1000.0) outage += OLD_BEGIN_MS + OLD_DELAY_MS;
+    return gap > outage ? gap : outage;
+}
+
+// Price the orbit task and the ephemeris fit in soft-float double. The fit is one directNED() chain per node
+// or check point, and each node also folds its samples into the DCT sums as ChebCache does
+static void priceOrbitCosts() {
+    const int N = CHEB_DEGREE + 1;
+    OrbitT<Counted<double>> corb;
+    corb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrameT<Counted<double>> cobs;
+    cobs.init(Vec3{42.36, -71.06, 0}, DEGREES);
+    UtcTime t = corb.epoch + 3600 * NS_PER_SEC;
+    Counted<double> era = -t.era();
+    uint32_t ops[OP_N];
+
+    double orbitCycles = countOps(COST_DOUBLE, ops, [&] {
+        Vec3T<Counted<double>> pos, vel;
+        corb.calcPosVelECI_UTC(t, pos, vel);
+        Vec3T<Counted<double>> ecef = eci2ecef(pos, era);
+        ecef2lla(ecef, DEGREES);
+        cobs.lookAngles(ecef);
+    });
+    double evalCycles = countOps(COST_DOUBLE, ops, [&] {
+        Vec3T<Counted<double>> pos;
+        corb.calcPosECI_UTC(t, pos);
+        cobs.ecef2ned(eci2ecef(pos, era));
+    });
+    double foldCycles = countOps(COST_DOUBLE, ops, [&] {
+        Counted<double> sum[3][CHEB_DEGREE+1] = {}, f[3] = {1.0, 2.0, 3.0};
+        Counted<double> x = cos(Counted<double>(0.1)), tPrev = 1, tm = x;
+        for (int k = 0; k < 3; ++k) sum[k][0] = sum[k][0] + f[k];
+        for (int m = 1; m < N; ++m) {
+            for (int k = 0; k < 3; ++k) sum[k][m] = sum[k][m] + f[k] * tm;
+            Counted<double> tNext = Counted<double>(2) * x * tm - tPrev;
+            tPrev = tm;
+            tm = tNext;
+        }
+    });
+
+    // Per segment: N nodes with their DCT terms, then N-1 error checks
+    costOrbit = orbitCycles / M0_HZ * 1e3;
+    costFitStep = (CHEB_EVALS_PER_TICK * evalCycles + foldCycles) / M0_HZ * 1e3;
+    costFitSegment = (N * (evalCycles + foldCycles) + (N - 1) * evalCycles) / M0_HZ * 1e3;
+    printf("M0 estimates: orbit task %.1f ms, one fit propagation %.1f ms, fit step (%d propagations) %.1f ms, "
+           "whole segment %.0f ms\n", costOrbit, evalCycles / M0_HZ * 1e3, CHEB_EVALS_PER_TICK, costFitStep,
+           costFitSegment);
+}
+
+int main() {
+    int failures = 0;
+    priceOrbitCosts();
+
+    // Wraparound-safe comparisons
+    bool wrapOk = timeReached(5, 0xFFFFFFF0u) && !timeReached(0xFFFFFFF0u, 5) &&
+                  timeReached(0x80000000u, 0x7FFFFFFFu) && uint32_t(5u - 0xFFFFFFF0u) == 21;
+    failures += !wrapOk;
+    printf("timeReached across wrap: %s\n", wrapOk ? "ok" : "FAILED");
+
+    // Firmware task set
+    Scheduler sched;
+    sched.begin(simMillis, simMicros, stepperIdle, NULL);
+    sched.add("wifi",    wifiTask,    NULL, WIFI_TASK_MS);
+    sched.add("ntp",     netTask,     NULL, NET_POLL_MS);
+    sched.add("tle",     netTask,     NULL, NET_POLL_MS);
+    int idOrbit = sched.add("orbit",   orbitTask,   NULL, ORBIT_REFRESH_DELAY_MS, ORBIT_REFRESH_DELAY_MS/2);
+    sched.add("ephem",   ephemTask,   NULL, EPHEM_TASK_MS);
+    sched.add("display", displayTask, NULL, DISPLAY_TASK_MS);
+
+    simStartUs = simUs;
+    uint32_t startMs = simMillis();
+    bool crossedMillis = false, crossedMicros = false;
+    uint32_t prevUs = simMicros();
+    while (simUs - simStartUs < uint64_t(SIM_HOURS) * 3600 * 1000000) {
+        sched.runOnce();
+        simDelay(0.01);     // loop() overhead
+        crossedMillis |= simMillis() < startMs;
+        crossedMicros |= simMicros() < prevUs;
+        prevUs = simMicros();
+    }
+
+    double simS = SIM_HOURS * 3600.0;
+    printf("Simulated %d h, crossed millis() wrap: %s, micros() wrap: %s, %u stepper calls\n\n",
+           SIM_HOURS, crossedMillis ? "yes" : "no", crossedMicros ? "yes" : "no", stepperCalls);
+    failures += !crossedMillis + !crossedMicros;
+
+    printf("%-8s %8s %8s %10s %10s %10s %8s\n", "task", "period", "runs", "expected", "max us", "max late", "missed");
+    uint32_t maxRun = 0;
+    for (uint8_t i = 0; i < sched.nTasks; ++i) {
+        const Task& t = sched.tasks[i];
+        double expected = simS * 1000.0 / t.period_ms;
+        bool ok = fabs(t.nRuns - expected) <= expected * 0.01 + 1;
+        failures += !ok;
+        if (t.maxRun_us > maxRun) maxRun = t.maxRun_us;
+        printf("%-8s %6u ms %8u %10.0f %10u %7u ms %8u%s\n", t.name, t.period_ms, t.nRuns, expected, t.maxRun_us,
+               t.maxLate_ms, t.nMissed, ok ? "" : "  MISMATCH");
+    }
+
+    // The stepper gap must be bounded by the longest single task plus the stepper call itself
+    double newGapMs = sched.maxIdleGap_us / 1e3;
+    bool bounded = sched.maxIdleGap_us <= maxRun + uint32_t(COST_STEPPER * 1000) + 20;
+    failures += !bounded;
+    printf("\nWorst stepper gap, %d s WiFi outage included\n", OUTAGE_LEN_S);
+    printf("  original loop():  %10.1f ms\n", oldLoopMaxGapMs());
+    printf("  scheduler:        %10.1f ms (longest task %.1f ms)%s\n", newGapMs, maxRun / 1e3,
+           bounded ? "" : "  NOT BOUNDED");
+    bool fitOk = costFitStep <= FIT_STEP_MAX_MS;
+    failures += !fitOk;
+    printf("  ephemeris fit:    %10.1f ms per call, vs. %.0f ms for a whole segment in one call%s\n", costFitStep,
+           costFitSegment, fitOk ? "" : "  OVER BUDGET");
+
+    // A long stall must not be followed by a catch-up burst
+    double stallMs = 3000;
+    uint32_t orbitRuns = sched.tasks[idOrbit].nRuns;
+    int idStall = sched.add("stall", stallTask, &stallMs, 60000);
+    sched.runOnce();
+    sched.setEnabled(idStall, false);
+    sched.runOnce();
+    sched.runOnce();
+    uint32_t burst = sched.tasks[idOrbit].nRuns - orbitRuns;
+    failures += burst > 2;
+    printf("  orbit runs right after a %.0f ms stall: %u (no catch-up burst: %s)\n", stallMs, burst,
+           burst <= 2 ? "yes" : "NO");
+
+    // Scheduler overhead with trivial tasks
+    Scheduler idleSched;
+    idleSched.begin(simMillis, simMicros, NULL, NULL);
+    for (int i = 0; i < 6; ++i) idleSched.add("noop", [](void*) {}, NULL, 1000000);
+    double passNs = benchNs(1000000, [&](uint64_t) { idleSched.runOnce(); });
+    printf("\n");
+    benchReport("runOnce(), 6 tasks none due", passNs);
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+/*
+  bench_sgp4.cpp - SGP4 accuracy check against published reference vectors, and per-call cost vs. Orbit
+ */
+#include <initializer_list>
+#include "bench.h"
+#include "sgp4.h"
+
+// Vallado et al. (AIAA 2006-6753) verification case, satellite 00005
+static char VER_LINE1[] = "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753";
+static char VER_LINE2[] = "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667";
+
+struct RefState { double tMin; double r[3]; double v[3]; };
+static const RefState VER_REF[] = {
+    {   0., { 7022.46529266, -1400.08296755,     0.03995155}, { 1.893841015,  6.405893759,  4.534807250}},
+    { 360., {-7154.03120202, -3783.17682504, -3536.19412294}, { 4.741887409, -4.151817765, -2.093935425}},
+};
+
+int main() {
+    // Accuracy against the reference implementation
+    Sgp4 ver{};
+    if (ver.initFromTLE(VER_LINE1, VER_LINE2) != SGP4_OK) {
+        printf("SGP4 init failed for verification TLE\n");
+        return 1;
+    }
+    printf("Verification vs. reference (sat 00005):\n");
+    for (const RefState& ref : VER_REF) {
+        Vec3 pos, vel;
+        ver.calcPosVelECI(ref.tMin * 60., pos, vel);
+        Vec3 dr = pos - Vec3{ref.r[0]*1e3, ref.r[1]*1e3, ref.r[2]*1e3};
+        Vec3 dv = vel - Vec3{ref.v[0]*1e3, ref.v[1]*1e3, ref.v[2]*1e3};
+        printf("  t = %6.1f min   |dr| = %.3e m   |dv| = %.3e m/s\n", ref.tMin, norm(dr), norm(dv));
+    }
+
+    // Two-body vs. SGP4 divergence with TLE age for the ISS
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(line1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(line2));
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+    Sgp4 sgp{};
+    sgp.initFromTLE(line1, line2);
+
+    printf("\nISS two-body Orbit vs. SGP4 position difference:\n");
+    for (double hours : {0., 1., 6., 24., 72.}) {
+        Vec3 p1, v1, p2, v2;
+        orb.calcPosVelECI(hours * 3600., p1, v1);
+        sgp.calcPosVelECI(hours * 3600., p2, v2);
+        printf("  TLE age %5.1f h   |dr| = %10.1f km\n", hours, norm(p1 - p2) / 1e3);
+    }
+
+    // Per-call cost
+    printf("\n");
+    const uint64_t N = 200000;
+    benchReport("Sgp4::initFromTLE", benchNs(N, [&](uint64_t) {
+        sgp.initFromTLE(line1, line2);
+        doNotOptimize(sgp.cc1);
+    }));
+    benchReport("Orbit::calcPosVelECI", benchNs(N, [&](uint64_t i) {
+        Vec3 pos, vel;
+        orb.calcPosVelECI(double(i % 5400), pos, vel);
+        doNotOptimize(pos.x);
+    }));
+    benchReport("Sgp4::calcPosVelECI", benchNs(N, [&](uint64_t i) {
+        Vec3 pos, vel;
+        sgp.calcPosVelECI(double(i % 5400), pos, vel);
+        doNotOptimize(pos.x);
+    }));
+
+    return 0;
+}
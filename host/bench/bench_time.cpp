@@ -0,0 +1,137 @@
+/*
+  bench_time.cpp - Accuracy & cost of the time conversions and Earth-Rotation-Angle paths
+    The two previous ERA paths are reproduced below for comparison: Julian date from whole unix seconds through
+    one large-argument fmod, and the millisecond day/fraction split that OrbitTracker used. All are checked
+    against the IERS formula evaluated in long double from the exact integer day count & day fraction.
+ */
+#include <random>
+#include "bench.h"
+#include "orbit_utils.h"
+
+#define SPAN_DAYS   (40 * 365)      // 2000 to 2040
+#define N_SAMPLES   (1 << 20)
+
+// Previous getEraFromJulian(getJulianFromUnix(ms / 1000))
+__attribute__((noinline)) static double legacyEra(uint64_t unixMs) {
+    long unixSecs = long(unixMs / 1000);
+    double julian = (unixSecs / 86400.) + JD_UNIX_EPOCH;
+    double Tu = julian - 2451545.0;
+    return fmod(TWO_PI * (0.7790572732640 + 1.00273781191135448 * Tu), TWO_PI);
+}
+
+// Previous getEraFromUnixMs
+__attribute__((noinline)) static double dayFracEra(uint64_t unixMs) {
+    int64_t ms = int64_t(unixMs - 946728000000ULL);
+    int64_t days = ms / 86400000LL;
+    double dayFrac = double(ms - days * 86400000LL) / 86400000.;
+    double turns = 0.7790572732640 + dayFrac + 0.00273781191135448 * (double(days) + dayFrac);
+    turns -= floor(turns);
+    return TWO_PI * turns;
+}
+
+__attribute__((noinline)) static double newEra(uint64_t unixMs) { return UtcTime::fromUnixMs(unixMs).era(); }
+
+// ERA [turns] in long double, whole UT1 days since J2000 kept apart from the fraction
+static long double refEraTurns(int64_t unixNs) {
+    int64_t t = unixNs - J2000_UNIX_NS;
+    int64_t days = floorDiv(t, NS_PER_DAY);
+    long double frac = (long double)(t - days * NS_PER_DAY) / NS_PER_DAY;
+    long double turns = 0.7790572732640L + frac + 0.00273781191135448L * ((long double)days + frac);
+    return turns - floorl(turns);
+}
+
+// |a - b| for angles in [0, 2pi), across the wrap
+static double angDiff(double a, double b) {
+    double d = fabs(a - b);
+    return fmin(d, TWO_PI - d);
+}
+
+int main() {
+    int failures = 0;
+
+    // Fixed points of the conversions
+    UtcTime j2000 = {J2000_UNIX_NS};
+    JulianDate jd = j2000.julianUtc();
+    JulianDate jdTt = j2000.julianTt();
+    failures += jd.day != 2451544.5 || jd.frac != 0.5;
+    failures += fabs(((jdTt.day - jd.day) + (jdTt.frac - jd.frac)) * 86400. - 69.184) > 1e-9;
+    failures += utcFromYearDay(2000, 1).ns != 946684800LL * NS_PER_SEC;
+    failures += utcFromYearDay(1970, 1).ns != 0 || utcFromYearDay(1969, 365).ns != -NS_PER_DAY;
+    failures += UtcTime{-1}.unixSec() != -1 || UtcTime::fromUnixSeconds(-0.25).ns != -250000000;
+    failures += fabs(turnsToRad(ERA_TURNS_J2000) - TWO_PI * 0.7790572732640) > 1e-15;
+
+    // TLE epoch 23066.54791667 = 2023-03-07 13:09:00.000288
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    failures += orb.epoch.ns != int64_t(BENCH_TLE_EPOCH_UNIX) * NS_PER_SEC + 288000;
+    printf("TLE epoch %lld ns, JD %.9f + %.17f, JD(TT) %.9f\n", (long long)orb.epoch.ns,
+           orb.epoch.julianUtc().day, orb.epoch.julianUtc().frac, orb.epoch.julianTt().value());
+
+    // ERA error over random millisecond instants
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<uint64_t> dist(946684800000ULL, 946684800000ULL + uint64_t(SPAN_DAYS) * 86400000ULL);
+    double maxLegacy = 0, maxDayFrac = 0, maxNew = 0;
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        uint64_t ms = dist(rng);
+        double ref = double(refEraTurns(UtcTime::fromUnixMs(ms).ns) * (long double)TWO_PI);
+        maxLegacy = fmax(maxLegacy, angDiff(legacyEra(ms), ref));
+        maxDayFrac = fmax(maxDayFrac, angDiff(dayFracEra(ms), ref));
+        maxNew = fmax(maxNew, angDiff(newEra(ms), ref));
+    }
+    printf("\nERA max error vs long double, %d instants 2000-2040 [rad]\n", N_SAMPLES);
+    printf("  Julian from whole seconds + fmod %10.3e\n", maxLegacy);
+    printf("  ms day/fraction split            %10.3e\n", maxDayFrac);
+    printf("  UtcTime::era (Q64 turns)         %10.3e\n", maxNew);
+    failures += maxNew > 1e-14;
+
+    // Incremental ERA over a day of 500 ms ticks with ms & ns jitter, against the exact value at each tick
+    EraClock clk;
+    clk.set(orb.epoch);
+    UtcTime t = orb.epoch;
+    uint64_t maxStepErr = 0;
+    for (uint32_t i = 0; i < 86400 * 2; ++i) {
+        t = t + int64_t(500 + (i * 7919) % 7 - 3) * 1000000 + (i % 1000);
+        clk.advanceTo(t);
+        uint64_t d = clk.turns - t.eraTurns();
+        d = int64_t(d) < 0 ? -d : d;
+        if (d > maxStepErr) maxStepErr = d;
+    }
+    printf("\nEraClock after 172800 jittered ticks: max drift %llu Q64 units (%.3e rad)\n",
+           (unsigned long long)maxStepErr, turnsToDeltaRad(maxStepErr));
+    failures += turnsToDeltaRad(maxStepErr) > 1e-14;
+
+    const int nArg = 4096;
+    static uint64_t ms[nArg];
+    for (int i = 0; i < nArg; ++i) ms[i] = dist(rng);
+    const uint64_t N = 4000000;
+    printf("\n");
+    benchReportCycles("ERA, Julian + fmod (previous)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(legacyEra(ms[i % nArg]));
+    }));
+    benchReportCycles("ERA, ms day split (previous)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(dayFracEra(ms[i % nArg]));
+    }));
+    benchReportCycles("UtcTime::era", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(newEra(ms[i % nArg]));
+    }));
+    benchReportCycles("UtcTime::eraTurns", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(UtcTime::fromUnixMs(ms[i % nArg]).eraTurns());
+    }));
+    clk.set(orb.epoch);
+    benchReportCycles("EraClock::advanceTo + angle", benchNs(N, [&](uint64_t i) {
+        clk.advanceTo(orb.epoch + int64_t(i) * 500000000);
+        doNotOptimize(clk.angle());
+    }));
+    benchReportCycles("UtcTime::julianUtc", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(UtcTime::fromUnixMs(ms[i % nArg]).julianUtc());
+    }));
+    benchReportCycles("UtcTime::julianTt", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(UtcTime::fromUnixMs(ms[i % nArg]).julianTt());
+    }));
+    benchReportCycles("secondsSince epoch", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(UtcTime::fromUnixMs(ms[i % nArg]).secondsSince(orb.epoch));
+    }));
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+/*
+  bench_tracker.cpp - Steady-state tick cost & agreement of OrbitTracker vs. the stateless propagation path
+ */
+#include "bench.h"
+#include "orbit_tracker.h"
+
+int main() {
+    char line1[sizeof(BENCH_TLE_LINE1)], line2[sizeof(BENCH_TLE_LINE2)];
+    memcpy(line1, BENCH_TLE_LINE1, sizeof(line1));
+    memcpy(line2, BENCH_TLE_LINE2, sizeof(line2));
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+
+    const uint64_t start_ms = uint64_t(BENCH_TLE_EPOCH_UNIX) * 1000;
+    const uint64_t tick_ms = 500;
+
+    // Agreement over a day of 500 ms ticks with +-3 ms jitter, like millis()-driven loop()
+    OrbitTracker trk{};
+    trk.init(orb);
+    double maxPos = 0, maxVel = 0, maxEcef = 0, maxEra = 0;
+    uint64_t t = start_ms;
+    for (uint32_t i = 0; i < 86400 * 2; ++i) {
+        t += tick_ms + (i * 7919) % 7 - 3;
+        Vec3 p1, v1, p2, v2;
+        UtcTime utc = UtcTime::fromUnixMs(t);
+        orb.calcPosVelECI_UTC(utc, p1, v1);
+        trk.update(t, p2, v2);
+        double era = utc.era();
+        maxPos = fmax(maxPos, norm(p1 - p2));
+        maxVel = fmax(maxVel, norm(v1 - v2));
+        maxEcef = fmax(maxEcef, norm(eci2ecef(p1, -era) - trk.eci2ecef(p2)));
+        double dEra = fabs(era - trk.era);
+        maxEra = fmax(maxEra, fmin(dEra, TWO_PI - dEra));
+    }
+    printf("Max difference vs. stateless path over 1 day of ticks:\n");
+    printf("  posECI %.3e m, velECI %.3e m/s, posECEF %.3e m, ERA %.3e rad\n\n", maxPos, maxVel, maxEcef, maxEra);
+
+    const uint64_t N = 400000;
+    benchReportCycles("stateless tick (ECI+ERA+ECEF)", benchNs(N, [&](uint64_t i) {
+        uint64_t tt = start_ms + i * tick_ms;
+        Vec3 pos, vel;
+        UtcTime utc = UtcTime::fromUnixMs(tt);
+        orb.calcPosVelECI_UTC(utc, pos, vel);
+        Vec3 ecef = eci2ecef(pos, -utc.era());
+        doNotOptimize(ecef.x);
+    }));
+
+    trk.init(orb);
+    uint64_t base = start_ms;
+    benchReportCycles("OrbitTracker tick (ECI+ERA+ECEF)", benchNs(N, [&](uint64_t i) {
+        uint64_t tt = base + i * tick_ms;
+        Vec3 pos, vel;
+        trk.update(tt, pos, vel);
+        Vec3 ecef = trk.eci2ecef(pos);
+        doNotOptimize(ecef.x);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+  bench_tracking.cpp - Pointing lag over simulated passes: stop-and-go step targets vs velocity feed-forward
+    The stepper is the AccelStepper model on a virtual clock, driven exactly as Pedestal does in each mode;
+    the servo is taken to reach its commanded angle instantly. Truth is the full propagation chain.
+ */
+#include <initializer_list>
+#include "bench.h"
+#include "orbit_tracker.h"
+#include "sim_stepper.h"
+#include "track_control.h"
+
+#define SIM_TICK_US     250     // How often the stepper is serviced
+#define SAMPLE_MS       10      // Error sampling interval
+#define CULM_WINDOW_S   60      // Half-width of the culmination window reported separately
+
+static uint64_t simUs;
+static uint32_t simMicros() { return uint32_t(simUs); }
+static uint32_t simMillis() { return uint32_t(simUs / 1000); }
+
+struct LagStats {
+    double sumSqAz, sumSqEl, sumSqPt;
+    double peakAz, peakEl, peakPt, peakPtCulm;
+    uint32_t n;
+};
+
+// Az/El [deg] and rates [deg/s] of the orbit from the observer at UTC_ms
+static void lookWithRates(OrbitTracker& tracker, const ObserverFrame& obs, uint64_t UTC_ms, Vec3& aer, Vec3& rates) {
+    Vec3 posECI, velECI;
+    tracker.update(UTC_ms, posECI, velECI);
+    Vec3 posNED = obs.ecef2ned(tracker.eci2ecef(posECI));
+    Vec3 velNED = obs.ecefVel2ned(tracker.eciVel2ecef(posECI, velECI));
+    aer = ned2AzElRng(posNED);
+    rates = ned2AzElRates(posNED, velNED);
+}
+
+// Angle between two Az/El directions [deg]
+static double separationDeg(double az1, double el1, double az2, double el2) {
+    az1 *= DEG_TO_RAD; el1 *= DEG_TO_RAD; az2 *= DEG_TO_RAD; el2 *= DEG_TO_RAD;
+    double c = sin(el1)*sin(el2) + cos(el1)*cos(el2)*cos(az1 - az2);
+    return acos(fmin(1.0, fmax(-1.0, c))) * RAD_TO_DEG;
+}
+
+// Simulate one pass from aos to los with the given tracking mode
+static LagStats simulatePass(Orbit& orb, const ObserverFrame& obs, uint64_t aos_ms, uint64_t los_ms,
+                             uint64_t culm_ms, bool feedForward) {
+    OrbitTracker ctrlTracker, truthTracker;
+    ctrlTracker.init(orb);
+    truthTracker.init(orb);
+
+    // Virtual clock runs in step with UTC from AOS
+    simUs = 1000000;
+    uint64_t simStartUs = simUs;
+
+    SimStepper stepper;
+    stepper.begin(simMicros);
+    stepper.setMaxSpeed(STEPPER_SPEED);
+    stepper.setAcceleration(STEPPER_ACCEL);
+
+    Vec3 aer, rates;
+    lookWithRates(ctrlTracker, obs, aos_ms, aer, rates);
+    stepper.setCurrentPosition(deg2steps(aer.x));
+
+    TrackControl track;
+    track.begin();
+    double elCmd = aer.y;
+    uint32_t lastOrbitMs = simMillis() - ORBIT_REFRESH_DELAY_MS;
+    uint32_t lastSampleMs = simMillis();
+
+    LagStats st = {};
+    for (uint64_t UTC_ms = aos_ms; UTC_ms <= los_ms; UTC_ms = aos_ms + (simUs - simStartUs) / 1000) {
+        uint32_t nowMs = simMillis();
+
+        // Orbit task
+        if (nowMs - lastOrbitMs >= ORBIT_REFRESH_DELAY_MS) {
+            lastOrbitMs = nowMs;
+            lookWithRates(ctrlTracker, obs, UTC_ms, aer, rates);
+            if (feedForward) {
+                track.setTarget(aer.x, rates.x, aer.y, rates.y, nowMs);
+            } else {
+                // Pedestal::setTargetAz, only once the previous target was reached
+                if (stepper.distanceToGo() == 0) {
+                    double currAz = fmod(steps2deg(stepper.currentPosition()) + 3600, 360.0);
+                    stepper.move(deg2steps(wrapDeg180(aer.x - currAz)));
+                }
+                elCmd = aer.y;
+            }
+        }
+
+        // Pedestal::runStepper
+        if (feedForward) {
+            if (nowMs - track.lastUpdate_ms >= TRACK_UPDATE_MS) {
+                stepper.setSpeed(track.speedCommand(stepper.currentPosition(), nowMs));
+                elCmd = track.elAt(nowMs);
+            }
+            stepper.runSpeed();
+        } else {
+            stepper.run();
+        }
+
+        // Compare against truth
+        if (nowMs - lastSampleMs >= SAMPLE_MS) {
+            lastSampleMs = nowMs;
+            Vec3 truth, truthRates;
+            lookWithRates(truthTracker, obs, UTC_ms, truth, truthRates);
+            double azPt = steps2deg(stepper.currentPosition());
+            double errAz = fabs(wrapDeg180(truth.x - azPt));
+            double errEl = fabs(truth.y - elCmd);
+            double errPt = separationDeg(truth.x, truth.y, azPt, elCmd);
+            st.sumSqAz += errAz*errAz;
+            st.sumSqEl += errEl*errEl;
+            st.sumSqPt += errPt*errPt;
+            st.peakAz = fmax(st.peakAz, errAz);
+            st.peakEl = fmax(st.peakEl, errEl);
+            st.peakPt = fmax(st.peakPt, errPt);
+            if (UTC_ms + CULM_WINDOW_S*1000 >= culm_ms && UTC_ms <= culm_ms + CULM_WINDOW_S*1000)
+                st.peakPtCulm = fmax(st.peakPtCulm, errPt);
+            st.n++;
+        }
+
+        simUs += SIM_TICK_US;
+    }
+    return st;
+}
+
+// Find AOS, culmination & LOS of the pass around t_ms by scanning elevation at 1 s
+static void findPass(Orbit& orb, const ObserverFrame& obs, uint64_t t_ms, uint64_t& aos, uint64_t& culm,
+                     uint64_t& los, double& maxEl) {
+    OrbitTracker tracker;
+    tracker.init(orb);
+    Vec3 aer, rates;
+    aos = los = culm = 0;
+    maxEl = -90;
+    for (uint64_t t = t_ms - 900000; t <= t_ms + 900000; t += 1000) {
+        lookWithRates(tracker, obs, t, aer, rates);
+        if (aer.y > 0 && !aos) aos = t;
+        if (aer.y > 0) los = t;
+        if (aer.y > maxEl) { maxEl = aer.y; culm = t; }
+    }
+}
+
+int main() {
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    OrbitTracker tracker;
+    tracker.init(orb);
+
+    // Put the observer beside the ground track at a chosen time, at increasing cross-track offsets
+    uint64_t t_ms = uint64_t(BENCH_TLE_EPOCH_UNIX + 3*3600) * 1000;
+    Vec3 posECI, velECI;
+    tracker.update(t_ms, posECI, velECI);
+    Vec3 sub = ecef2lla(tracker.eci2ecef(posECI), DEGREES);
+
+    printf("%-18s %8s | %-24s | %-24s | %-24s | %10s\n", "pass", "mode", "az lag rms / peak [deg]",
+           "el lag rms / peak [deg]", "pointing rms / peak [deg]", "culm peak");
+    int failures = 0;
+    for (double offset : {0.3, 1.5, 6.0}) {
+        ObserverFrame obs;
+        obs.init(Vec3{sub.x + offset, sub.y, 0}, DEGREES);
+        uint64_t aos, culm, los;
+        double maxEl;
+        findPass(orb, obs, t_ms, aos, culm, los, maxEl);
+
+        char name[32];
+        snprintf(name, sizeof(name), "max el %.1f", maxEl);
+        double rmsPt[2];
+        for (int ff = 0; ff <= 1; ++ff) {
+            LagStats st = simulatePass(orb, obs, aos, los, culm, ff);
+            rmsPt[ff] = sqrt(st.sumSqPt / st.n);
+            printf("%-18s %8s | %10.3f / %10.3f | %10.3f / %10.3f | %10.3f / %10.3f | %10.3f\n",
+                   ff ? "" : name, ff ? "feed-fwd" : "step", sqrt(st.sumSqAz / st.n), st.peakAz,
+                   sqrt(st.sumSqEl / st.n), st.peakEl, rmsPt[ff], st.peakPt, st.peakPtCulm);
+        }
+        failures += rmsPt[1] >= rmsPt[0];
+    }
+
+    if (failures) printf("\nfeed-forward did not reduce RMS pointing lag on %d pass(es)\n", failures);
+    return failures ? 1 : 0;
+}
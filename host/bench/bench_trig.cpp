@@ -0,0 +1,187 @@
+/*
+  bench_trig.cpp - Error harness & per-function timings for the fast_math.h kernels
+    Built twice with its own copies of the coordinate & orbit sources: bench_trig with FAST_TRIG=1, so the pipeline
+    section runs the math core on the kernels, and bench_trig_libm as the libm baseline for that section. Errors
+    are against long double libm, in units of the last place of the result type, over dense random samples.
+ */
+#include <limits>
+#include <random>
+#include "bench.h"
+#include "orbit_utils.h"
+
+#define N_SAMPLES   (1 << 24)
+
+// Units in the last place of v in type T
+template <typename T>
+static long double ulpOf(long double v) {
+    T a = fabs(T(v));
+    if (a == 0) a = std::numeric_limits<T>::denorm_min();
+    return (long double)nextafter(a, T(INFINITY)) - (long double)a;
+}
+
+struct ErrStats {
+    long double maxUlp, maxAbs;
+    double worstX;
+
+    void add(long double got, long double ref, double x, long double ulp) {
+        long double e = fabsl(got - ref);
+        if (e > maxAbs) maxAbs = e;
+        if (e / ulp > maxUlp) { maxUlp = e / ulp; worstX = x; }
+    }
+};
+
+static void printErr(const char* name, const ErrStats& s) {
+    printf("%-34s %8.3f ulp %12.3Le abs   (worst at %.17g)\n", name, double(s.maxUlp), s.maxAbs, s.worstX);
+}
+
+// sin & cos of T over [-range, range], fast kernel & libm side by side
+template <typename T>
+static int sinCosErr(const char* label, double range, double tolUlp, double tolAbs) {
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> dist(-range, range);
+    ErrStats fs = {}, fc = {}, ls = {}, lc = {};
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        T x = T(dist(rng));
+        long double rs = sinl((long double)x), rc = cosl((long double)x);
+        T s, c;
+        fastSinCos(x, s, c);
+        fs.add(s, rs, x, ulpOf<T>(rs));
+        fc.add(c, rc, x, ulpOf<T>(rc));
+        ls.add(T(sin(x)), rs, x, ulpOf<T>(rs));
+        lc.add(T(cos(x)), rc, x, ulpOf<T>(rc));
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s sin, |x| <= %g", label, range);
+    printErr(name, fs);
+    snprintf(name, sizeof(name), "%s cos, |x| <= %g", label, range);
+    printErr(name, fc);
+    snprintf(name, sizeof(name), "  libm sin / cos");
+    printErr(name, ls.maxUlp > lc.maxUlp ? ls : lc);
+    return fs.maxUlp > tolUlp || fc.maxUlp > tolUlp || fs.maxAbs > tolAbs || fc.maxAbs > tolAbs;
+}
+
+// atan2 of T over all directions & radii 1e-6 .. 1e8
+template <typename T>
+static int atan2Err(const char* label, double tolUlp, double tolAbs) {
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> ang(-PI, PI), lr(-6, 8);
+    ErrStats f = {}, l = {};
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        double r = pow(10., lr(rng)), th = ang(rng);
+        T y = T(r * sin(th)), x = T(r * cos(th));
+        if (i < 8) { y = (i & 1) ? T(0) : T(i - 4); x = (i & 2) ? T(0) : T(3 - i); }   // Axes & diagonals
+        long double ref = atan2l((long double)y, (long double)x);
+        f.add(fastAtan2(y, x), ref, double(y) / double(x), ulpOf<T>(ref));
+        l.add(T(atan2(y, x)), ref, double(y) / double(x), ulpOf<T>(ref));
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s atan2", label);
+    printErr(name, f);
+    printErr("  libm atan2", l);
+    return f.maxUlp > tolUlp || f.maxAbs > tolAbs;
+}
+
+// Propagation + pointing on the kernels vs the long double libm instantiation of the same templates
+static int pipelineErr() {
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    OrbitT<long double> ref;
+    ref.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    Vec3 lla = {42.36, -71.06, 0};
+    ObserverFrame obs;
+    obs.init(lla, DEGREES);
+    ObserverFrameT<long double> obsRef;
+    obsRef.init(lla, DEGREES);
+
+    double maxPos = 0, maxVel = 0, maxAng = 0;
+    for (int t = 0; t < 7 * 86400; t += 10) {
+        Vec3 pos, vel;
+        Vec3T<long double> posRef, velRef;
+        orb.calcPosVelECI(double(t), pos, vel);
+        ref.calcPosVelECI((long double)t, posRef, velRef);
+        maxPos = fmax(maxPos, norm(pos - Vec3(posRef)));
+        maxVel = fmax(maxVel, norm(vel - Vec3(velRef)));
+
+        double era = fmod(t * EARTH_ROT_RATE, TWO_PI);
+        Vec3 aer = obs.lookAngles(eci2ecef(pos, era));
+        Vec3 aerRef = Vec3(obsRef.lookAngles(eci2ecef(posRef, (long double)era)));
+        if (aerRef.y > -10) {
+            double dAz = fabs(aer.x - aerRef.x);
+            maxAng = fmax(maxAng, fmin(dAz, 360 - dAz) * cos(aerRef.y * DEG_TO_RAD));
+            maxAng = fmax(maxAng, fabs(aer.y - aerRef.y));
+        }
+    }
+    printf("\nOne week at 10 s, FAST_TRIG=%d vs long double libm through the same templates\n", int(FAST_TRIG));
+    printf("  calcPosVelECI max |dpos| %.3e m, |dvel| %.3e m/s; look angles max %.3e deg\n", maxPos, maxVel, maxAng);
+    return maxPos > 1e-5 || maxAng > 1e-9;
+}
+
+int main() {
+    int failures = 0;
+    printf("%d samples per row, errors vs long double libm\n", N_SAMPLES);
+    // Bounds as documented in fast_math.h. Near the zeros of sin & cos at large |x| the float reduction's
+    // absolute error (~|k| 2^-48) is many ulps of the tiny result, so only the absolute bound applies there
+    failures += sinCosErr<double>("fastSinCos<double>", PI, 2.0, 2e-16);
+    failures += sinCosErr<double>("fastSinCos<double>", 1024, 2.0, 2e-16);
+    failures += sinCosErr<float>("fastSinCos<float>", PI, 2.0, 8e-8);
+    failures += sinCosErr<float>("fastSinCos<float>", 1024, 1e6, 8e-8);
+    failures += atan2Err<double>("fastAtan2<double>", 3.0, 6e-16);
+    failures += atan2Err<float>("fastAtan2<float>", 3.0, 3.2e-7);
+    failures += pipelineErr();
+
+    // Per-call timings over a ring of varied arguments
+    const int nArg = 4096;
+    static double xd[nArg], yd[nArg];
+    static float xf[nArg], yf[nArg];
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> dist(-PI, PI);
+    for (int i = 0; i < nArg; ++i) {
+        xd[i] = dist(rng) * 8;
+        yd[i] = dist(rng);
+        xf[i] = float(xd[i]);
+        yf[i] = float(yd[i]);
+    }
+    const uint64_t N = 4000000;
+    printf("\n");
+    benchReportCycles("sin + cos (libm)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(sin(xd[i % nArg]) + cos(xd[(i + 1) % nArg]));
+    }));
+    benchReportCycles("fastSinCos<double>", benchNs(N, [&](uint64_t i) {
+        double s, c;
+        fastSinCos(xd[i % nArg], s, c);
+        doNotOptimize(s + c);
+    }));
+    benchReportCycles("atan2 (libm)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(atan2(yd[i % nArg], xd[i % nArg]));
+    }));
+    benchReportCycles("fastAtan2<double>", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(fastAtan2(yd[i % nArg], xd[i % nArg]));
+    }));
+    benchReportCycles("sinf + cosf (libm)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(sinf(xf[i % nArg]) + cosf(xf[(i + 1) % nArg]));
+    }));
+    benchReportCycles("fastSinCos<float>", benchNs(N, [&](uint64_t i) {
+        float s, c;
+        fastSinCos(xf[i % nArg], s, c);
+        doNotOptimize(s + c);
+    }));
+    benchReportCycles("atan2f (libm)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(atan2f(yf[i % nArg], xf[i % nArg]));
+    }));
+    benchReportCycles("fastAtan2<float>", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(fastAtan2(yf[i % nArg], xf[i % nArg]));
+    }));
+
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrame obs;
+    obs.init(Vec3{42.36, -71.06, 0}, DEGREES);
+    benchReportCycles("calcPosVelECI + look angles", benchNs(N / 10, [&](uint64_t i) {
+        Vec3 pos, vel;
+        orb.calcPosVelECI(double(i % 5400), pos, vel);
+        doNotOptimize(obs.lookAngles(eci2ecef(pos, double(i) * 1e-4)));
+    }));
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
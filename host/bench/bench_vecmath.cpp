@@ -0,0 +1,123 @@
+/*
+  bench_vecmath.cpp - Header-only constexpr Vec3/Dcm vs the previous out-of-line by-value operators
+    The legacy types below reproduce the old math_utils.cpp: every operator a separate call taking its operands by
+    value, operator[] a branch chain and eci2ecef building a full DCM. Kernels are noinline so each is one symbol
+    to inspect with objdump -d --no-show-raw-insn.
+ */
+#include "bench.h"
+#include "coord.h"
+#include "orbit_utils.h"
+
+// Previous math_utils.cpp, kept out of line
+struct LegacyDcm { double x00, x10, x20, x01, x11, x21, x02, x12, x22; };
+struct LegacyVec3 { double x, y, z; };
+
+__attribute__((noinline)) static LegacyVec3 operator-(LegacyVec3 a, LegacyVec3 b) {
+    return LegacyVec3{a.x-b.x,a.y-b.y,a.z-b.z};
+}
+__attribute__((noinline)) static LegacyVec3 operator*(LegacyDcm d, LegacyVec3 v) {
+    return LegacyVec3 {
+        v.x*d.x00 + v.y*d.x01 + v.z*d.x02,
+        v.x*d.x10 + v.y*d.x11 + v.z*d.x12,
+        v.x*d.x20 + v.y*d.x21 + v.z*d.x22,
+    };
+}
+__attribute__((noinline)) static double legacyIndex(LegacyVec3& v, uint8_t i) {
+    if (i == 0) return v.x;
+    if (i == 1) return v.y;
+    else return v.z;
+}
+
+__attribute__((noinline)) static LegacyVec3 legacyEci2ecef(LegacyVec3 eci, double angle) {
+    LegacyDcm eci2ecef = {cos(angle), sin(angle), 0, -sin(angle), cos(angle), 0, 0, 0, 1};
+    return eci2ecef * eci;
+}
+__attribute__((noinline)) static LegacyVec3 legacyEcef2ned(const LegacyDcm& C, const LegacyVec3& ref,
+                                                           const LegacyVec3& ecef) {
+    return C * (ecef - ref);
+}
+
+// Current header-only forms
+__attribute__((noinline)) static Vec3 newEci2ecef(const Vec3& eci, double angle) { return eci2ecef(eci, angle); }
+__attribute__((noinline)) static Vec3 newEcef2ned(const ObserverFrame& obs, const Vec3& ecef) {
+    return obs.ecef2ned(ecef);
+}
+__attribute__((noinline)) static double newIndex(const Vec3& v, uint8_t i) { return v[i]; }
+
+// Fully folded at compile time
+constexpr Dcm swapXY = {{0, 1, 0, 1, 0, 0, 0, 0, 1}};
+constexpr Vec3 folded = mulDiff(swapXY * swapXY.transpose(), Vec3{1, 2, 3}, Vec3{1, 1, 1});
+static_assert(folded.x == 0 && folded.y == 1 && folded.z == 2 && folded[2] == 2, "constexpr Vec3/Dcm");
+
+int main() {
+    Orbit orb;
+    orb.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    ObserverFrame obs;
+    obs.init(Vec3{42.36, -71.06, 0}, DEGREES);
+    LegacyDcm legacyC;
+    memcpy(&legacyC, &obs.C, sizeof(legacyC));
+    LegacyVec3 legacyRef = {obs.ecef.x, obs.ecef.y, obs.ecef.z};
+
+    const size_t nPts = 1024;
+    static Vec3 eci[nPts], ecef[nPts], out[nPts];
+    static LegacyVec3 legacyEci[nPts], legacyEcef[nPts];
+    static double era[nPts];
+    for (size_t i = 0; i < nPts; ++i) {
+        Vec3 vel;
+        orb.calcPosVelECI(double(i) * 5.0, eci[i], vel);
+        era[i] = (orb.epoch + int64_t(i) * 5 * NS_PER_SEC).era();
+        ecef[i] = eci2ecef(eci[i], era[i]);
+        legacyEci[i] = LegacyVec3{eci[i].x, eci[i].y, eci[i].z};
+        legacyEcef[i] = LegacyVec3{ecef[i].x, ecef[i].y, ecef[i].z};
+    }
+
+    // Both forms must agree to rounding; FMA contraction may differ between them under -march=native
+    double maxDiff = 0;
+    int failures = 0;
+    for (size_t i = 0; i < nPts; ++i) {
+        LegacyVec3 a = legacyEci2ecef(legacyEci[i], era[i]);
+        Vec3 b = newEci2ecef(eci[i], era[i]);
+        LegacyVec3 c = legacyEcef2ned(legacyC, legacyRef, legacyEcef[i]);
+        Vec3 d = newEcef2ned(obs, ecef[i]);
+        maxDiff = fmax(maxDiff, norm(Vec3{a.x, a.y, a.z} - b));
+        maxDiff = fmax(maxDiff, norm(Vec3{c.x, c.y, c.z} - d));
+        failures += legacyIndex(legacyEci[i], i % 3) != newIndex(eci[i], i % 3);
+    }
+    mulDiff(obs.C, ecef, obs.ecef, out, nPts);
+    for (size_t i = 0; i < nPts; ++i)
+        maxDiff = fmax(maxDiff, norm(out[i] - obs.ecef2ned(ecef[i])));
+    failures += maxDiff > 1e-6;
+    printf("max legacy vs header-only difference: %.3e m\n\n", maxDiff);
+
+    const uint64_t N = 2000000;
+    benchReportCycles("eci2ecef (legacy)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(legacyEci2ecef(legacyEci[i % nPts], era[i % nPts]));
+    }));
+    benchReportCycles("eci2ecef", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(newEci2ecef(eci[i % nPts], era[i % nPts]));
+    }));
+    benchReportCycles("ecef2ned (legacy)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(legacyEcef2ned(legacyC, legacyRef, legacyEcef[i % nPts]));
+    }));
+    benchReportCycles("ecef2ned", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(newEcef2ned(obs, ecef[i % nPts]));
+    }));
+    benchReportCycles("operator[] (legacy)", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(legacyIndex(legacyEci[i % nPts], i % 3));
+    }));
+    benchReportCycles("operator[]", benchNs(N, [&](uint64_t i) {
+        doNotOptimize(newIndex(eci[i % nPts], i % 3));
+    }));
+
+    // Whole array through one DCM, per vector
+    benchReportCycles("ecef2ned x1024 loop, per vec", benchNs(2000, [&](uint64_t) {
+        for (size_t i = 0; i < nPts; ++i) out[i] = obs.ecef2ned(ecef[i]);
+        doNotOptimize(out[0]);
+    }) / nPts);
+    benchReportCycles("ecef2ned x1024 batch, per vec", benchNs(2000, [&](uint64_t) {
+        mulDiff(obs.C, ecef, obs.ecef, out, nPts);
+        doNotOptimize(out[0]);
+    }) / nPts);
+
+    return failures ? 1 : 0;
+}
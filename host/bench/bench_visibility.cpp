@@ -0,0 +1,114 @@
+/*
+  bench_visibility.cpp - Catalog visibility screening throughput from 1 to N threads
+    Screens a synthetic catalog for "visible now" and "visible in the next 30 min" from one site. Every thread
+    count must reproduce the serial brute-force scan exactly. Thread counts go past the core count so the
+    stealing path gets exercised even on small machines; rows beyond hardware_concurrency can't speed up.
+ */
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "visibility.h"
+
+// Random but physically plausible orbits around the sample TLE epoch, as in bench_batch
+static std::vector<Orbit> makeCatalog(size_t count, uint32_t seed) {
+    Orbit base{};
+    base.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<Orbit> cat(count, base);
+    for (Orbit& o : cat) {
+        o.incl  = u(rng) * PI;
+        o.Omega = u(rng) * TWO_PI;
+        o.omega = u(rng) * TWO_PI;
+        o.M0    = u(rng) * TWO_PI;
+        o.ecc   = u(rng) < 0.9 ? u(rng) * 0.02 : u(rng) * 0.75;
+        o.n     = (1. + u(rng) * 15.) * TWO_PI / SECONDS_PER_DAY;
+        o.a     = pow(MU_EARTH / (o.n*o.n), 1./3.);
+        o.epoch = base.epoch - int64_t(u(rng) * 3. * NS_PER_DAY);
+    }
+    return cat;
+}
+
+// Serial reference: one lookAngles chain per sample, no tiles, ERA evaluated per sample
+static void bruteForce(std::vector<Orbit>& cat, const VisibilityQuery& q, std::vector<VisibleInterval>& out) {
+    ObserverFrame obs;
+    obs.init(q.lla, DEGREES);
+    out.clear();
+    for (uint32_t s = 0; s < cat.size(); ++s) {
+        bool up = false;
+        for (uint32_t k = 0; k <= q.nSteps; ++k) {
+            bool vis = false;
+            float el = 0;
+            if (k < q.nSteps) {
+                UtcTime t = q.start + int64_t(k) * q.step_ns;
+                Vec3 posECI;
+                cat[s].calcPosECI_UTC(t, posECI);
+                el = float(obs.lookAngles(eci2ecef(posECI, -t.era())).y);
+                vis = el > q.elMaskDeg;
+            }
+            if (vis && !up) out.push_back(VisibleInterval{s, k, 0, el});
+            if (vis) out.back().maxEl = fmax(out.back().maxEl, el);
+            if (!vis && up) out.back().end = k;
+            up = vis;
+        }
+    }
+}
+
+static bool sameIntervals(const std::vector<VisibleInterval>& a, const std::vector<VisibleInterval>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].sat != b[i].sat || a[i].begin != b[i].begin || a[i].end != b[i].end
+            || fabs(a[i].maxEl - b[i].maxEl) > 1e-4f) return false;
+    return true;
+}
+
+int main() {
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned maxThreads = hw > 8 ? hw : 8;
+    std::vector<unsigned> threadCounts;
+    for (unsigned nt = 1; nt < maxThreads; nt *= 2) threadCounts.push_back(nt);
+    threadCounts.push_back(maxThreads);
+    printf("hardware_concurrency %u\n", hw);
+
+    const Vec3 site = {42.36, -71.06, 0};
+    Orbit base{};
+    base.initFromTLE(BENCH_TLE_LINE1, BENCH_TLE_LINE2);
+    VisibilityQuery queries[] = {
+        {site, base.epoch + 3600 * NS_PER_SEC, 30 * NS_PER_SEC, 1, 10.},      // Right now
+        {site, base.epoch + 3600 * NS_PER_SEC, 30 * NS_PER_SEC, 60, 10.},     // Next 30 min at 30 s
+    };
+
+    int failures = 0;
+    for (uint32_t count : {10000u, 20000u}) {
+        std::vector<Orbit> cat = makeCatalog(count, 1234);
+        for (const VisibilityQuery& q : queries) {
+            std::vector<VisibleInterval> ref, got;
+            bruteForce(cat, q, ref);
+            printf("\n%u objects x %u step(s): %zu visible intervals\n", count, q.nSteps, ref.size());
+            printf("%8s %12s %14s %9s %8s %s\n", "threads", "ms/query", "Mprop/s", "speedup", "stolen", "match");
+
+            double t1 = 0;
+            for (unsigned nt : threadCounts) {
+                WorkStealingPool pool(nt);
+                VisibilityScreen vs;
+                vs.begin(cat.data(), count, pool);
+                vs.screen(q, got);
+                bool match = sameIntervals(ref, got);
+                failures += !match;
+
+                uint64_t reps = 4000000 / (uint64_t(count) * q.nSteps) + 1;
+                double ns = benchNs(reps, [&](uint64_t) { vs.screen(q, got); });
+                if (nt == 1) t1 = ns;
+                uint32_t stolen = 0;
+                for (unsigned w = 0; w < nt; ++w) stolen += pool.tasksStolen(w);
+                printf("%8u %12.3f %14.2f %8.2fx %8u %s\n", nt, ns / 1e6, double(count) * q.nSteps / ns * 1e3,
+                       t1 / ns, stolen, match ? "yes" : "NO");
+            }
+        }
+    }
+
+    if (failures) printf("\n%d check(s) FAILED\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+/*
+  op_count.h - Scalar wrapper counting the math core's ops, and assumed Cortex-M0+ cycles per op
+    The host has an FPU, so host timings say little about the M0. Instantiating a templated routine on
+    Counted<T> counts its scalar ops, and m0Cycles() prices those counts with the soft-float / integer cost
+    table below to estimate M0+ cycles per call.
+ */
+#pragma once
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "orbit_utils.h"
+
+enum OpKind { OP_ADD, OP_MUL, OP_DIV, OP_SQRT, OP_SINCOS, OP_ATAN2, OP_FMOD, OP_CBRT, OP_N };
+static const char* const opNames[OP_N] = {"add", "mul", "div", "sqrt", "sin/cos", "atan2", "fmod", "cbrt"};
+static uint32_t opCount[OP_N];
+
+template <typename T>
+struct Counted {
+    T v;
+
+    Counted() = default;
+    Counted(int i) : v(T(i)) {}
+    Counted(double d) : v(T(d)) {}
+    static Counted wrap(T t) { Counted c; c.v = t; return c; }
+    explicit operator double() const { return double(v); }
+
+    friend Counted operator+(Counted a, Counted b) { opCount[OP_ADD]++; return wrap(a.v + b.v); }
+    friend Counted operator-(Counted a, Counted b) { opCount[OP_ADD]++; return wrap(a.v - b.v); }
+    friend Counted operator*(Counted a, Counted b) { opCount[OP_MUL]++; return wrap(a.v * b.v); }
+    friend Counted operator/(Counted a, Counted b) { opCount[OP_DIV]++; return wrap(a.v / b.v); }
+    Counted operator-() const { return wrap(-v); }
+    Counted& operator*=(Counted b) { return *this = *this * b; }
+    friend bool operator>(Counted a, Counted b) { opCount[OP_ADD]++; return a.v > b.v; }
+
+    friend Counted sqrt(Counted a) { opCount[OP_SQRT]++; return wrap(sqrt(a.v)); }
+    friend Counted cbrt(Counted a) { opCount[OP_CBRT]++; return wrap(cbrt(a.v)); }
+    friend Counted sin(Counted a) { opCount[OP_SINCOS]++; return wrap(sin(a.v)); }
+    friend Counted cos(Counted a) { opCount[OP_SINCOS]++; return wrap(cos(a.v)); }
+    friend Counted atan2(Counted y, Counted x) { opCount[OP_ATAN2]++; return wrap(atan2(y.v, x.v)); }
+    friend Counted fmod(Counted a, Counted b) { opCount[OP_FMOD]++; return wrap(fmod(a.v, b.v)); }
+    friend Counted fabs(Counted a) { return wrap(fabs(a.v)); }
+};
+
+template <> struct KeplerTol<Counted<float>> { static Counted<float> value() { return 8 * FLT_EPSILON; } };
+
+// Assumed Cortex-M0+ cycles per op: libgcc/CMSIS soft-float for double & float, the FixedQ code paths for
+// Q-format (4 MULS-based 32x32 partial products, bit-serial division/sqrt, 30-step CORDIC). cbrt is newlib's
+// bit-trick seed plus Newton steps, about two divisions' worth. Rough figures for comparing alternatives,
+// not a substitute for measuring on the board with ENABLE_PROFILING
+enum CostRow { COST_DOUBLE, COST_FLOAT, COST_FIXED };
+static const double m0Cost[3][OP_N] = {
+    //  add   mul   div  sqrt  sin/cos  atan2  fmod  cbrt
+    {  120,  330, 1100, 1700,  9000,  11000, 1500, 3000},  // double
+    {   70,  110,  400,  600,  3000,   4000,  500, 1000},  // float
+    {    6,  100, 1200,  900,  1800,   2000,  400, 2500},  // Q-format int64
+};
+
+// Count the ops of one call of fn into ops[] and return its estimated M0 cycles
+template <typename Fn>
+double countOps(CostRow cost, uint32_t ops[OP_N], Fn&& fn) {
+    memset(opCount, 0, sizeof(opCount));
+    fn();
+    double cycles = 0;
+    for (int k = 0; k < OP_N; ++k) {
+        ops[k] = opCount[k];
+        cycles += opCount[k] * m0Cost[cost][k];
+    }
+    return cycles;
+}
@@ -0,0 +1,34 @@
+/*
+  AccelStepper.h - AccelStepper on the host, backed by the SimStepper model & the shim's virtual clock
+ */
+#pragma once
+#include "Arduino.h"
+#include "sim_stepper.h"
+
+class AccelStepper : public SimStepper {
+public:
+    enum MotorInterfaceType {
+        FUNCTION  = 0,
+        DRIVER    = 1,
+        FULL2WIRE = 2,
+        FULL3WIRE = 3,
+        FULL4WIRE = 4,
+        HALF3WIRE = 6,
+        HALF4WIRE = 8
+    };
+
+    AccelStepper(uint8_t interface = FULL4WIRE, uint8_t pin1 = 2, uint8_t pin2 = 3, uint8_t pin3 = 4,
+                 uint8_t pin4 = 5, bool enable = true) {
+        begin(::micros);
+    }
+
+    // Blocking moves spin the virtual clock until the move completes
+    void runToPosition() {
+        while (run()) delayMicroseconds(20);
+    }
+
+    void runToNewPosition(long position) {
+        moveTo(position);
+        runToPosition();
+    }
+};
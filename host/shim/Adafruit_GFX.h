@@ -0,0 +1,100 @@
+/*
+  Adafruit_GFX.h - Host stand-in for the Adafruit GFX text & primitive API used by the sketch
+    Pixels are rotated & stored as the library does, and characters use the classic 6x8 cell with
+    background fill. Glyph bitmaps are a stand-in pattern rather than the real font; only which cells
+    change matters for transfer accounting.
+ */
+#pragma once
+#include "Arduino.h"
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void setRotation(uint8_t r) {
+        rotation = r & 3;
+        _width = (rotation & 1) ? HEIGHT : WIDTH;
+        _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+    uint8_t getRotation() const { return rotation; }
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t i = x; i < x + w; ++i)
+            for (int16_t j = y; j < y + h; ++j) drawPixel(i, j, color);
+    }
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillRect(x, y, 1, h, color); }
+
+    // Bresenham, stepping along the major axis as the library does
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        int16_t t;
+        if (steep) { t = x0; x0 = y0; y0 = t; t = x1; x1 = y1; y1 = t; }
+        if (x0 > x1) { t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+        int16_t dx = x1 - x0, dy = abs(y1 - y0);
+        int16_t err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; ++x0) {
+            if (steep) drawPixel(y0, x0, color);
+            else drawPixel(x0, y0, color);
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+        for (int8_t i = 0; i < 6; ++i) {
+            uint8_t line = (i < 5 && c != ' ') ? glyphColumn(c, i) : 0;
+            for (int8_t j = 0; j < 8; ++j, line >>= 1) {
+                if (line & 1) fillRect(x + i*size, y + j*size, size, size, color);
+                else if (bg != color) fillRect(x + i*size, y + j*size, size, size, bg);
+            }
+        }
+    }
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    void setTextSize(uint8_t s) { textsize = s ? s : 1; }
+    void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+
+    size_t write(uint8_t c) {
+        if (c == '\n') {
+            cursor_x = 0;
+            cursor_y += textsize * 8;
+        } else if (c != '\r') {
+            drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+            cursor_x += textsize * 6;
+        }
+        return 1;
+    }
+    void print(const char* s) { while (*s) write(*s++); }
+    void println(const char* s = "") { print(s); write('\n'); }
+    void printf(const char* fmt, ...) {
+        char buf[128];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        print(buf);
+    }
+
+protected:
+    const int16_t WIDTH, HEIGHT;    // Native size
+    int16_t _width, _height;        // Rotated size
+    uint8_t rotation = 0;
+    int16_t cursor_x = 0, cursor_y = 0;
+    uint8_t textsize = 1;
+    uint16_t textcolor = 1, textbgcolor = 1;
+
+    static uint8_t glyphColumn(unsigned char c, int8_t i) {
+        return uint8_t((c * 37u + i * 101u) * 2654435761u >> 25) & 0x7F;
+    }
+};
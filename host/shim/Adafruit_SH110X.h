@@ -0,0 +1,67 @@
+/*
+  Adafruit_SH110X.h - Host stand-in for the SH1107 OLED driver
+    Keeps the library's page-major 1 bpp buffer. display() sends the whole frame over the Wire stub with the
+    library's framing (page & column address, then data in 31-byte chunks), which is what it transfers after
+    clearDisplay() marks the full window dirty.
+ */
+#pragma once
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SH110X_BLACK    0
+#define SH110X_WHITE    1
+#define SH110X_INVERSE  2
+
+class Adafruit_SH1107 : public Adafruit_GFX {
+public:
+    Adafruit_SH1107(uint16_t w, uint16_t h, TwoWire* twi) : Adafruit_GFX(w, h), wire(twi) {
+        memset(buffer, 0, sizeof(buffer));
+    }
+
+    bool begin(uint8_t addr = 0x3C, bool = true) {
+        i2caddr = addr;
+        return true;
+    }
+    uint8_t* getBuffer() { return buffer; }
+    void clearDisplay() { memset(buffer, 0, sizeof(buffer)); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || y < 0 || x >= width() || y >= height()) return;
+        int16_t t;
+        switch (rotation) {
+        case 1: t = x; x = WIDTH - 1 - y; y = t; break;
+        case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+        case 3: t = x; x = y; y = HEIGHT - 1 - t; break;
+        }
+        uint8_t& b = buffer[x + (y / 8) * WIDTH];
+        uint8_t bit = 1 << (y & 7);
+        if (color == SH110X_WHITE) b |= bit;
+        else if (color == SH110X_BLACK) b &= ~bit;
+        else b ^= bit;
+    }
+
+    void display() {
+        wire->setClock(400000);
+        for (int16_t p = 0; p < HEIGHT / 8; ++p) {
+            wire->beginTransmission(i2caddr);
+            wire->write(0x00);
+            wire->write(0xB0 | p);
+            wire->write(0x10);
+            wire->write(0x00);
+            wire->endTransmission();
+            for (int16_t c = 0; c < WIDTH; c += 31) {
+                int16_t n = WIDTH - c < 31 ? WIDTH - c : 31;
+                wire->beginTransmission(i2caddr);
+                wire->write(0x40);
+                wire->write(buffer + p * WIDTH + c, n);
+                wire->endTransmission();
+            }
+        }
+        wire->setClock(100000);
+    }
+
+private:
+    TwoWire* wire;
+    uint8_t i2caddr = 0x3C;
+    uint8_t buffer[64 * 128 / 8];
+};
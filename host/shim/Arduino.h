@@ -0,0 +1,70 @@
+/*
+  Arduino.h - Minimal Arduino compatibility shim for building the math core natively on the host
+    Only provides the constants, types and helpers used by the sketch sources. Not a full Arduino core.
+    Time comes from a virtual clock that simulations advance explicitly, so millis()/micros() wrap like on target.
+ */
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <cstdlib>
+
+// Pull in floating-point overloads so abs(float) doesn't silently truncate to int
+using std::abs;
+
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+typedef uint8_t byte;
+typedef unsigned int word;
+
+inline word makeWord(uint8_t h, uint8_t l) { return (word(h) << 8) | l; }
+#define word(...) makeWord(__VA_ARGS__)
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define sq(x) ((x)*(x))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// Analog pin numbers as on the Feather M0
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+// Virtual clock [us], starts at 0 and only moves when advanced
+extern uint64_t hostClockUs;
+
+inline uint32_t millis() { return uint32_t(hostClockUs / 1000); }
+inline uint32_t micros() { return uint32_t(hostClockUs); }
+inline void delay(uint32_t ms) { hostClockUs += uint64_t(ms) * 1000; }
+inline void delayMicroseconds(uint32_t us) { hostClockUs += us; }
+
+// Serial sink. printf is echoed to stdout when enabled, print/println are discarded
+struct HostSerial {
+    bool echo;
+
+    void begin(unsigned long) {}
+    explicit operator bool() const { return true; }
+    template <typename... Args> void print(Args...) {}
+    template <typename... Args> void println(Args...) {}
+    void printf(const char* fmt, ...) {
+        if (!echo) return;
+        va_list args;
+        va_start(args, fmt);
+        vprintf(fmt, args);
+        va_end(args);
+    }
+};
+extern HostSerial Serial;
@@ -0,0 +1,47 @@
+/*
+  Servo.h - Host model of a hobby servo: pulse width sets a target angle that is reached at a finite slew rate
+    Pulse-to-angle follows the sketch's calibration (SERVO_MIN_PWM..SERVO_MAX_PWM -> 0..180 deg).
+ */
+#pragma once
+#include "Arduino.h"
+#include "defs.h"
+
+#define SERVO_SLEW_DEG_S    400.0   // Micro servo no-load speed, ~0.15 s/60 deg
+#define MIN_PULSE_WIDTH     544     // Arduino Servo library mapping for write(angle)
+#define MAX_PULSE_WIDTH     2400
+
+class Servo {
+public:
+    int pin = -1;
+    int pulseUs = 1500;
+    double fromDeg = 90, toDeg = 90;
+    uint64_t t0Us = 0;
+
+    uint8_t attach(int p) { pin = p; return 0; }
+    bool attached() const { return pin >= 0; }
+
+    // Angles below the pulse range are degrees, as in the Arduino library
+    void write(int value) {
+        if (value < MIN_PULSE_WIDTH) {
+            value = constrain(value, 0, 180);
+            value = int(map(value, 0, 180, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH));
+        }
+        writeMicroseconds(value);
+    }
+
+    void writeMicroseconds(int us) {
+        fromDeg = angle();
+        t0Us = hostClockUs;
+        pulseUs = us;
+        toDeg = constrain((us - SERVO_MIN_PWM) * 180.0 / (SERVO_MAX_PWM - SERVO_MIN_PWM), 0.0, 180.0);
+    }
+
+    int readMicroseconds() const { return pulseUs; }
+
+    // Physical horn angle now [deg]
+    double angle() const {
+        double travel = SERVO_SLEW_DEG_S * double(hostClockUs - t0Us) * 1e-6;
+        if (fabs(toDeg - fromDeg) <= travel) return toDeg;
+        return fromDeg + (toDeg > fromDeg ? travel : -travel);
+    }
+};
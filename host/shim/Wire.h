@@ -0,0 +1,54 @@
+/*
+  Wire.h - I2C stub for host builds
+    Transactions are not delivered anywhere, but their bytes are counted and the time they would hold the
+    bus (9 clocks per byte including the address, plus start & stop) is added to the virtual clock.
+    An optional sink sees each completed transaction, e.g. to model the device on the other end.
+ */
+#pragma once
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LEN 256
+
+typedef void (*WireSink)(void* ctx, uint8_t addr, const uint8_t* data, uint32_t len);
+
+struct TwoWire {
+    uint32_t clockHz;
+    uint8_t txAddr;
+    uint8_t txBuf[WIRE_BUFFER_LEN];
+    uint32_t txLen;         // Bytes queued in the open transaction, including the address
+    WireSink sink;
+    void* sinkCtx;
+    uint32_t nBytes;        // Totals including address bytes
+    uint32_t nTransfers;
+    double busUs;           // Total time the bus was held
+    double carryUs;         // Fraction not yet applied to the virtual clock
+
+    void begin() { clockHz = 100000; }
+    void setClock(uint32_t hz) { clockHz = hz; }
+    void beginTransmission(uint8_t addr) { txAddr = addr; txLen = 1; }
+    size_t write(uint8_t b) {
+        if (txLen > WIRE_BUFFER_LEN) return 0;
+        txBuf[txLen++ - 1] = b;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (!write(data[i])) return i;
+        }
+        return n;
+    }
+    uint8_t endTransmission(bool = true) {
+        if (sink) sink(sinkCtx, txAddr, txBuf, txLen - 1);
+        double us = (txLen * 9 + 2) * 1e6 / (clockHz ? clockHz : 100000);
+        nBytes += txLen;
+        nTransfers++;
+        busUs += us;
+        carryUs += us;
+        hostClockUs += uint64_t(carryUs);
+        carryUs -= uint64_t(carryUs);
+        txLen = 0;
+        return 0;
+    }
+    void resetStats() { nBytes = 0; nTransfers = 0; busUs = 0; }
+};
+extern TwoWire Wire;
@@ -0,0 +1,9 @@
+/*
+  arduino_shim.cpp - Global state behind the host Arduino shim
+ */
+#include "Arduino.h"
+#include "Wire.h"
+
+uint64_t hostClockUs = 0;
+HostSerial Serial = {false};
+TwoWire Wire;
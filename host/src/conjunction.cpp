@@ -0,0 +1,190 @@
+/*
+  conjunction.cpp - Hash-grid conjunction screening & closest-approach refinement
+ */
+#include <algorithm>
+#include "conjunction.h"
+
+#define CELL_BIAS   (1 << 20)   // Cell coordinates are biased to 21-bit unsigned fields of the key
+
+// Forward half of the 26 neighbours, so every pair of cells is visited once
+static const int8_t halfStencil[13][3] = {
+    {1, -1, -1}, {1, -1, 0}, {1, -1, 1}, {1, 0, -1}, {1, 0, 0}, {1, 0, 1}, {1, 1, -1}, {1, 1, 0}, {1, 1, 1},
+    {0, 1, -1}, {0, 1, 0}, {0, 1, 1}, {0, 0, 1},
+};
+
+static inline uint64_t cellKey(int32_t ix, int32_t iy, int32_t iz) {
+    return uint64_t(ix + CELL_BIAS) << 42 | uint64_t(iy + CELL_BIAS) << 21 | uint64_t(iz + CELL_BIAS);
+}
+
+// Multiplicative hash of a cell key into a power-of-two table
+static inline uint32_t cellSlot(uint64_t key, uint32_t mask) {
+    return uint32_t((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+void ConjunctionScreen::begin(Orbit* _cat, uint32_t _count) {
+    cat = _cat;
+    count = _count;
+    vmax = 0;
+    gmax = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Orbit& o = cat[i];
+        double rp = o.a * (1 - o.ecc);
+        vmax = fmax(vmax, sqrt(MU_EARTH * (1 + o.ecc) / rp));
+        gmax = fmax(gmax, MU_EARTH / (rp * rp));
+    }
+    pos.resize(count);
+    vel.resize(count);
+    next.resize(count);
+    uint32_t size = 1;
+    while (size < 2 * count) size <<= 1;
+    cells.resize(size);
+}
+
+// Slot holding key, or -1
+int32_t ConjunctionScreen::findCell(uint64_t key) const {
+    uint32_t mask = uint32_t(cells.size() - 1);
+    for (uint32_t h = cellSlot(key, mask);; h = (h + 1) & mask) {
+        if (cells[h].head < 0) return -1;
+        if (cells[h].key == key) return int32_t(h);
+    }
+}
+
+// Keep a pair if it's within radius now and its straight-line approach within half a step gets inside reach
+inline void ConjunctionScreen::testPair(uint32_t i, uint32_t j, uint32_t step) {
+    nPairTests++;
+    Vec3 dr = pos[i] - pos[j];
+    double r2 = dot(dr, dr);
+    if (r2 >= radius * radius) return;
+    Vec3 dv = vel[i] - vel[j];
+    double v2 = dot(dv, dv);
+    double tau = v2 > 0 ? -dot(dr, dv) / v2 : 0;
+    tau = constrain(tau, -halfStep, halfStep);
+    Vec3 d = dr + dv * tau;
+    if (dot(d, d) >= reach * reach) return;
+    candidates.push_back(Candidate{std::min(i, j), std::max(i, j), step});
+}
+
+// Bin this step's positions into radius-sized cells & test the pairs in the same or adjacent cells
+void ConjunctionScreen::gridPairs(uint32_t step) {
+    uint32_t mask = uint32_t(cells.size() - 1);
+    for (uint32_t h : usedCells) cells[h].head = -1;
+    usedCells.clear();
+
+    double inv = 1 / radius;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t key = cellKey(int32_t(floor(pos[i].x * inv)), int32_t(floor(pos[i].y * inv)),
+                               int32_t(floor(pos[i].z * inv)));
+        uint32_t h = cellSlot(key, mask);
+        while (cells[h].head >= 0 && cells[h].key != key) h = (h + 1) & mask;
+        if (cells[h].head < 0) {
+            cells[h].key = key;
+            usedCells.push_back(h);
+        }
+        next[i] = cells[h].head;
+        cells[h].head = int32_t(i);
+    }
+
+    for (uint32_t h : usedCells) {
+        uint64_t key = cells[h].key;
+        // Within the cell
+        for (int32_t i = cells[h].head; i >= 0; i = next[i]) {
+            for (int32_t j = next[i]; j >= 0; j = next[j]) testPair(uint32_t(i), uint32_t(j), step);
+        }
+        // Against the forward neighbours
+        int32_t ix = int32_t(key >> 42) - CELL_BIAS, iy = int32_t((key >> 21) & 0x1FFFFF) - CELL_BIAS,
+                iz = int32_t(key & 0x1FFFFF) - CELL_BIAS;
+        for (const int8_t* o : halfStencil) {
+            int32_t nh = findCell(cellKey(ix + o[0], iy + o[1], iz + o[2]));
+            if (nh < 0) continue;
+            for (int32_t i = cells[h].head; i >= 0; i = next[i]) {
+                for (int32_t j = cells[nh].head; j >= 0; j = next[j]) testPair(uint32_t(i), uint32_t(j), step);
+            }
+        }
+    }
+}
+
+// Reference O(N^2) pair test
+void ConjunctionScreen::allPairs(uint32_t step) {
+    for (uint32_t i = 0; i < count; ++i)
+        for (uint32_t j = i + 1; j < count; ++j) testPair(i, j, step);
+}
+
+// Closest approach of a & b in [lo, hi], where the range rate must go from closing to opening.
+// Illinois variant of regula falsi on dot(dr, dv), which keeps the bracket & converges superlinearly
+bool ConjunctionScreen::refine(uint32_t a, uint32_t b, UtcTime lo, UtcTime hi, Conjunction& c) {
+    Vec3 pa, va, pb, vb;
+    auto rangeRate = [&](UtcTime t) {
+        cat[a].calcPosVelECI_UTC(t, pa, va);
+        cat[b].calcPosVelECI_UTC(t, pb, vb);
+        return dot(pa - pb, va - vb);
+    };
+    nRefined++;
+    double x0 = 0, x1 = hi.secondsSince(lo);
+    double f0 = rangeRate(lo), f1 = rangeRate(hi);
+    if (!(f0 < 0 && f1 > 0)) return false;
+
+    int side = 0;
+    double x = x0;
+    for (int iter = 0; iter < CONJ_MAX_REFINE && x1 - x0 > CONJ_TCA_TOL_S; ++iter) {
+        x = (x0*f1 - x1*f0) / (f1 - f0);
+        if (!(x > x0 && x < x1)) x = 0.5 * (x0 + x1);
+        double f = rangeRate(lo + int64_t(llround(x * 1e9)));
+        if (f < 0) {
+            x0 = x; f0 = f;
+            if (side == -1) f1 *= 0.5;
+            side = -1;
+        } else {
+            x1 = x; f1 = f;
+            if (side == 1) f0 *= 0.5;
+            side = 1;
+        }
+        if (f == 0) break;
+    }
+    c.a = a;
+    c.b = b;
+    c.tca = lo + int64_t(llround(x * 1e9));
+    rangeRate(c.tca);
+    c.miss = norm(pa - pb);
+    c.relSpeed = norm(va - vb);
+    return true;
+}
+
+// Screen the catalog over the query span, replacing out with the approaches under threshold sorted by pair & TCA
+void ConjunctionScreen::screen(const ConjunctionQuery& q, std::vector<Conjunction>& out, ConjMethod method) {
+    nPairTests = nRefined = 0;
+    candidates.clear();
+    out.clear();
+    if (count < 2 || q.nSteps == 0) return;
+    for (Cell& c : cells) c.head = -1;
+    usedCells.clear();
+
+    // Relative acceleration is at most 2 gmax, so over half a step the true path stays within
+    // gmax * halfStep^2 of the straight line
+    halfStep = double(q.step_ns) / 2e9;
+    reach = q.threshold + gmax * halfStep * halfStep;
+    radius = reach + 2 * vmax * halfStep;
+    for (uint32_t k = 0; k < q.nSteps; ++k) {
+        UtcTime t = q.start + int64_t(k) * q.step_ns;
+        for (uint32_t i = 0; i < count; ++i) cat[i].calcPosVelECI_UTC(t, pos[i], vel[i]);
+        if (method == CONJ_GRID) gridPairs(k);
+        else allPairs(k);
+    }
+
+    // Candidates in pair order, so the steps of one encounter are adjacent
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+        return x.a != y.a ? x.a < y.a : x.b != y.b ? x.b < y.b : x.step < y.step;
+    });
+    UtcTime end = q.start + int64_t(q.nSteps - 1) * q.step_ns;
+    Conjunction last = {0, 0, {INT64_MIN}, 0, 0};
+    for (const Candidate& cd : candidates) {
+        UtcTime lo = q.start + (int64_t(cd.step) - 1) * q.step_ns, hi = lo + 2 * q.step_ns;
+        if (lo.ns < q.start.ns) lo = q.start;
+        if (hi.ns > end.ns) hi = end;
+        // Skip steps whose bracket already holds the last approach found for this pair
+        if (last.a == cd.a && last.b == cd.b && last.tca.ns >= lo.ns) continue;
+        Conjunction c;
+        if (!refine(cd.a, cd.b, lo, hi, c)) continue;
+        last = c;
+        if (c.miss < q.threshold) out.push_back(c);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+  conjunction.h - Close-approach screening between the objects of a catalog (host only)
+    States from Orbit::calcPosVelECI are sampled every step. Over half a step either side of a sample, a pair's
+    true separation stays within gmax * (step/2)^2 of the straight-line motion from its sampled relative state,
+    where gmax is the gravity at the lowest perigee in the catalog. So a pair can only come within the threshold
+    D if its straight-line approach gets within reach = D + gmax * (step/2)^2, which in turn needs it to be
+    within radius = reach + vmax * step at the sample, vmax being the fastest perigee speed in the catalog.
+    Binning positions into a uniform hash grid of radius-sized cells finds those pairs by testing each cell
+    against itself and its 13 forward neighbours. For a spread-out catalog that is O(N) per step instead of the
+    O(N^2) all-pairs test, which is kept as CONJ_ALL_PAIRS for reference. Each surviving candidate is refined
+    by a safeguarded secant search for the zero of the range rate, which gives the time & distance of closest
+    approach. Pairs found on several steps are merged by TCA.
+ */
+#pragma once
+#include <vector>
+#include "orbit_utils.h"
+
+#define CONJ_TCA_TOL_S      1e-4    // Refinement stops once the TCA bracket is this narrow [s]
+#define CONJ_MAX_REFINE     60
+
+enum ConjMethod { CONJ_GRID, CONJ_ALL_PAIRS };
+
+struct Conjunction {
+    uint32_t a, b;          // Catalog indices, a < b
+    UtcTime tca;
+    double miss;            // [m]
+    double relSpeed;        // [m/s] at TCA
+};
+
+struct ConjunctionQuery {
+    UtcTime start;
+    int64_t step_ns;
+    uint32_t nSteps;        // Samples start + k*step, k < nSteps; TCAs are reported within that span
+    double threshold;       // [m]
+};
+
+struct ConjunctionScreen {
+    // Hash grid cell: packed integer coordinates & the head of its object list
+    struct Cell {
+        uint64_t key;
+        int32_t head;
+    };
+    struct Candidate {
+        uint32_t a, b, step;
+    };
+
+    Orbit* cat;
+    uint32_t count;
+    double vmax;            // Fastest perigee speed in the catalog [m/s]
+    double gmax;            // Gravity at the lowest perigee [m/s^2]
+
+    // Per-query screening distances [m] & half the step [s]
+    double reach, radius, halfStep;
+
+    // Per-step scratch
+    std::vector<Vec3> pos, vel;
+    std::vector<int32_t> next;      // Object list link within a cell
+    std::vector<Cell> cells;        // Open addressing, power-of-two size
+    std::vector<uint32_t> usedCells;
+    std::vector<Candidate> candidates;
+
+    // Work done by the last screen()
+    uint64_t nPairTests, nRefined;
+
+    void begin(Orbit* cat, uint32_t count);
+    void screen(const ConjunctionQuery& q, std::vector<Conjunction>& out, ConjMethod method = CONJ_GRID);
+
+    void testPair(uint32_t i, uint32_t j, uint32_t step);
+    void gridPairs(uint32_t step);
+    void allPairs(uint32_t step);
+    int32_t findCell(uint64_t key) const;
+    bool refine(uint32_t a, uint32_t b, UtcTime lo, UtcTime hi, Conjunction& c);
+};
@@ -0,0 +1,36 @@
+/*
+  mapped_file.cpp - POSIX mmap wrapper
+ */
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Map the whole file read-only. Returns false if it can't be opened or is empty
+bool MappedFile::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+    data = (const char*)p;
+    size = size_t(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+}
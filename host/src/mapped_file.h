@@ -0,0 +1,18 @@
+/*
+  mapped_file.h - Read-only memory-mapped file (host only), for scanning catalogs in place
+ */
+#pragma once
+#include <stddef.h>
+
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const char* path);
+    void close();
+};
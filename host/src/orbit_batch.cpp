@@ -0,0 +1,179 @@
+/*
+  orbit_batch.cpp - Structure-of-arrays catalog propagation
+    Satellites are processed in L1-sized blocks through a handful of branch-free, fixed-trip-count loops
+    so the compiler can vectorize them, including sin/cos (via glibc libmvec under -ffast-math, see CMakeLists.txt).
+ */
+#include "orbit_batch.h"
+
+void BatchState::resize(size_t count) {
+    x.resize(count); y.resize(count); z.resize(count);
+    vx.resize(count); vy.resize(count); vz.resize(count);
+}
+
+void OrbitBatch::reserve(size_t count) {
+    for (std::vector<double>* v : {&epochUnix, &M0, &n, &n_dot, &ecc, &a, &b, &sqrtMuA,
+                                   &Px, &Py, &Pz, &Qx, &Qy, &Qz})
+        v->reserve(count);
+}
+
+void OrbitBatch::clear() {
+    for (std::vector<double>* v : {&epochUnix, &M0, &n, &n_dot, &ecc, &a, &b, &sqrtMuA,
+                                   &Px, &Py, &Pz, &Qx, &Qy, &Qz})
+        v->clear();
+}
+
+// Append an orbit, precomputing everything that doesn't depend on time
+void OrbitBatch::add(const Orbit& orb) {
+    double cos_w = cos(orb.omega), sin_w = sin(orb.omega);
+    double cos_O = cos(orb.Omega), sin_O = sin(orb.Omega);
+    double cos_i = cos(orb.incl),  sin_i = sin(orb.incl);
+
+    epochUnix.push_back(orb.epoch.unixSeconds());
+    M0.push_back(orb.M0);
+    n.push_back(orb.n);
+    n_dot.push_back(orb.n_dot);
+    ecc.push_back(orb.ecc);
+    a.push_back(orb.a);
+    b.push_back(orb.a * sqrt(1. - orb.ecc*orb.ecc));
+    sqrtMuA.push_back(sqrt(MU_EARTH * orb.a));
+
+    Px.push_back(cos_w*cos_O - sin_w*cos_i*sin_O);
+    Py.push_back(cos_w*sin_O + sin_w*cos_i*cos_O);
+    Pz.push_back(sin_w*sin_i);
+    Qx.push_back(-(sin_w*cos_O + cos_w*cos_i*sin_O));
+    Qy.push_back(cos_w*cos_i*cos_O - sin_w*sin_O);
+    Qz.push_back(cos_w*sin_i);
+}
+
+// Elementwise sin & cos over a block. Kept as separate loops on purpose: when sin and cos of the same
+// argument share a loop, GCC merges them into a scalar sincos call that has no vector variant.
+static void sinBlock(const double* __restrict x, double* __restrict out, size_t count) {
+    for (size_t i = 0; i < count; ++i) out[i] = sin(x[i]);
+}
+
+static void cosBlock(const double* __restrict x, double* __restrict out, size_t count) {
+    for (size_t i = 0; i < count; ++i) out[i] = cos(x[i]);
+}
+
+// Solve Kepler's equation for one block with a fixed number of Newton steps, leaving sin(E) & cos(E) in sE/cE
+// Mean anomalies must already be wrapped to [-pi,pi]. They are seeded with the 2nd-order series
+// E = M + e*sin(M)*(1 + e*cos(M)), which is within a few degrees of the answer for LEO eccentricities
+// and close enough for Newton to converge in BATCH_KEPLER_ITERS steps for high ones.
+static void keplerBlock(const double* __restrict M, const double* __restrict ecc, double* __restrict E,
+                        double* __restrict sE, double* __restrict cE, size_t count) {
+    sinBlock(M, sE, count);
+    cosBlock(M, cE, count);
+    for (size_t i = 0; i < count; ++i)
+        E[i] = M[i] + ecc[i]*sE[i]*(1. + ecc[i]*cE[i]);
+
+    for (int k = 0; k < BATCH_KEPLER_ITERS; ++k) {
+        sinBlock(E, sE, count);
+        cosBlock(E, cE, count);
+        for (size_t i = 0; i < count; ++i)
+            E[i] -= (E[i] - ecc[i]*sE[i] - M[i]) / (1. - ecc[i]*cE[i]);
+    }
+    sinBlock(E, sE, count);
+    cosBlock(E, cE, count);
+}
+
+// Wrap the mean anomaly at dt seconds past each epoch to [-pi,pi]
+static void meanAnomalyBlock(double unixSec, const double* __restrict ep, const double* __restrict m0,
+                             const double* __restrict nn, const double* __restrict nd,
+                             double* __restrict M, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        double dt = unixSec - ep[i];
+        double Mt = m0[i] + (nn[i] + nd[i]*dt)*dt;
+        M[i] = Mt - TWO_PI * floor(Mt / TWO_PI + 0.5);
+    }
+}
+
+// Solve Kepler's equation for a whole array of (wrapped or unwrapped) mean anomalies
+void eccAnomalyFromMeanBatch(const double* M_in, const double* ecc, double* E_out, size_t count) {
+    double M[BATCH_BLOCK], sE[BATCH_BLOCK], cE[BATCH_BLOCK];
+    for (size_t i0 = 0; i0 < count; i0 += BATCH_BLOCK) {
+        size_t nb = count - i0 < BATCH_BLOCK ? count - i0 : BATCH_BLOCK;
+        for (size_t i = 0; i < nb; ++i)
+            M[i] = M_in[i0+i] - TWO_PI * floor(M_in[i0+i] / TWO_PI + 0.5);
+        keplerBlock(M, ecc + i0, E_out + i0, sE, cE, nb);
+    }
+}
+
+// Propagate every satellite to the given unix time, positions & velocities in ECI [m, m/s]
+void OrbitBatch::propagate(double unixSec, BatchState& out) const {
+    const size_t count = size();
+    out.resize(count);
+
+    double M[BATCH_BLOCK], E[BATCH_BLOCK], sE[BATCH_BLOCK], cE[BATCH_BLOCK];
+    for (size_t i0 = 0; i0 < count; i0 += BATCH_BLOCK) {
+        size_t nb = count - i0 < BATCH_BLOCK ? count - i0 : BATCH_BLOCK;
+        meanAnomalyBlock(unixSec, &epochUnix[i0], &M0[i0], &n[i0], &n_dot[i0], M, nb);
+        keplerBlock(M, &ecc[i0], E, sE, cE, nb);
+
+        const double* __restrict ee = &ecc[i0];
+        const double* __restrict aa = &a[i0];
+        const double* __restrict bb = &b[i0];
+        const double* __restrict vs = &sqrtMuA[i0];
+        const double* __restrict px = &Px[i0];
+        const double* __restrict py = &Py[i0];
+        const double* __restrict pz = &Pz[i0];
+        const double* __restrict qx = &Qx[i0];
+        const double* __restrict qy = &Qy[i0];
+        const double* __restrict qz = &Qz[i0];
+        double* __restrict x  = &out.x[i0];
+        double* __restrict y  = &out.y[i0];
+        double* __restrict z  = &out.z[i0];
+        double* __restrict vx = &out.vx[i0];
+        double* __restrict vy = &out.vy[i0];
+        double* __restrict vz = &out.vz[i0];
+
+        for (size_t i = 0; i < nb; ++i) {
+            // In-plane position & velocity, without going through the true anomaly
+            double o_x = aa[i]*(cE[i] - ee[i]);
+            double o_y = bb[i]*sE[i];
+            double v = vs[i] / (aa[i]*(1. - ee[i]*cE[i]));
+            double v_x = -v*sE[i];
+            double v_y = v*(bb[i]/aa[i])*cE[i];
+
+            x[i]  = px[i]*o_x + qx[i]*o_y;
+            y[i]  = py[i]*o_x + qy[i]*o_y;
+            z[i]  = pz[i]*o_x + qz[i]*o_y;
+            vx[i] = px[i]*v_x + qx[i]*v_y;
+            vy[i] = py[i]*v_x + qy[i]*v_y;
+            vz[i] = pz[i]*v_x + qz[i]*v_y;
+        }
+    }
+}
+
+// Position-only variant for screening, writes into caller-provided arrays of size()
+void OrbitBatch::propagatePos(double unixSec, double* x_out, double* y_out, double* z_out) const {
+    const size_t count = size();
+
+    double M[BATCH_BLOCK], E[BATCH_BLOCK], sE[BATCH_BLOCK], cE[BATCH_BLOCK];
+    for (size_t i0 = 0; i0 < count; i0 += BATCH_BLOCK) {
+        size_t nb = count - i0 < BATCH_BLOCK ? count - i0 : BATCH_BLOCK;
+        meanAnomalyBlock(unixSec, &epochUnix[i0], &M0[i0], &n[i0], &n_dot[i0], M, nb);
+        keplerBlock(M, &ecc[i0], E, sE, cE, nb);
+
+        const double* __restrict ee = &ecc[i0];
+        const double* __restrict aa = &a[i0];
+        const double* __restrict bb = &b[i0];
+        const double* __restrict px = &Px[i0];
+        const double* __restrict py = &Py[i0];
+        const double* __restrict pz = &Pz[i0];
+        const double* __restrict qx = &Qx[i0];
+        const double* __restrict qy = &Qy[i0];
+        const double* __restrict qz = &Qz[i0];
+        double* __restrict x = x_out + i0;
+        double* __restrict y = y_out + i0;
+        double* __restrict z = z_out + i0;
+
+        for (size_t i = 0; i < nb; ++i) {
+            double o_x = aa[i]*(cE[i] - ee[i]);
+            double o_y = bb[i]*sE[i];
+
+            x[i] = px[i]*o_x + qx[i]*o_y;
+            y[i] = py[i]*o_x + qy[i]*o_y;
+            z[i] = pz[i]*o_x + qz[i]*o_y;
+        }
+    }
+}
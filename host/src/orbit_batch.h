@@ -0,0 +1,50 @@
+/*
+  orbit_batch.h - Structure-of-arrays propagator for whole TLE catalogs (host only)
+    Same two-body + linear n_dot model as Orbit::calcPosVelECI, but all satellites are propagated
+    to a single timestamp in one pass over separate per-element arrays so the loop auto-vectorizes.
+ */
+#pragma once
+#include <stddef.h>
+#include <vector>
+#include "orbit_utils.h"
+
+// Fixed Newton iteration count for the batch Kepler solve.
+// With the starter used in orbit_batch.cpp this converges to < 1e-12 rad for ecc <= 0.9
+#define BATCH_KEPLER_ITERS 6
+
+// Satellites per inner block, sized so a block's scratch arrays stay in L1
+#define BATCH_BLOCK 256
+
+// Propagated ECI state for every satellite in a batch, one array per component
+struct BatchState {
+    std::vector<double> x, y, z;
+    std::vector<double> vx, vy, vz;
+
+    void resize(size_t count);
+};
+
+// Catalog of orbits stored as one array per element
+struct OrbitBatch {
+    std::vector<double> epochUnix;  // TLE epoch [unix sec, fractional]
+    std::vector<double> M0;
+    std::vector<double> n;
+    std::vector<double> n_dot;
+    std::vector<double> ecc;
+    std::vector<double> a;
+    std::vector<double> b;          // semi-minor axis, a*sqrt(1-ecc^2)
+    std::vector<double> sqrtMuA;    // sqrt(MU_EARTH * a), velocity scale
+
+    // Orbit-plane to ECI rotation, stored as its two in-plane columns P & Q
+    std::vector<double> Px, Py, Pz;
+    std::vector<double> Qx, Qy, Qz;
+
+    size_t size() const { return M0.size(); }
+    void reserve(size_t count);
+    void clear();
+    void add(const Orbit& orb);
+
+    void propagate(double unixSec, BatchState& out) const;
+    void propagatePos(double unixSec, double* x, double* y, double* z) const;
+};
+
+void eccAnomalyFromMeanBatch(const double* M, const double* ecc, double* E, size_t count);
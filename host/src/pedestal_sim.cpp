@@ -0,0 +1,161 @@
+/*
+  pedestal_sim.cpp - Event-stepped pedestal simulation
+ */
+#include "pedestal_sim.h"
+#include "pedestal.h"
+#include "scheduler.h"
+
+// Context shared with the task callbacks
+struct SimContext {
+    Pedestal ped;
+    PointingSolver pointing;
+    uint64_t clock0_us;
+    uint64_t startUTC_ms;
+};
+
+static uint64_t simUTCms(const SimContext& sim) {
+    return sim.startUTC_ms + (hostClockUs - sim.clock0_us) / 1000;
+}
+
+static uint32_t clockMs() { return millis(); }
+static uint32_t clockUs() { return micros(); }
+
+static void stepperIdle(void* ctx) { ((SimContext*)ctx)->ped.runStepper(); }
+
+static void orbitTask(void* ctx) {
+    SimContext& sim = *(SimContext*)ctx;
+    sim.pointing.solve(simUTCms(sim));
+    sim.ped.point(sim.pointing.aer, sim.pointing.rates);
+}
+
+static void ephemTask(void* ctx) {
+    SimContext& sim = *(SimContext*)ctx;
+    sim.pointing.fitEphem(simUTCms(sim));
+}
+
+// Angle between two Az/El directions [deg]
+static double separationDeg(double az1, double el1, double az2, double el2) {
+    az1 *= DEG_TO_RAD; el1 *= DEG_TO_RAD; az2 *= DEG_TO_RAD; el2 *= DEG_TO_RAD;
+    double c = sin(el1)*sin(el2) + cos(el1)*cos(el2)*cos(az1 - az2);
+    return acos(fmin(1.0, fmax(-1.0, c))) * RAD_TO_DEG;
+}
+
+static uint64_t minU64(uint64_t a, uint64_t b) { return a < b ? a : b; }
+
+// Microseconds from now until a 32-bit millisecond time, 0 if already passed
+static uint64_t untilMs(uint32_t t_ms) {
+    int32_t dMs = int32_t(t_ms - millis());
+    if (dMs <= 0) return 0;
+    return uint64_t(dMs) * 1000 - hostClockUs % 1000;
+}
+
+// Microseconds from now until a 32-bit microsecond time, 0 if already passed
+static uint64_t untilUs(uint32_t t_us) {
+    int32_t d = int32_t(t_us - micros());
+    return d > 0 ? uint64_t(d) : 0;
+}
+
+void PointingStats::add(double errAz, double errEl, double errPt, bool hit) {
+    n++;
+    nOnTarget += hit;
+    sumSqAz += errAz*errAz;
+    sumSqEl += errEl*errEl;
+    sumSqPt += errPt*errPt;
+    maxErrAz = fmax(maxErrAz, errAz);
+    maxErrEl = fmax(maxErrEl, errEl);
+    maxErrPt = fmax(maxErrPt, errPt);
+}
+
+// Track the orbit for cfg.duration_s of virtual time. Returns 0, or -1 if there were more passes than fit
+int runPedestalSim(OrbitModel& orb, const PedSimConfig& cfg, PedSimResult& result) {
+    memset(&result, 0, sizeof(result));
+    int rc = 0;
+
+    // Start the virtual clock a few seconds short of the 32-bit millis() wrap so it's always exercised
+    hostClockUs = (uint64_t(1) << 32) * 1000 - 5000000;
+
+    SimContext sim;
+    sim.clock0_us = hostClockUs;
+    sim.startUTC_ms = cfg.startUTC_ms;
+    sim.ped.begin();
+    sim.ped.feedForward = cfg.feedForward;
+    sim.ped.stepper.setCurrentPosition(0);     // Pointing north after the compass alignment
+    sim.pointing.begin(cfg.llaRef, orb);
+    sim.pointing.useCache = cfg.useCache;
+    sim.pointing.orbitUpdated();
+
+    // Same periods as the firmware task set. Network & display tasks are not modelled
+    Scheduler sched;
+    sched.begin(clockMs, clockUs, stepperIdle, &sim);
+    sched.add("orbit", orbitTask, &sim, ORBIT_REFRESH_DELAY_MS);
+    sched.add("ephem", ephemTask, &sim, EPHEM_TASK_MS);
+
+    // Truth always runs the full chain
+    OrbitTracker truthTracker;
+    truthTracker.init(orb);
+    ObserverFrame observer;
+    observer.init(cfg.llaRef, DEGREES);
+
+    uint64_t end_us = hostClockUs + uint64_t(cfg.duration_s * 1e6);
+    uint64_t sample_us = uint64_t(cfg.sample_ms * 1000);
+    uint64_t nextSample_us = hostClockUs;
+    PointingStats* pass = NULL;
+    bool wasUp = false;
+
+    while (hostClockUs < end_us) {
+        sched.runOnce();
+        result.nEvents++;
+
+        if (hostClockUs >= nextSample_us) {
+            nextSample_us += sample_us;
+            uint64_t UTC_ms = simUTCms(sim);
+            Vec3 posECI, velECI;
+            truthTracker.update(UTC_ms, posECI, velECI);
+            Vec3 truth = observer.lookAngles(truthTracker.eci2ecef(posECI));
+            bool up = truth.y > 0;
+
+            if (up && !wasUp) {
+                if (result.nPasses < PEDSIM_MAX_PASSES) {
+                    pass = &result.passes[result.nPasses++];
+                    pass->aos_ms = UTC_ms;
+                    pass->maxEl = truth.y;
+                } else {
+                    pass = NULL;
+                    rc = -1;
+                }
+            }
+            wasUp = up;
+
+            if (up) {
+                double ptAz = steps2deg(sim.ped.stepper.currentPosition());
+                double ptEl = sim.ped.servo.angle() - 90;
+                double errAz = fabs(wrapDeg180(truth.x - ptAz));
+                double errEl = fabs(truth.y - ptEl);
+                double errPt = separationDeg(truth.x, truth.y, ptAz, ptEl);
+                bool hit = errPt <= cfg.onTargetDeg;
+                result.total.add(errAz, errEl, errPt, hit);
+                if (pass) {
+                    pass->add(errAz, errEl, errPt, hit);
+                    pass->los_ms = UTC_ms;
+                    pass->maxEl = fmax(pass->maxEl, truth.y);
+                }
+                if (cfg.csv)
+                    fprintf(cfg.csv, "%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", UTC_ms / 1e3, truth.x, truth.y,
+                            fmod(ptAz + 360, 360), ptEl, errAz, errEl, errPt);
+            }
+        }
+
+        // Jump to the next thing that can happen: a task, a stepper step, a tracking update or a sample
+        uint64_t dt = nextSample_us > hostClockUs ? nextSample_us - hostClockUs : 0;
+        for (uint8_t i = 0; i < sched.nTasks; ++i)
+            dt = minU64(dt, untilMs(sched.tasks[i].next_ms));
+        const AccelStepper& st = sim.ped.stepper;
+        if (st.stepInterval) dt = minU64(dt, untilUs(uint32_t(st.lastStepTime + st.stepInterval)));
+        if (sim.ped.track.active)
+            dt = minU64(dt, untilMs(sim.ped.track.lastUpdate_ms + TRACK_UPDATE_MS));
+        hostClockUs += dt > 0 ? dt : 1;
+    }
+
+    result.nSteps = sim.ped.stepper.nSteps;
+    return rc;
+}
@@ -0,0 +1,47 @@
+/*
+  pedestal_sim.h - Faster-than-real-time simulation of the pedestal tracking the orbit
+    Runs the firmware's Pedestal, PointingSolver and Scheduler against the host shims (AccelStepper model,
+    slewing servo, virtual clock). The clock jumps straight to the next step, task or sample time, so a
+    day of tracking takes seconds. Pointing is compared against the full propagation chain at fixed intervals.
+ */
+#pragma once
+#include <stdio.h>
+#include "pointing.h"
+
+#define PEDSIM_MAX_PASSES   16
+
+struct PedSimConfig {
+    Vec3 llaRef;
+    uint64_t startUTC_ms;
+    double duration_s;
+    bool feedForward;
+    bool useCache;
+    double sample_ms;       // Truth comparison interval
+    double onTargetDeg;     // Pointing error counted as on target
+    FILE* csv;              // In-pass error time series, NULL for none
+};
+
+// Error statistics over the time the target is above the horizon
+struct PointingStats {
+    uint64_t aos_ms, los_ms;
+    double maxEl;
+    uint32_t n, nOnTarget;
+    double sumSqAz, sumSqEl, sumSqPt;
+    double maxErrAz, maxErrEl, maxErrPt;
+
+    void add(double errAz, double errEl, double errPt, bool onTarget);
+    double rmsAz() const { return n ? sqrt(sumSqAz / n) : 0; }
+    double rmsEl() const { return n ? sqrt(sumSqEl / n) : 0; }
+    double rmsPt() const { return n ? sqrt(sumSqPt / n) : 0; }
+    double onTarget() const { return n ? double(nOnTarget) / n : 0; }
+};
+
+struct PedSimResult {
+    PointingStats passes[PEDSIM_MAX_PASSES];
+    int nPasses;
+    PointingStats total;
+    uint32_t nSteps;
+    uint64_t nEvents;
+};
+
+int runPedestalSim(OrbitModel& orb, const PedSimConfig& cfg, PedSimResult& result);
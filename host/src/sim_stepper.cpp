@@ -0,0 +1,146 @@
+/*
+  sim_stepper.cpp - AccelStepper model implementation
+ */
+#include <math.h>
+#include "sim_stepper.h"
+
+// Same defaults as the AccelStepper constructor
+void SimStepper::begin(SimMicros _clockUs) {
+    clockUs = _clockUs;
+    currentPos = 0;
+    targetPos = 0;
+    speed = 0;
+    maxSpeed = 1;
+    acceleration = 0;
+    stepInterval = 0;
+    lastStepTime = 0;
+    n = 0;
+    c0 = 0;
+    cn = 0;
+    cmin = 1;
+    directionCW = false;
+    nSteps = 0;
+    setAcceleration(1);
+    setMaxSpeed(1);
+}
+
+void SimStepper::moveTo(long absolute) {
+    if (targetPos != absolute) {
+        targetPos = absolute;
+        computeNewSpeed();
+    }
+}
+
+void SimStepper::move(long relative) {
+    moveTo(currentPos + relative);
+}
+
+// Take at most one step if the current step interval has elapsed
+bool SimStepper::runSpeed() {
+    if (!stepInterval) return false;
+    unsigned long time = clockUs();
+    if (uint32_t(time - lastStepTime) >= stepInterval) {
+        currentPos += directionCW ? 1 : -1;
+        nSteps++;
+        lastStepTime = time;
+        return true;
+    }
+    return false;
+}
+
+// Step towards the target with the acceleration profile. Returns true while still moving
+bool SimStepper::run() {
+    if (runSpeed()) computeNewSpeed();
+    return speed != 0.0f || distanceToGo() != 0;
+}
+
+void SimStepper::setCurrentPosition(long position) {
+    targetPos = currentPos = position;
+    n = 0;
+    stepInterval = 0;
+    speed = 0;
+}
+
+void SimStepper::setMaxSpeed(float s) {
+    if (s < 0) s = -s;
+    if (maxSpeed != s) {
+        maxSpeed = s;
+        cmin = 1000000.0f / s;
+        // Recompute n from current speed and adjust speed if accelerating or cruising
+        if (n > 0) {
+            n = long((speed * speed) / (2.0f * acceleration));
+            computeNewSpeed();
+        }
+    }
+}
+
+void SimStepper::setAcceleration(float a) {
+    if (a == 0.0f) return;
+    if (a < 0.0f) a = -a;
+    if (acceleration != a) {
+        // Recompute n per Equation 17
+        n = long(n * (acceleration / a));
+        // New c0 per Equation 7, with correction per Equation 15
+        c0 = 0.676f * sqrtf(2.0f / a) * 1000000.0f;
+        acceleration = a;
+        computeNewSpeed();
+    }
+}
+
+// Constant speed for runSpeed(), clamped to maxSpeed
+void SimStepper::setSpeed(float s) {
+    if (s == speed) return;
+    if (s > maxSpeed) s = maxSpeed;
+    if (s < -maxSpeed) s = -maxSpeed;
+    if (s == 0.0f) {
+        stepInterval = 0;
+    } else {
+        stepInterval = (unsigned long)fabsf(1000000.0f / s);
+        directionCW = s > 0.0f;
+    }
+    speed = s;
+}
+
+// Next step interval for run(), accelerating, cruising or decelerating to stop at the target
+void SimStepper::computeNewSpeed() {
+    long distanceTo = distanceToGo();
+    long stepsToStop = long((speed * speed) / (2.0f * acceleration));
+
+    if (distanceTo == 0 && stepsToStop <= 1) {
+        // At the target and slow enough to stop
+        stepInterval = 0;
+        speed = 0;
+        n = 0;
+        return;
+    }
+
+    if (distanceTo > 0) {
+        if (n > 0) {
+            // Decelerate if we'd overshoot or are going the wrong way
+            if (stepsToStop >= distanceTo || !directionCW) n = -stepsToStop;
+        } else if (n < 0) {
+            // Accelerate again if we can still stop in time and are going the right way
+            if (stepsToStop < distanceTo && directionCW) n = -n;
+        }
+    } else if (distanceTo < 0) {
+        if (n > 0) {
+            if (stepsToStop >= -distanceTo || directionCW) n = -stepsToStop;
+        } else if (n < 0) {
+            if (stepsToStop < -distanceTo && !directionCW) n = -n;
+        }
+    }
+
+    if (n == 0) {
+        // First step from stopped
+        cn = c0;
+        directionCW = distanceTo > 0;
+    } else {
+        // Subsequent step. Works for accel (n positive) and decel (n negative)
+        cn = cn - ((2.0f * cn) / ((4.0f * n) + 1));
+        if (cn < cmin) cn = cmin;
+    }
+    n++;
+    stepInterval = (unsigned long)cn;
+    speed = 1000000.0f / cn;
+    if (!directionCW) speed = -speed;
+}
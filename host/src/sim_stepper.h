@@ -0,0 +1,38 @@
+/*
+  sim_stepper.h - Host model of AccelStepper driven by a virtual microsecond clock
+    Follows AccelStepper 1.64's stepping & acceleration algorithm (Austin's step-interval recurrence),
+    so step timing in simulations matches what the library produces on the board.
+ */
+#pragma once
+#include <stdint.h>
+
+typedef uint32_t (*SimMicros)();
+
+struct SimStepper {
+    SimMicros clockUs;
+
+    long currentPos;
+    long targetPos;
+    float speed;            // [steps/s], negative is anticlockwise
+    float maxSpeed;
+    float acceleration;
+    unsigned long stepInterval;     // [us], 0 when stopped
+    unsigned long lastStepTime;
+    long n;                 // Step counter in the acceleration profile, negative while decelerating
+    float c0, cn, cmin;     // Initial, current & minimum step intervals [us]
+    bool directionCW;
+    uint32_t nSteps;        // Steps taken, for drive accounting
+
+    void begin(SimMicros clockUs);
+    void moveTo(long absolute);
+    void move(long relative);
+    bool runSpeed();
+    bool run();
+    long distanceToGo() const { return targetPos - currentPos; }
+    long currentPosition() const { return currentPos; }
+    void setCurrentPosition(long position);
+    void setMaxSpeed(float speed);
+    void setAcceleration(float acceleration);
+    void setSpeed(float speed);
+    void computeNewSpeed();
+};
@@ -0,0 +1,91 @@
+/*
+  visibility.cpp - Tiled catalog visibility screening
+ */
+#include <algorithm>
+#include "visibility.h"
+
+void VisibilityScreen::begin(Orbit* _cat, uint32_t _count, WorkStealingPool& _pool) {
+    cat = _cat;
+    count = _count;
+    pool = &_pool;
+    found.assign(pool->size(), std::vector<VisibleInterval>());
+    nPropagated = 0;
+}
+
+// Screen every satellite over the query grid, replacing out with the merged intervals sorted by satellite
+void VisibilityScreen::screen(const VisibilityQuery& q, std::vector<VisibleInterval>& out) {
+    obs.init(q.lla, DEGREES);
+    sinMask = sin(q.elMaskDeg * DEG_TO_RAD);
+
+    // One exact ERA, then integer steps along the grid
+    times.resize(q.nSteps);
+    cosEra.resize(q.nSteps);
+    sinEra.resize(q.nSteps);
+    EraClock clk;
+    clk.set(q.start);
+    for (uint32_t k = 0; k < q.nSteps; ++k) {
+        times[k] = q.start + int64_t(k) * q.step_ns;
+        clk.advanceTo(times[k]);
+        sinCos(clk.angle(), sinEra[k], cosEra[k]);
+    }
+
+    for (std::vector<VisibleInterval>& f : found) f.clear();
+    uint32_t nStepTiles = (q.nSteps + VIS_TILE_STEPS - 1) / VIS_TILE_STEPS;
+    uint32_t nSatTiles = (count + VIS_TILE_SATS - 1) / VIS_TILE_SATS;
+    pool->run(nSatTiles * nStepTiles, [&](uint32_t task, unsigned worker) {
+        screenTile(q, (task / nStepTiles) * VIS_TILE_SATS, (task % nStepTiles) * VIS_TILE_STEPS, found[worker]);
+    });
+    nPropagated += uint64_t(count) * q.nSteps;
+
+    // Gather, then join intervals that a tile edge split
+    out.clear();
+    for (const std::vector<VisibleInterval>& f : found) out.insert(out.end(), f.begin(), f.end());
+    std::sort(out.begin(), out.end(), [](const VisibleInterval& a, const VisibleInterval& b) {
+        return a.sat != b.sat ? a.sat < b.sat : a.begin < b.begin;
+    });
+    size_t n = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (n && out[n-1].sat == out[i].sat && out[n-1].end == out[i].begin) {
+            out[n-1].end = out[i].end;
+            out[n-1].maxEl = std::max(out[n-1].maxEl, out[i].maxEl);
+        } else {
+            out[n++] = out[i];
+        }
+    }
+    out.resize(n);
+}
+
+// Screen one tile, appending the runs of visible steps within it to dst
+void VisibilityScreen::screenTile(const VisibilityQuery& q, uint32_t sat0, uint32_t step0,
+                                  std::vector<VisibleInterval>& dst) const {
+    uint32_t sat1 = std::min(sat0 + VIS_TILE_SATS, count);
+    uint32_t step1 = std::min(step0 + VIS_TILE_STEPS, q.nSteps);
+    for (uint32_t s = sat0; s < sat1; ++s) {
+        Orbit& orb = cat[s];
+        bool up = false;
+        VisibleInterval iv = {s, 0, 0, -90.f};
+        for (uint32_t k = step0; k < step1; ++k) {
+            Vec3 posECI;
+            orb.calcPosECI_UTC(times[k], posECI);
+            Vec3 ned = obs.ecef2ned(rotZ(posECI, cosEra[k], -sinEra[k]));
+            // Above the mask iff sin(el) = -down / range exceeds sin(mask); no trig for the ones below it
+            if (-ned.z > sinMask * norm(ned)) {
+                float el = float(ned2AzElRng(ned).y);
+                if (!up) {
+                    up = true;
+                    iv.begin = k;
+                    iv.maxEl = el;
+                }
+                iv.maxEl = std::max(iv.maxEl, el);
+            } else if (up) {
+                up = false;
+                iv.end = k;
+                dst.push_back(iv);
+            }
+        }
+        if (up) {
+            iv.end = step1;
+            dst.push_back(iv);
+        }
+    }
+}
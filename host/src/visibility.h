@@ -0,0 +1,51 @@
+/*
+  visibility.h - All-sky visibility screening of a catalog for one site over a time grid (host only)
+    The (satellite x time step) grid is cut into tiles of VIS_TILE_SATS x VIS_TILE_STEPS, which a
+    WorkStealingPool spreads over all cores. Each sample is the full chain: calcPosECI_UTC, rotation to ECEF
+    with the step's precomputed ERA, then NED & elevation. Only samples above the horizon pay for the
+    elevation's atan2. Each worker appends its intervals to its own buffer, so nothing is shared while tiles
+    run. Afterwards the buffers are sorted by satellite & step and joined across tile edges, so the result
+    doesn't depend on the thread count or on the order tiles ran in. Intervals are on the grid: AOS & LOS are
+    only resolved to one step.
+ */
+#pragma once
+#include <vector>
+#include "orbit_utils.h"
+#include "work_pool.h"
+
+#define VIS_TILE_SATS   64
+#define VIS_TILE_STEPS  32
+
+// Grid steps [begin, end) during which one satellite is above the elevation mask
+struct VisibleInterval {
+    uint32_t sat;           // Index into the catalog
+    uint32_t begin;
+    uint32_t end;
+    float maxEl;            // [deg], highest sampled
+};
+
+struct VisibilityQuery {
+    Vec3 lla;               // Site [deg, deg, m]
+    UtcTime start;
+    int64_t step_ns;
+    uint32_t nSteps;        // 1 for "right now"
+    double elMaskDeg;
+};
+
+struct VisibilityScreen {
+    Orbit* cat;
+    uint32_t count;
+    WorkStealingPool* pool;
+
+    // Per-query tables, shared read-only by all tiles
+    ObserverFrame obs;
+    double sinMask;
+    std::vector<UtcTime> times;
+    std::vector<double> cosEra, sinEra;
+    std::vector<std::vector<VisibleInterval>> found;    // One buffer per worker
+    uint64_t nPropagated;
+
+    void begin(Orbit* cat, uint32_t count, WorkStealingPool& pool);
+    void screen(const VisibilityQuery& q, std::vector<VisibleInterval>& out);
+    void screenTile(const VisibilityQuery& q, uint32_t sat0, uint32_t step0, std::vector<VisibleInterval>& dst) const;
+};
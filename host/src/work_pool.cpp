@@ -0,0 +1,111 @@
+/*
+  work_pool.cpp - Work-stealing pool implementation
+ */
+#include "work_pool.h"
+
+static inline uint64_t packRange(uint32_t lo, uint32_t hi) { return uint64_t(lo) | uint64_t(hi) << 32; }
+
+WorkStealingPool::WorkStealingPool(unsigned nThreads) : nWorkers(nThreads ? nThreads : 1), ranges(new Range[nWorkers]) {
+    for (unsigned w = 0; w < nWorkers; ++w) ranges[w].bounds.store(0, std::memory_order_relaxed);
+    for (unsigned w = 1; w < nWorkers; ++w) threads.emplace_back(&WorkStealingPool::threadMain, this, w);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    startCv.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+// Run fn over tasks [0, nTasks) on every worker, returning once all of them have finished
+void WorkStealingPool::run(uint32_t nTasks, const PoolTask& fn) {
+    for (unsigned w = 0; w < nWorkers; ++w) {
+        uint32_t lo = uint32_t(uint64_t(nTasks) * w / nWorkers);
+        uint32_t hi = uint32_t(uint64_t(nTasks) * (w + 1) / nWorkers);
+        ranges[w].bounds.store(packRange(lo, hi), std::memory_order_relaxed);
+        ranges[w].nRun = ranges[w].nStolen = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job = &fn;
+        nBusy = nWorkers - 1;
+        generation++;
+    }
+    startCv.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCv.wait(lock, [&] { return nBusy == 0; });
+    job = nullptr;
+}
+
+void WorkStealingPool::threadMain(unsigned worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            startCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        work(worker);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            nBusy--;
+        }
+        doneCv.notify_one();
+    }
+}
+
+// Drain the own range, then keep stealing until every range is empty
+void WorkStealingPool::work(unsigned worker) {
+    const PoolTask& fn = *job;
+    uint32_t task;
+    for (;;) {
+        while (popOwn(worker, task)) {
+            fn(task, worker);
+            ranges[worker].nRun++;
+        }
+        if (!steal(worker, task)) return;
+        fn(task, worker);
+        ranges[worker].nRun++;
+    }
+}
+
+// Take the first task of the own range
+bool WorkStealingPool::popOwn(unsigned worker, uint32_t& task) {
+    std::atomic<uint64_t>& b = ranges[worker].bounds;
+    uint64_t r = b.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t lo = uint32_t(r), hi = uint32_t(r >> 32);
+        if (lo >= hi) return false;
+        if (b.compare_exchange_weak(r, packRange(lo + 1, hi), std::memory_order_acq_rel)) {
+            task = lo;
+            return true;
+        }
+    }
+}
+
+// Take the back half of the first non-empty range after our own, run its first task & keep the rest.
+// The own range is empty here, so no other thief can be updating it while it's refilled
+bool WorkStealingPool::steal(unsigned worker, uint32_t& task) {
+    for (unsigned k = 1; k < nWorkers; ++k) {
+        std::atomic<uint64_t>& b = ranges[(worker + k) % nWorkers].bounds;
+        uint64_t r = b.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t lo = uint32_t(r), hi = uint32_t(r >> 32);
+            if (lo >= hi) break;
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (b.compare_exchange_weak(r, packRange(lo, mid), std::memory_order_acq_rel)) {
+                task = mid;
+                ranges[worker].bounds.store(packRange(mid + 1, hi), std::memory_order_release);
+                ranges[worker].nStolen += hi - mid;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+/*
+  work_pool.h - Persistent thread pool with lock-free work stealing over index ranges (host only)
+    run() deals the task indices out as one contiguous range per worker. A worker takes tasks from the front of
+    its own range, and once that is empty it steals the back half of another worker's range. Each range is one
+    atomic 64-bit word (lo | hi << 32), so a pop or a steal is a single CAS. No tasks are created while a run
+    is in flight, so a worker can stop once a full sweep of the other workers finds nothing to steal.
+ */
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Task body: task index & the index of the worker running it, [0, size())
+typedef std::function<void(uint32_t task, unsigned worker)> PoolTask;
+
+struct WorkStealingPool {
+    // One worker's remaining tasks, on its own cache line
+    struct alignas(64) Range {
+        std::atomic<uint64_t> bounds;
+        uint32_t nRun, nStolen;     // Per-run stats, written only by the owner
+    };
+
+    explicit WorkStealingPool(unsigned nThreads);
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    ~WorkStealingPool();
+
+    unsigned size() const { return nWorkers; }
+    void run(uint32_t nTasks, const PoolTask& fn);
+    uint32_t tasksRun(unsigned worker) const { return ranges[worker].nRun; }
+    uint32_t tasksStolen(unsigned worker) const { return ranges[worker].nStolen; }
+
+private:
+    unsigned nWorkers;
+    std::unique_ptr<Range[]> ranges;
+    std::vector<std::thread> threads;
+
+    // Run hand-off: the caller works as worker 0, the threads wait for a new generation
+    std::mutex mtx;
+    std::condition_variable startCv, doneCv;
+    uint64_t generation = 0;
+    unsigned nBusy = 0;
+    bool stopping = false;
+    const PoolTask* job = nullptr;
+
+    void threadMain(unsigned worker);
+    void work(unsigned worker);
+    bool popOwn(unsigned worker, uint32_t& task);
+    bool steal(unsigned worker, uint32_t& task);
+};
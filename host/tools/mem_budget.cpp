@@ -0,0 +1,181 @@
+/*
+  mem_budget.cpp - Flash & RAM per firmware subsystem from a GNU ld link map
+    Reads the map written with -Wl,-Map, either the Arduino build's (see README) or a host binary's, and sums
+    the input sections the linker kept by the sketch source they came from. Code, read-only data & exception
+    tables count as flash, .bss as RAM, and .data as both, since its initial values are stored in flash.
+    Sections from outside the sketch (the Arduino core, libraries, libc) are lumped together.
+    RAM is only split meaningfully on the Arduino map. In a host harness the sketch's globals are defined in
+    the harness itself, so -f drops the RAM columns and reports flash alone. The report names the output format
+    from the map, and flags anything but the Cortex-M0's elf32-littlearm as host code, whose sizes come from
+    another instruction set & compiler flags and only rank the subsystems against each other.
+
+    mem_budget <file.map> [-v] [-f]     -v also lists each source file, -f reports flash only
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+// Sketch sources by subsystem; anything not listed is "core & libraries"
+static const char* subsystems[][2] = {
+    {"orbit_utils",     "orbit & time"},
+    {"sgp4",            "orbit & time"},
+    {"orbit_tracker",   "orbit & time"},
+    {"time_utils",      "orbit & time"},
+    {"coord",           "orbit & time"},
+    {"cheb_cache",      "pointing"},
+    {"pointing",        "pointing"},
+    {"pass_predict",    "pointing"},
+    {"pedestal",        "pedestal"},
+    {"track_control",   "pedestal"},
+    {"wifi_utils",      "network"},
+    {"http_tle_stream", "network"},
+    {"ntp_clock",       "network"},
+    {"net_link",        "network"},
+    {"tle_catalog",     "network"},
+    {"orbit_snapshot",  "network"},
+    {"display_frame",   "display"},
+    {"map_screen",      "display"},
+    {"ground_track",    "display"},
+    {"scheduler",       "runtime"},
+    {"profile",         "runtime"},
+    {"heap_guard",      "runtime"},
+    {"iss-tracker.ino", "runtime"},
+};
+
+struct Usage {
+    unsigned long text, data, bss;
+    unsigned long flash() const { return text + data; }
+    unsigned long ram() const { return data + bss; }
+};
+
+// Source of an object path: ".../pointing.cpp.o", "libiss_core.a(pointing.cpp.o)" -> "pointing",
+// ".../iss-tracker.ino.cpp.o" -> "iss-tracker.ino"
+static std::string sourceStem(const char* path) {
+    std::string p(path);
+    while (!p.empty() && (p.back() == ')' || p.back() == ' ' || p.back() == '\r')) p.pop_back();
+    size_t slash = p.find_last_of("/\\(");
+    if (slash != std::string::npos) p = p.substr(slash + 1);
+    size_t ino = p.find(".ino.");
+    if (ino != std::string::npos) return p.substr(0, ino + 4);
+    return p.substr(0, p.find('.'));
+}
+
+static const char* subsystemOf(const std::string& stem) {
+    for (const auto& s : subsystems)
+        if (stem == s[0]) return s[1];
+    return NULL;
+}
+
+// Kind of an input section: 't' flash only, 'd' flash & RAM, 'b' RAM only, 0 not counted
+static char sectionKind(const char* name) {
+    static const char* flash[] = {".text", ".rodata", ".ARM.extab", ".ARM.exidx", ".eh_frame", ".gcc_except_table",
+                                  ".init_array", ".fini_array", ".ctors", ".dtors"};
+    for (const char* f : flash)
+        if (strncmp(name, f, strlen(f)) == 0) return 't';
+    if (strncmp(name, ".data", 5) == 0) return 'd';
+    if (strncmp(name, ".bss", 4) == 0 || strcmp(name, "COMMON") == 0) return 'b';
+    return 0;
+}
+
+static void add(Usage& u, char kind, unsigned long size) {
+    if (kind == 't') u.text += size;
+    else if (kind == 'd') u.data += size;
+    else if (kind == 'b') u.bss += size;
+}
+
+// One report line, or the column headings if u is NULL
+static void printRow(const char* name, const Usage* u, bool flashOnly) {
+    if (!u && flashOnly) printf("%-24s %9s %9s %9s\n", name, "code+ro", "data", "flash");
+    else if (!u) printf("%-24s %9s %9s %9s %9s %9s\n", name, "code+ro", "data", "bss", "flash", "RAM");
+    else if (flashOnly) printf("%-24s %9lu %9lu %9lu\n", name, u->text, u->data, u->flash());
+    else printf("%-24s %9lu %9lu %9lu %9lu %9lu\n", name, u->text, u->data, u->bss, u->flash(), u->ram());
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.map> [-v] [-f]\n", argv[0]);
+        return 2;
+    }
+    bool verbose = false, flashOnly = false;
+    for (int i = 2; i < argc; ++i) {
+        verbose |= strcmp(argv[i], "-v") == 0;
+        flashOnly |= strcmp(argv[i], "-f") == 0;
+    }
+    FILE* f = fopen(argv[1], "r");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    std::map<std::string, Usage> bySubsystem, byFile;
+    char line[4096], pending[1024] = "", format[64] = "unknown";
+    bool inMap = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (!inMap) {
+            inMap = strncmp(line, "Linker script and memory map", 28) == 0;
+            continue;
+        }
+        if (strncmp(line, "OUTPUT(", 7) == 0) {
+            sscanf(line + 7, "%*s %63[^)]", format);
+            continue;
+        }
+        // Input sections are indented by one space; a long name puts address, size & file on the next line
+        char name[1024], file[2048];
+        unsigned long addr, size;
+        if (line[0] == ' ' && line[1] != ' ') {
+            int n = sscanf(line + 1, "%1023s 0x%lx 0x%lx %2047[^\n]", name, &addr, &size, file);
+            if (n == 1) {
+                strcpy(pending, name);
+                continue;
+            }
+            if (n != 4) {
+                pending[0] = '\0';
+                continue;
+            }
+        } else if (pending[0] && sscanf(line, " 0x%lx 0x%lx %2047[^\n]", &addr, &size, file) == 3) {
+            strcpy(name, pending);
+        } else {
+            pending[0] = '\0';
+            continue;
+        }
+        pending[0] = '\0';
+
+        char kind = sectionKind(name);
+        if (!kind || size == 0 || addr == 0) continue;
+        std::string stem = sourceStem(file);
+        const char* sub = subsystemOf(stem);
+        add(bySubsystem[sub ? sub : "core & libraries"], kind, size);
+        if (sub) add(byFile[std::string(sub) + "/" + stem], kind, size);
+    }
+    fclose(f);
+    if (!inMap) {
+        fprintf(stderr, "%s: no memory map section, not a GNU ld map?\n", argv[1]);
+        return 1;
+    }
+
+    Usage total = {};
+    printf("%s per subsystem from %s, %s\n", flashOnly ? "Flash" : "Flash & RAM", argv[1], format);
+    if (strcmp(format, "elf32-littlearm") != 0)
+        printf("HOST BUILD, not the SAMD21 firmware image: sizes are for this machine's code & flags and only rank\n"
+               "the subsystems. Run on the Arduino build's map for the board's numbers (see README)\n");
+    if (flashOnly) printf("RAM is not attributed to subsystems in this map\n");
+    printf("\n");
+    printRow("subsystem", NULL, flashOnly);
+    for (const auto& s : bySubsystem) {
+        const Usage& u = s.second;
+        printRow(s.first.c_str(), &u, flashOnly);
+        if (verbose) {
+            for (const auto& fu : byFile) {
+                if (fu.first.compare(0, s.first.size() + 1, s.first + "/") != 0) continue;
+                printRow(("  " + fu.first.substr(s.first.size() + 1)).c_str(), &fu.second, flashOnly);
+            }
+        }
+        total.text += u.text;
+        total.data += u.data;
+        total.bss += u.bss;
+    }
+    printRow("total", &total, flashOnly);
+    return 0;
+}
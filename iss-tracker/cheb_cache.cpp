@@ -0,0 +1,153 @@
+/*
+  cheb_cache.cpp - Chebyshev ephemeris cache fitting & evaluation
+ */
+#include "cheb_cache.h"
+
+// Observer-relative NED position through the full propagation chain
+// Returns the source's error code, posNED is only set on success
+int directNED(EciSource src, void* ctx, const ObserverFrame& obs, double unixSec, Vec3& posNED) {
+    Vec3 posECI;
+    int err = src(ctx, unixSec, posECI);
+    if (err) return err;
+    double era = UtcTime::fromUnixSeconds(unixSec).era();
+    posNED = obs.ecef2ned(eci2ecef(posECI, -era));
+    return 0;
+}
+
+// Evaluate one fitted component at normalized time x in [-1,1] with Clenshaw's recurrence
+static float clenshaw(const float* c, float x) {
+    float b1 = 0, b2 = 0;
+    float x2 = 2*x;
+    for (int k = CHEB_DEGREE; k >= 1; --k) {
+        float b0 = c[k] + x2*b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return c[0] + x*b1 - b2;
+}
+
+// Derivative d/dx of the fitted component, using d/dx T_k = k*U_(k-1) and the same recurrence over U
+static float clenshawDeriv(const float* c, float x) {
+    float b1 = 0, b2 = 0;
+    float x2 = 2*x;
+    for (int k = CHEB_DEGREE; k >= 1; --k) {
+        float b0 = k*c[k] + x2*b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return b1;
+}
+
+// Reset the cache to start fitting at startUTC_ms, e.g. after a TLE update
+void ChebCache::begin(EciSource _src, void* _ctx, const Vec3& _llaRef, uint64_t startUTC_ms) {
+    src = _src;
+    ctx = _ctx;
+    obs.init(_llaRef, DEGREES);
+    t0_ms = startUTC_ms;
+    firstSeg = 0;
+    nextSeg = 0;
+    maxErr = 0;
+    srcErr = 0;
+    fitSeg = -1;
+    fitStep = 0;
+    for (int i = 0; i < CHEB_N_SEGMENTS; ++i) seg[i].valid = false;
+}
+
+// Advance the fit of the next segment if there's a free slot by up to CHEB_EVALS_PER_TICK propagations,
+// dropping segments that are entirely in the past. A segment takes CHEB_DEGREE+1 node samples, each folded
+// straight into the DCT sums, then CHEB_DEGREE error checks, and is usable once those are done
+// Returns true if any work was done, false if the ring is full or src failed (see srcErr)
+bool ChebCache::fitNextSegment(uint64_t currUTC_ms) {
+    const int N = CHEB_DEGREE + 1;
+    const uint64_t segMs = uint64_t(CHEB_SEGMENT_S) * 1000;
+
+    int32_t currSeg = currUTC_ms > t0_ms ? int32_t((currUTC_ms - t0_ms) / segMs) : 0;
+    if (currSeg > firstSeg) firstSeg = currSeg;
+    if (nextSeg < firstSeg) nextSeg = firstSeg;
+    if (srcErr || nextSeg >= firstSeg + CHEB_N_SEGMENTS) return false;
+
+    // Start over if the segment being fitted has fallen into the past
+    if (fitSeg != nextSeg) {
+        fitSeg = nextSeg;
+        fitStep = 0;
+    }
+
+    ChebSegment& s = seg[nextSeg % CHEB_N_SEGMENTS];
+    double tMid = double(t0_ms) / 1e3 + (double(nextSeg) + 0.5) * CHEB_SEGMENT_S;
+    double half = 0.5 * CHEB_SEGMENT_S;
+
+    for (int e = 0; e < CHEB_EVALS_PER_TICK; ++e) {
+        if (fitStep < N) {
+            // Sample at Chebyshev node j and add its terms of the discrete Chebyshev transform, with
+            // T_m(x) from the recurrence T_(m+1) = 2x*T_m - T_(m-1) rather than a cos() per term
+            int j = fitStep;
+            if (j == 0) memset(fitSum, 0, sizeof(fitSum));
+            double x = cos(PI * (j + 0.5) / N);
+            Vec3 ned;
+            if ((srcErr = directNED(src, ctx, obs, tMid + half*x, ned))) return false;
+            double f[3] = {ned.x, ned.y, ned.z};
+            double tPrev = 1, t = x;
+            for (int k = 0; k < 3; ++k) fitSum[k][0] += f[k];
+            for (int m = 1; m < N; ++m) {
+                for (int k = 0; k < 3; ++k) fitSum[k][m] += f[k] * t;
+                double tNext = 2*x*t - tPrev;
+                tPrev = t;
+                t = tNext;
+            }
+            if (++fitStep == N) {
+                for (int m = 0; m < N; ++m)
+                    for (int k = 0; k < 3; ++k)
+                        s.c[k][m] = float(fitSum[k][m] * (m == 0 ? 1.0 : 2.0) / N);
+                fitErr = 0;
+            }
+        } else {
+            // Measure fit error midway between nodes, where interpolation error peaks
+            int j = fitStep - N;
+            double x = cos(PI * (j + 1.0) / N);
+            Vec3 ned;
+            if ((srcErr = directNED(src, ctx, obs, tMid + half*x, ned))) return false;
+            float xf = float(x);
+            Vec3 fit = {clenshaw(s.c[0], xf), clenshaw(s.c[1], xf), clenshaw(s.c[2], xf)};
+            fitErr = fmax(fitErr, norm(fit - ned));
+            if (++fitStep == 2*N - 1) {
+                s.maxErr = float(fitErr);
+                s.valid = fitErr <= CHEB_MAX_ERR_M;
+                if (s.maxErr > maxErr) maxErr = s.maxErr;
+                nextSeg++;
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+// Evaluate the cached NED position at UTC_ms
+// Returns false if that time isn't covered by a valid segment, in which case use directNED instead
+bool ChebCache::eval(uint64_t UTC_ms, Vec3& posNED) {
+    if (UTC_ms < t0_ms) return false;
+    const uint64_t segMs = uint64_t(CHEB_SEGMENT_S) * 1000;
+    uint64_t dt_ms = UTC_ms - t0_ms;
+    int32_t k = int32_t(dt_ms / segMs);
+    if (k < firstSeg || k >= nextSeg) return false;
+
+    ChebSegment& s = seg[k % CHEB_N_SEGMENTS];
+    if (!s.valid) return false;
+
+    float x = float(int32_t(dt_ms - uint64_t(k) * segMs)) / (0.5f * segMs) - 1.0f;
+    posNED = Vec3{clenshaw(s.c[0], x), clenshaw(s.c[1], x), clenshaw(s.c[2], x)};
+    return true;
+}
+
+// Evaluate the cached NED position & velocity [m/s] at UTC_ms
+bool ChebCache::eval(uint64_t UTC_ms, Vec3& posNED, Vec3& velNED) {
+    if (!eval(UTC_ms, posNED)) return false;
+    const uint64_t segMs = uint64_t(CHEB_SEGMENT_S) * 1000;
+    uint64_t dt_ms = UTC_ms - t0_ms;
+    int32_t k = int32_t(dt_ms / segMs);
+    ChebSegment& s = seg[k % CHEB_N_SEGMENTS];
+
+    float x = float(int32_t(dt_ms - uint64_t(k) * segMs)) / (0.5f * segMs) - 1.0f;
+    float dxdt = 2.0f / CHEB_SEGMENT_S;
+    velNED = Vec3{clenshawDeriv(s.c[0], x) * dxdt, clenshawDeriv(s.c[1], x) * dxdt, clenshawDeriv(s.c[2], x) * dxdt};
+    return true;
+}
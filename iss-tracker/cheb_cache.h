@@ -0,0 +1,54 @@
+/*
+  cheb_cache.h - Rolling cache of piecewise Chebyshev fits to the observer-relative (NED) satellite position
+    Segments are fitted from the full propagation chain after a TLE update, a few propagations per call so no
+    single call holds off the stepper for long, then each loop tick only needs three short Clenshaw recurrences
+    instead of propagation + frame conversions.
+ */
+#pragma once
+#include <Arduino.h>
+#include "coord.h"
+#include "orbit_utils.h"
+
+#define CHEB_DEGREE      12       // Polynomial degree per component
+#define CHEB_SEGMENT_S   1800     // Time span covered by one segment [s]
+#define CHEB_N_SEGMENTS  6        // Segments held at once (window = CHEB_N_SEGMENTS*CHEB_SEGMENT_S)
+#define CHEB_MAX_ERR_M   10.0     // Segments with a larger measured fit error are never used
+#define CHEB_EVALS_PER_TICK 2     // Propagations per fitNextSegment() call, ~10 ms on the M0
+
+// Callback providing the ECI position at a fractional unix time [s], so the cache works with any propagator.
+// Fractional seconds matter here: a 1 ms sampling error is ~8 m of along-track position
+// Returns 0 on success, else the propagator's error code
+typedef int (*EciSource)(void* ctx, double unixSec, Vec3& posECI);
+
+// Chebyshev coefficients for one time segment
+struct ChebSegment {
+    float c[3][CHEB_DEGREE+1];
+    float maxErr;       // Largest deviation from the direct path at the check points [m]
+    bool valid;
+};
+
+// Ring of segments covering [t0 + k*CHEB_SEGMENT_S, ...) for consecutive segment indices k
+struct ChebCache {
+    EciSource src;
+    void* ctx;
+    ObserverFrame obs;
+    uint64_t t0_ms;
+    int32_t firstSeg;   // Oldest segment index still held
+    int32_t nextSeg;    // Next segment index to fit
+    float maxErr;       // Worst fit error across all segments fitted since begin() [m]
+    int srcErr;         // First error returned by src since begin(), no more segments are fitted once set
+    ChebSegment seg[CHEB_N_SEGMENTS];
+
+    // Partial fit of segment fitSeg: fitStep counts the nodes sampled, then the error checks done
+    int32_t fitSeg;
+    uint8_t fitStep;
+    double fitSum[3][CHEB_DEGREE+1];    // DCT sums over the nodes sampled so far
+    double fitErr;
+
+    void begin(EciSource src, void* ctx, const Vec3& llaRef, uint64_t startUTC_ms);
+    bool fitNextSegment(uint64_t currUTC_ms);
+    bool eval(uint64_t UTC_ms, Vec3& posNED);
+    bool eval(uint64_t UTC_ms, Vec3& posNED, Vec3& velNED);
+};
+
+int directNED(EciSource src, void* ctx, const ObserverFrame& obs, double unixSec, Vec3& posNED);
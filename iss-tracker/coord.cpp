@@ -9,150 +9,6 @@
  */
 #include "coord.h"
 
-void earthRad(const float& _lat, const bool& angle_unit, double& R_N, double& R_M)
-{
-    float lat = _lat;
-
-    if (angle_unit == DEGREES)
-      lat *= DEG_TO_RAD;
-
-    R_N = a / sqrt(1 - (ecc_sqrd * pow(sin(lat), 2)));
-    R_M = (a * (1 - ecc_sqrd)) / pow(1 - (ecc_sqrd * pow(sin(lat), 2)), 1.5);
-}
-
-// Convert Lat-Lon-Alt (LLA) position to ECEF position
-Vec3 lla2ecef(const Vec3& lla, const bool& angle_unit)
-{
-    double lat = lla.x;
-    double lon = lla.y;
-    double alt = lla.z;
-
-    double R_N, R_M;
-
-    earthRad(lat, angle_unit,R_N,R_M);
-
-    if (angle_unit == DEGREES)
-    {
-        lat *= DEG_TO_RAD;
-        lon *= DEG_TO_RAD;
-    }
-
-    return Vec3{(R_N + alt) * cos(lat) * cos(lon),
-                (R_N + alt)* cos(lat)* sin(lon),
-                ((1 - ecc_sqrd) * R_N + alt)* sin(lat)};
-}
-
-// Convert ECEF position to LLA position
-Vec3 ecef2lla(const Vec3& ecef, const bool& angle_unit)
-{
-    float x = ecef.x;
-    float y = ecef.y;
-    float z = ecef.z;
-
-    float x_sqrd = pow(x, 2);
-    float y_sqrd = pow(y, 2);
-
-    float lon = atan2(y, x);
-    float lat = 400;
-
-    float s = sqrt(x_sqrd + y_sqrd);
-    float beta = atan2(z, (1 - f) * s);
-    float mu_bar = atan2(z + (((ecc_sqrd * (1 - f)) / (1 - ecc_sqrd)) * a * pow(sin(beta), 3)),
-                        s - (ecc_sqrd * a * pow(cos(beta), 3)));
-    
-    size_t iter = 0;
-    while (abs(lat - mu_bar) > 1e-10)
-    {
-        lat  = mu_bar;
-        beta = atan2((1 - f) * sin(lat),
-                    cos(lat));
-        mu_bar = atan2(z + (((ecc_sqrd * (1 - f)) / (1 - ecc_sqrd)) * a * pow(sin(beta), 3)),
-                      s - (ecc_sqrd * a * pow(cos(beta), 3)));
-        iter++;
-        if (iter > 1e3) break;
-    }
-
-    lat = mu_bar;
-
-    float N = a / sqrt(1 - (ecc_sqrd * pow(sin(lat), 2)));
-    float h = (s * cos(lat)) + ((z + (ecc_sqrd * N * sin(lat))) * sin(lat)) - N;
-
-    if (angle_unit == DEGREES)
-    {
-        lat *= RAD_TO_DEG;
-        lon *= RAD_TO_DEG;
-    }
-
-    return Vec3{lat,lon,h};
-}
-
-// Calculate DCM to rotate between ECEF and local NED coordinates for a given LLA position
-Dcm ecef2ned_dcm(const Vec3& lla, const bool& angle_unit)
-{
-    float lat = lla.x;
-    float lon = lla.y;
-
-    if (angle_unit == DEGREES)
-    {
-        lat *= DEG_TO_RAD;
-        lon *= DEG_TO_RAD;
-    }
-
-    Dcm C = {};
-
-    C.x00 = -sin(lat) * cos(lon);
-    C.x01 = -sin(lat) * sin(lon);
-    C.x02 = cos(lat);
-
-    C.x10 = -sin(lon);
-    C.x11 = cos(lon);
-    C.x12 = 0;
-
-    C.x20 = -cos(lat) * cos(lon);
-    C.x21 = -cos(lat) * sin(lon);
-    C.x22 = -sin(lat);
-
-    return C;
-}
-
-// Convert position from ECEF frame to local NED frame at a given LLA reference position
-Vec3 ecef2ned(const Vec3& ecef,
-              const Vec3& lla_ref,
-              const bool& angle_unit)
-{
-    Vec3 ecef_ref = lla2ecef(lla_ref, angle_unit);
-    Dcm C        = ecef2ned_dcm(lla_ref, angle_unit);
-
-    return C * (ecef - ecef_ref);
-}
-
-// Convert position in NED to equivalent Azimuth, Elevation, & Range
-// Azimuth is defined as 0 degrees northward and increases clockwise
-// Azimuth & Elevation are returned in units of degrees
-Vec3 ned2AzElRng(const Vec3& ned) {
-    double horiz = sqrt(ned.x*ned.x + ned.y*ned.y);
-
-    double az = fmod((atan2(ned.y, ned.x) * RAD_TO_DEG) + 360, 360);
-    double el = atan2(-ned.z,horiz) * RAD_TO_DEG;
-    double rng = norm(ned);
-
-    return Vec3{az,el,rng}; 
-}
-
-// Convert Earth-Centered-Inertial (ECI) position to an ECEF position for a given Earth-Rotation-Angle
-Vec3 eci2ecef(Vec3 eci, double angle) {
-     Dcm eci2ecef = {
-      cos(angle),
-      sin(angle),
-      0,
-      -sin(angle),
-      cos(angle),
-      0,
-      0,0,1
-    };
-    return eci2ecef * eci;
-}
-
 // Compute spherical bearing between two Lat/Lon positions
 double calcBearing(double lat1, double lon1, double lat2, double lon2) {
     // Convert latitude and longitude to 
@@ -180,3 +36,17 @@ double calcBearing(double lat1, double lon1, double lat2, double lon2) {
 
     return bearing;
 }
+
+// Look angles of one ECEF position from many observers
+void lookAnglesMultiObserver(const Vec3& pos, const ObserverFrame* obs, size_t count, Vec3* aer) {
+    for (size_t i = 0; i < count; ++i)
+        aer[i] = obs[i].lookAngles(pos);
+}
+
+// Look angles of many ECEF positions from one observer
+// Rotates the whole batch into NED first, then converts in place
+void lookAnglesMultiTarget(const ObserverFrame& obs, const Vec3* pos, size_t count, Vec3* aer) {
+    mulDiff(obs.C, pos, obs.ecef, aer, count);
+    for (size_t i = 0; i < count; ++i)
+        aer[i] = ned2AzElRng(aer[i]);
+}
@@ -1,29 +1,207 @@
 /*
-  coord.h - coordinate frame conversion function declarations
+  coord.h - coordinate frame conversion functions
+    Templated on the scalar type (see math_utils.h); the Vec3/Dcm forms are the double instantiations.
+    ecef2lla needs cbrt and the full WGS84 dynamic range so it is only meant for double & float.
  */
 #pragma once
 #include <Arduino.h>
+#include "fast_math.h"
 #include "math_utils.h"
 #include "wgs84.h"
 
 const bool RADIANS = true;
 const bool DEGREES = false;
 
+// Prime-vertical & meridional radii of curvature at a latitude
+template <typename T>
+void earthRad(const T& _lat, const bool& angle_unit, T& R_N, T& R_M)
+{
+    T lat = _lat;
 
-void earthRad(const float& _lat, const bool& angle_unit, double& R_N, double& R_M);
+    if (angle_unit == DEGREES)
+      lat *= T(DEG_TO_RAD);
 
-Vec3 lla2ecef(const Vec3& lla, const bool& angle_unit);
+    T sinLat = sin(lat);
+    T den = 1 - T(ecc_sqrd) * sinLat*sinLat;
+    R_N = T(a) / sqrt(den);
+    R_M = T(a * (1 - ecc_sqrd)) / (den * sqrt(den));
+}
 
-Vec3 ecef2lla(const Vec3& ecef, const bool& angle_unit);
+// Convert Lat-Lon-Alt (LLA) position to ECEF position
+template <typename T>
+Vec3T<T> lla2ecef(const Vec3T<T>& lla, const bool& angle_unit)
+{
+    T lat = lla.x;
+    T lon = lla.y;
+    T alt = lla.z;
 
-Dcm ecef2ned_dcm(const Vec3& lla, const bool& angle_unit);
+    T R_N, R_M;
 
-Vec3 ecef2ned(const Vec3& ecef,
-              const Vec3& lla_ref,
-              const bool& angle_unit);
+    earthRad(lat, angle_unit,R_N,R_M);
 
-Vec3 ned2AzElRng(const Vec3& ned);
+    if (angle_unit == DEGREES)
+    {
+        lat *= T(DEG_TO_RAD);
+        lon *= T(DEG_TO_RAD);
+    }
 
-Vec3 eci2ecef(Vec3 eci, double angle);
+    T sinLat, cosLat, sinLon, cosLon;
+    sinCos(lat, sinLat, cosLat);
+    sinCos(lon, sinLon, cosLon);
+
+    return Vec3T<T>{(R_N + alt) * cosLat * cosLon,
+                    (R_N + alt)* cosLat* sinLon,
+                    (T(1 - ecc_sqrd) * R_N + alt)* sinLat};
+}
+
+// Convert ECEF position to LLA position
+// Closed-form solution from Vermeille, "An analytical method to transform geocentric into geodetic coordinates",
+// J. Geodesy 85 (2011). Exact to double precision, no iteration; valid everywhere except within ~43 km of the
+// Earth's center, where the ellipsoid's evolute makes the problem ill-posed
+template <typename T>
+Vec3T<T> ecef2lla(const Vec3T<T>& ecef, const bool& angle_unit)
+{
+    T x = ecef.x;
+    T y = ecef.y;
+    T z = ecef.z;
+
+    T xy_sqrd = x*x + y*y;
+    T xy = sqrt(xy_sqrd);
+
+    T p = xy_sqrd / T(a_sqrd);
+    T q = T(1 - ecc_sqrd) * z*z / T(a_sqrd);
+    T r6 = (p + q - T(ecc_4)) / 6;
+    T s = T(ecc_4) * p * q / (4 * r6*r6*r6);
+    T t = cbrt(1 + s + sqrt(s * (2 + s)));
+    T u = r6 * (1 + t + 1/t);
+    T v = sqrt(u*u + T(ecc_4) * q);
+    T w = T(ecc_sqrd) * (u + v - q) / (2 * v);
+    T k = sqrt(u + v + w*w) - w;
+    T D = k * xy / (k + T(ecc_sqrd));
+    T Dz = sqrt(D*D + z*z);
+
+    T lat = 2 * arcTan2(z, D + Dz);
+    T lon = arcTan2(y, x);
+    T h = (k + T(ecc_sqrd) - 1) / k * Dz;
+
+    if (angle_unit == DEGREES)
+    {
+        lat *= T(RAD_TO_DEG);
+        lon *= T(RAD_TO_DEG);
+    }
+
+    return Vec3T<T>{lat,lon,h};
+}
+
+// Calculate DCM to rotate between ECEF and local NED coordinates for a given LLA position
+template <typename T>
+DcmT<T> ecef2ned_dcm(const Vec3T<T>& lla, const bool& angle_unit)
+{
+    T lat = lla.x;
+    T lon = lla.y;
+
+    if (angle_unit == DEGREES)
+    {
+        lat *= T(DEG_TO_RAD);
+        lon *= T(DEG_TO_RAD);
+    }
+
+    T sinLat, cosLat, sinLon, cosLon;
+    sinCos(lat, sinLat, cosLat);
+    sinCos(lon, sinLon, cosLon);
+
+    DcmT<T> C = {};
+
+    C(0,0) = -sinLat * cosLon;
+    C(0,1) = -sinLat * sinLon;
+    C(0,2) = cosLat;
+
+    C(1,0) = -sinLon;
+    C(1,1) = cosLon;
+    C(1,2) = 0;
+
+    C(2,0) = -cosLat * cosLon;
+    C(2,1) = -cosLat * sinLon;
+    C(2,2) = -sinLat;
+
+    return C;
+}
+
+// Convert position from ECEF frame to local NED frame at a given LLA reference position
+template <typename T>
+Vec3T<T> ecef2ned(const Vec3T<T>& ecef,
+                  const Vec3T<T>& lla_ref,
+                  const bool& angle_unit)
+{
+    Vec3T<T> ecef_ref = lla2ecef(lla_ref, angle_unit);
+    DcmT<T> C         = ecef2ned_dcm(lla_ref, angle_unit);
+
+    return mulDiff(C, ecef, ecef_ref);
+}
+
+// Convert position in NED to equivalent Azimuth, Elevation, & Range
+// Azimuth is defined as 0 degrees northward and increases clockwise
+// Azimuth & Elevation are returned in units of degrees
+template <typename T>
+Vec3T<T> ned2AzElRng(const Vec3T<T>& ned) {
+    T horiz = sqrt(ned.x*ned.x + ned.y*ned.y);
+
+    T az = fmod((arcTan2(ned.y, ned.x) * T(RAD_TO_DEG)) + 360, T(360));
+    T el = arcTan2(-ned.z,horiz) * T(RAD_TO_DEG);
+    T rng = norm(ned);
+
+    return Vec3T<T>{az,el,rng};
+}
+
+// Rates of change of azimuth & elevation [deg/s] and range [m/s] from an NED position & velocity
+// Azimuth rate is unbounded straight overhead, where the horizontal range goes to zero
+template <typename T>
+Vec3T<T> ned2AzElRates(const Vec3T<T>& ned, const Vec3T<T>& nedVel) {
+    T horizSq = ned.x*ned.x + ned.y*ned.y;
+    T horiz = sqrt(horizSq);
+    T rngSq = horizSq + ned.z*ned.z;
+    T rng = sqrt(rngSq);
+
+    T horizDot = (ned.x*nedVel.x + ned.y*nedVel.y) / horiz;
+    T azDot = (ned.x*nedVel.y - ned.y*nedVel.x) / horizSq * T(RAD_TO_DEG);
+    T elDot = (ned.z*horizDot - horiz*nedVel.z) / rngSq * T(RAD_TO_DEG);
+    T rngDot = (ned.x*nedVel.x + ned.y*nedVel.y + ned.z*nedVel.z) / rng;
+
+    return Vec3T<T>{azDot,elDot,rngDot};
+}
+
+// Convert Earth-Centered-Inertial (ECI) position to an ECEF position for a given Earth-Rotation-Angle
+template <typename T>
+Vec3T<T> eci2ecef(const Vec3T<T>& eci, typename Identity<T>::type angle) {
+    T c, s;
+    sinCos(T(angle), s, c);
+    return rotZ(eci, c, s);
+}
 
 double calcBearing(double lat1, double lon1, double lat2, double lon2);
+
+// Fixed ground observer with its ECEF position & ECEF->NED rotation computed once
+// The setup is always done in double and rounded to T, so narrower types only pay for it in the per-fix path
+template <typename T>
+struct ObserverFrameT {
+    Vec3T<T> lla;
+    Vec3T<T> ecef;
+    DcmT<T> C;
+
+    // Precompute observer ECEF position & ECEF->NED rotation
+    void init(const Vec3& _lla, const bool& angle_unit, double scale = 1) {
+        lla = Vec3T<T>(_lla);
+        ecef = Vec3T<T>(lla2ecef(_lla, angle_unit) * scale);
+        C = dcmCast<T>(ecef2ned_dcm(_lla, angle_unit));
+    }
+    // Convert position from ECEF frame to this observer's NED frame
+    Vec3T<T> ecef2ned(const Vec3T<T>& pos) const { return mulDiff(C, pos, ecef); }
+    Vec3T<T> ecefVel2ned(const Vec3T<T>& vel) const { return C * vel; }
+    // Azimuth, Elevation (degrees) & Range of an ECEF position as seen by this observer
+    Vec3T<T> lookAngles(const Vec3T<T>& pos) const { return ned2AzElRng(mulDiff(C, pos, ecef)); }
+};
+
+typedef ObserverFrameT<double> ObserverFrame;
+
+void lookAnglesMultiObserver(const Vec3& ecef, const ObserverFrame* obs, size_t count, Vec3* aer);
+void lookAnglesMultiTarget(const ObserverFrame& obs, const Vec3* ecef, size_t count, Vec3* aer);
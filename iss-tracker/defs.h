@@ -21,8 +21,9 @@
 // TLE Server & Query Info
 #define HEADER_STR  "ISS (ZARYA)"
 #define TLE_LEN     69
-#define MAX_BUFFER  1024
+#define RCV_CHUNK   64  // Bytes read from the TLE socket per parser call
 #define SERVER      "celestrak.org"
+#define NTP_SERVER  "time.nist.gov"
 #define QUERY       "/NORAD/elements/gp.php?CATNR=25544&FORMAT=TLE"
 
 // Misc. Flags
@@ -31,6 +32,37 @@
 #define WAIT_FOR_SERIAL             false
 #define DO_PRINT_DEBUG              false
 
+// If set true, propagates with SGP4 (J2 & drag) instead of the two-body Orbit model
+#define USE_SGP4                    false
+
+// If set true, fits Chebyshev polynomials to the observer-relative position after each TLE update
+// and evaluates those each tick instead of running the full propagation chain
+#define USE_EPHEM_CACHE             true
+
+// If set true, the stepper follows the target continuously using its Az/El rates (velocity feed-forward)
+// Otherwise a new step target is set only once the previous one has been reached
+#define TRACK_FEED_FORWARD          true
+
+// If set true, the display shows the ground track over the next orbit on a world map
+// instead of the clock & Az/El
+#define DISPLAY_GROUND_TRACK        false
+
+// If set true, times the hot-path stages into latency histograms, dumped by sending 'p' over Serial ('r' resets)
+// When false the instrumentation compiles out entirely
+#ifndef ENABLE_PROFILING
+#define ENABLE_PROFILING            false
+#endif
+
+// If set true, no heap allocation may happen once setup() has returned. Every malloc/free after that is
+// trapped: counted & reported over Serial by the stats task, which runs whenever ZERO_HEAP is set, or with
+// ZERO_HEAP_HALT the firmware stops in the trap so a debugger shows the offending call stack
+#ifndef ZERO_HEAP
+#define ZERO_HEAP                   false
+#endif
+#ifndef ZERO_HEAP_HALT
+#define ZERO_HEAP_HALT              false
+#endif
+
 // If set true, will not attempt to automatically point north at startup
 // Assumes that pedestal is manually pointed north before startup
 #define DO_BYPASS_COMPASS           false
@@ -40,9 +72,27 @@
 #define TRUE_NORTH_OFFSET_DEG   -3.73
 
 // Refresh durations
-#define TIME_REFRESH_DELAY_MIN 10
+#define NTP_MIN_POLL_S         16      // NTP poll interval while the drift estimate settles
+#define NTP_MAX_POLL_S         2048    // and once it predicts the offset to within a millisecond
 #define TLE_REFRESH_DELAY_MIN  60
 #define ORBIT_REFRESH_DELAY_MS 500
+#define SNAPSHOT_MAX_AGE_H     72      // Saved elements with a TLE epoch older than this are not used for a warm start
+
+// Boot-time network retries
+#define WIFI_RETRY_DELAY_MS    2000
+#define NTP_RETRY_DELAY_MS     2000
+#define NTP_MAX_UNANSWERED     4       // Unanswered requests before NTP_SERVER is looked up again
+#define BOOT_NTP_WAIT_MS       5000    // Warm start: longest setup() waits for NTP before leaving it to ntpTask
+#define TLE_RETRY_DELAY_MS     5000    // Celestrak query retry until the first TLE arrives
+
+// Scheduler task periods
+#define WIFI_TASK_MS            1000
+#define WIFI_CONNECT_TIMEOUT_MS 15000   // Restart a reconnect attempt that hasn't completed in this time
+#define NET_POLL_MS             50      // NTP & TLE response polling
+#define EPHEM_TASK_MS           1000
+#define DISPLAY_TASK_MS         1000
+#define STATS_TASK_MS           10000
+#define PROFILE_TASK_MS         200     // Serial command polling for the profiler dump
 
 // Stepper Motor Specs
 #define STEPS_PER_REV (2038*4)
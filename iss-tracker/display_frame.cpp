@@ -0,0 +1,172 @@
+/*
+  display_frame.cpp - Dirty-region tracking & partial transfers for the SH1107 status screen
+ */
+#include "display_frame.h"
+
+void OledRegions::begin() {
+    clear();
+    nBytes = 0;
+    nTransfers = 0;
+    nFlushes = 0;
+}
+
+void OledRegions::clear() {
+    memset(lo, 0xFF, sizeof(lo));
+    memset(hi, 0, sizeof(hi));
+}
+
+void OledRegions::markAll() {
+    memset(lo, 0, sizeof(lo));
+    memset(hi, OLED_COLS - 1, sizeof(hi));
+}
+
+// Mark a rectangle in rotated display coordinates, mapped to native pages & columns as GFX rotates pixels
+void OledRegions::mark(const Adafruit_SH1107& d, int16_t x, int16_t y, int16_t w, int16_t h) {
+    int16_t x0 = x, y0 = y, x1 = x + w - 1, y1 = y + h - 1;
+    int16_t c0, c1, r0, r1;     // Native column & row ranges
+    switch (d.getRotation()) {
+    case 1:
+        c0 = OLED_COLS - 1 - y1; c1 = OLED_COLS - 1 - y0; r0 = x0; r1 = x1;
+        break;
+    case 2:
+        c0 = OLED_COLS - 1 - x1; c1 = OLED_COLS - 1 - x0; r0 = OLED_PAGES*8 - 1 - y1; r1 = OLED_PAGES*8 - 1 - y0;
+        break;
+    case 3:
+        c0 = y0; c1 = y1; r0 = OLED_PAGES*8 - 1 - x1; r1 = OLED_PAGES*8 - 1 - x0;
+        break;
+    default:
+        c0 = x0; c1 = x1; r0 = y0; r1 = y1;
+    }
+    c0 = constrain(c0, 0, OLED_COLS - 1);
+    c1 = constrain(c1, 0, OLED_COLS - 1);
+    r0 = constrain(r0, 0, OLED_PAGES*8 - 1);
+    r1 = constrain(r1, 0, OLED_PAGES*8 - 1);
+
+    for (int16_t p = r0 / 8; p <= r1 / 8; ++p) {
+        if (c0 < lo[p]) lo[p] = c0;
+        if (c1 > hi[p]) hi[p] = c1;
+    }
+}
+
+bool OledRegions::dirty() const {
+    for (uint8_t p = 0; p < OLED_PAGES; ++p) {
+        if (lo[p] <= hi[p]) return true;
+    }
+    return false;
+}
+
+// Send the dirty span of each page from the display buffer. Returns the bytes sent, 0 if nothing was dirty
+int OledRegions::flush(Adafruit_SH1107& d, TwoWire& wire) {
+    if (!dirty()) return 0;
+    const uint8_t* buf = d.getBuffer();
+    uint32_t bytes0 = nBytes;
+
+    wire.setClock(OLED_CLK_DURING);
+    for (uint8_t p = 0; p < OLED_PAGES; ++p) {
+        if (lo[p] > hi[p]) continue;
+
+        // Page & column address
+        wire.beginTransmission(OLED_ADDR);
+        wire.write(0x00);
+        wire.write(0xB0 | p);
+        wire.write(0x10 | (lo[p] >> 4));
+        wire.write(lo[p] & 0x0F);
+        wire.endTransmission();
+        nBytes += 5;
+        nTransfers++;
+
+        // Column data, the column address auto-increments
+        const uint8_t* ptr = buf + p*OLED_COLS + lo[p];
+        uint8_t remaining = hi[p] - lo[p] + 1;
+        while (remaining) {
+            uint8_t n = remaining < OLED_I2C_CHUNK ? remaining : OLED_I2C_CHUNK;
+            wire.beginTransmission(OLED_ADDR);
+            wire.write(0x40);
+            wire.write(ptr, n);
+            wire.endTransmission();
+            nBytes += n + 2;
+            nTransfers++;
+            ptr += n;
+            remaining -= n;
+        }
+    }
+    wire.setClock(OLED_CLK_AFTER);
+
+    clear();
+    nFlushes++;
+    return int(nBytes - bytes0);
+}
+
+void TextField::begin(int16_t _x, int16_t _y, uint8_t _size) {
+    x = _x;
+    y = _y;
+    size = _size;
+    len = 0;
+    text[0] = '\0';
+}
+
+// Draw the cells of newText that differ from what is shown, blanking any left over from longer text.
+// Returns the number of cells drawn
+int TextField::update(Adafruit_SH1107& d, OledRegions& regions, const char* newText, bool redrawAll) {
+    uint8_t n = strnlen(newText, FIELD_MAX_LEN);
+    uint8_t span = n > len ? n : len;
+    int cellW = CHAR_W * size, cellH = CHAR_H * size;
+    int drawn = 0;
+
+    for (uint8_t i = 0; i < span; ++i) {
+        char c = i < n ? newText[i] : ' ';
+        if (!redrawAll && i < len && text[i] == c) continue;
+        if (redrawAll && c == ' ') continue;    // Already blank after a clear
+        d.drawChar(x + i*cellW, y, c, SH110X_WHITE, SH110X_BLACK, size);
+        regions.mark(d, x + i*cellW, y, cellW, cellH);
+        drawn++;
+    }
+    memcpy(text, newText, n);
+    text[n] = '\0';
+    len = n;
+    return drawn;
+}
+
+// "<label><value>" to one decimal, as "%s%03.1f" prints it but without the float formatter, which allocates
+// from the heap in newlib & is slow without an FPU. Az/El never exceed 999.9, the clamp only bounds the field
+static void formatTenths(char* buf, size_t len, const char* label, double v) {
+    long t = lround(fabs(v) * 10);
+    if (t < 0 || t > 9999) t = 9999;
+    snprintf(buf, len, "%s%s%ld.%ld", label, signbit(v) ? "-" : "", t / 10, t % 10);
+}
+
+void StatusScreen::begin() {
+    time.begin(1, 2, 3);
+    wday.begin(98, 2, 1);
+    date.begin(98, 16, 1);
+    az.begin(0, 32, 2);
+    el.begin(0, 48, 2);
+    regions.begin();
+    valid = false;
+}
+
+// Render the clock & Az/El and send whatever changed. Returns the I2C bytes sent, 0 when nothing changed
+int StatusScreen::update(Adafruit_SH1107& d, TwoWire& wire, int hh, int mm, const char* wdayStr, int mon, int dd,
+                         double azDeg, double elDeg) {
+    char buf[FIELD_MAX_LEN + 1];
+    bool redrawAll = !valid;
+    if (redrawAll) {
+        d.clearDisplay();
+        d.writeFastHLine(0, 28, d.width(), SH110X_WHITE);   // Dividing line
+        regions.markAll();
+    }
+
+    // Time in "hh:mm", date in "Www MM/dd", then Az/El
+    snprintf(buf, sizeof(buf), "%02i:%02i", hh, mm);
+    time.update(d, regions, buf, redrawAll);
+    wday.update(d, regions, wdayStr, redrawAll);
+    snprintf(buf, sizeof(buf), "%02i/%02i", mon, dd);
+    date.update(d, regions, buf, redrawAll);
+    formatTenths(buf, sizeof(buf), "Az:", azDeg);
+    az.update(d, regions, buf, redrawAll);
+    formatTenths(buf, sizeof(buf), "El:", elDeg);
+    el.update(d, regions, buf, redrawAll);
+
+    valid = true;
+    return regions.flush(d, wire);
+}
@@ -0,0 +1,66 @@
+/*
+  display_frame.h - Change tracking & partial I2C transfers for the SH1107 status screen
+    Text is laid out in fixed-pitch fields and only character cells whose glyph changed are redrawn. Each
+    redraw marks the touched columns of the affected 8-row pages, and flush() sends just those spans, writing
+    the panel directly rather than through display(), which pushes the full 1 KB frame after a clear.
+    Nothing is sent when no visible character changed.
+ */
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+
+#define OLED_ADDR           0x3C
+#define OLED_PAGES          16      // Native panel is 64 columns x 128 rows in 8-row pages
+#define OLED_COLS           64
+#define OLED_I2C_CHUNK      31      // Data bytes per transaction after the control byte (32-byte Wire buffer)
+#define OLED_CLK_DURING     400000  // Bus clock while transferring, as the SH110X library uses
+#define OLED_CLK_AFTER      100000
+
+#define FIELD_MAX_LEN       12
+#define CHAR_W              6       // Classic GFX font cell at text size 1
+#define CHAR_H              8
+
+// Dirty column span of each native page, and the traffic sent so far
+struct OledRegions {
+    uint8_t lo[OLED_PAGES];     // lo > hi when the page is clean
+    uint8_t hi[OLED_PAGES];
+    uint32_t nBytes;            // I2C bytes including address bytes
+    uint32_t nTransfers;
+    uint32_t nFlushes;          // flush() calls that sent anything
+
+    void begin();
+    void clear();
+    void markAll();
+    void mark(const Adafruit_SH1107& d, int16_t x, int16_t y, int16_t w, int16_t h);
+    bool dirty() const;
+    int flush(Adafruit_SH1107& d, TwoWire& wire);
+};
+
+// One line of fixed-pitch text that redraws only the cells whose character changed
+struct TextField {
+    int16_t x, y;
+    uint8_t size;
+    uint8_t len;
+    char text[FIELD_MAX_LEN + 1];
+
+    void begin(int16_t x, int16_t y, uint8_t size);
+    int update(Adafruit_SH1107& d, OledRegions& regions, const char* newText, bool redrawAll);
+};
+
+// Clock, date & Az/El layout shown while tracking
+struct StatusScreen {
+    TextField time;
+    TextField wday;
+    TextField date;
+    TextField az;
+    TextField el;
+    OledRegions regions;
+    bool valid;                 // Panel shows this screen, cleared when something else draws over it
+
+    void begin();
+    void invalidate() { valid = false; }
+    int update(Adafruit_SH1107& d, TwoWire& wire, int hh, int mm, const char* wdayStr, int mon, int dd,
+               double azDeg, double elDeg);
+};
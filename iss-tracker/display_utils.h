@@ -8,6 +8,8 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SH110X.h>
 #include "TimeLib.h"
+#include "display_frame.h"
+#include "map_screen.h"
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -15,9 +17,17 @@
 // Create display object
 Adafruit_SH1107 display = Adafruit_SH1107(HEIGHT, WIDTH, &Wire);
 
+// Tracks what the clock & Az/El screen last sent so updates only transfer changed cells
+StatusScreen statusScreen;
+
+// Ground-track map, the alternative to the status screen
+MapScreen mapScreen;
+
 // Clear display contents, set text size, and set cursor location
 void resetDisplay(int16_t x, int16_t y, uint8_t textSize=1, bool doRefresh=false) {
     display.clearDisplay();
+    statusScreen.invalidate();
+    mapScreen.invalidate();
     display.setTextSize(textSize);
     display.setTextColor(SH110X_WHITE);
     display.setCursor(x,y);
@@ -28,6 +38,8 @@ void resetDisplay(int16_t x, int16_t y, uint8_t textSize=1, bool doRefresh=false
 // Clear display contents and refresh
 void clearDisplay() {
     display.clearDisplay();
+    statusScreen.invalidate();
+    mapScreen.invalidate();
     display.display();
 }
 
@@ -36,29 +48,12 @@ int beginDisplay() {
     return display.begin(0x3C, true); // Address 0x3C default
 }
 
-// Display current time and ISS Azimuth & Elevation
+// Display current time and ISS Azimuth & Elevation. Only the character cells that changed are sent
 void displayCurrTime(double az, double el) {
-    display.clearDisplay();
-
-    // Display Time in "hh:mm" format
-    display.setCursor(1,2);
-    display.setTextSize(3);
-    display.printf("%02i:%02i",hour(),minute());
-
-    // Dividing Line
-    display.writeFastHLine(0,28,WIDTH,SH110X_WHITE);
-
-    // Display Date in "Www MM/dd" format
-    display.setTextSize(1);
-    display.setCursor(98,2);
-    display.print(dayShortStr(weekday()));
-    display.setCursor(98,16);
-    display.printf("%02i/%02i",month(),day());
-
-    // Display ISS Az/El
-    display.setCursor(0,32);
-    display.setTextSize(2);
-    display.printf("Az:%03.1f\nEl:%03.1f",az,el);
+    statusScreen.update(display, Wire, hour(), minute(), dayShortStr(weekday()), month(), day(), az, el);
+}
 
-    display.display();
+// Display the ground track with the satellite's current position. The map is only redrawn with a new track
+void displayGroundTrack(OrbitModel& orb, uint64_t UTC_ms) {
+    mapScreen.update(display, Wire, orb, UtcTime::fromUnixMs(UTC_ms));
 }
@@ -0,0 +1,153 @@
+/*
+  fast_math.h - Combined sin/cos & atan2 kernels for the coordinate and orbit code
+    The math core calls sinCos() & arcTan2() wherever it needs both trig values of one angle or a quadrant-correct
+    arctangent. By default these are libm (sin, cos, atan2). With FAST_TRIG set, the double & float forms switch to
+    the polynomial kernels below, which share one range reduction between sin & cos and skip libm's large-argument
+    and special-case paths; other scalar types (fixed point) keep their own overloads.
+
+    Kernels, with max errors vs long double libm as checked by bench_trig (2^24 random samples per range):
+      fastSinCos(double)  2-part Cody-Waite reduction to [-pi/4, pi/4] for |x| <= 2^19 pi/2, degree 13/14 fdlibm
+                          minimax polynomials: 1.6 ulp, 1.8e-16 absolute for |x| <= 1024
+      fastSinCos(float)   3-part reduction for |x| <= 2^12 pi/2, degree 9/8 polynomials in float: 1.5 ulp for
+                          |x| <= pi; 7.4e-8 absolute for |x| <= 1024, where results near the zeros of sin & cos
+                          can be off by ~|x| 2^-48 (tens of ulps of a tiny value)
+      fastAtan2(double)   octant reduction to |t| <= tan(pi/8), degree 23 odd fdlibm polynomial: 2.7 ulp
+      fastAtan2(float)    same reduction, degree 11 odd polynomial in float: 2.6 ulp
+    Outside the reduction range the kernels fall back to libm, so the results stay correct, just not fast.
+ */
+#pragma once
+#include <Arduino.h>
+
+// Use the polynomial kernels for double & float trig in the math core
+#ifndef FAST_TRIG
+#define FAST_TRIG false
+#endif
+
+// Coefficients & reduction constants per floating-point type
+template <typename T> struct TrigPoly;
+
+template <> struct TrigPoly<double> {
+    // pi/2 split so k * PIO2_HI is exact for |k| < 2^20
+    static constexpr double PIO2_HI  = 1.57079632673412561417e+00;
+    static constexpr double PIO2_LO  = 6.07710050650619224932e-11;
+    static constexpr double TWO_OPI  = 6.36619772367581382433e-01;
+    static constexpr double MAX_RED  = 823549.6;    // 2^19 * pi/2
+    // fdlibm __kernel_sin / __kernel_cos, |x| <= pi/4
+    static constexpr double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                            S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                            S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+    static constexpr double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                            C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                            C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+    // fdlibm atan, |t| <= 7/16
+    static constexpr double AT0 = 3.33333333333329318027e-01, AT1 = -1.99999999998764832476e-01,
+                            AT2 = 1.42857142725034663711e-01, AT3 = -1.11111104054623557880e-01,
+                            AT4 = 9.09088713343650656196e-02, AT5 = -7.69187620504482999495e-02,
+                            AT6 = 6.66107313738753120669e-02, AT7 = -5.83357013379057348645e-02,
+                            AT8 = 4.97687799461593236017e-02, AT9 = -3.65315727442169155270e-02,
+                            AT10 = 1.62858201153657823623e-02;
+    // pi/4, pi/2 & pi as head + tail, so the octant reflections don't add a rounding of the constant
+    static constexpr double PIO4 = 7.85398163397448278999e-01, PIO4_LO = 3.06161699786838301793e-17;
+    static constexpr double PIO2 = 1.57079632679489655800e+00, PIO2_TAIL = 6.12323399573676603587e-17;
+    static constexpr double PI_  = 3.14159265358979311600e+00, PI_LO = 1.22464679914735317720e-16;
+    static constexpr double TAN_PIO8 = 4.14213562373095145475e-01;
+
+    static double reduce(double x, double k) { return (x - k*PIO2_HI) - k*PIO2_LO; }
+
+    static double sinPoly(double x, double z) { return x + x*z*(S1 + z*(S2 + z*(S3 + z*(S4 + z*(S5 + z*S6))))); }
+    static double cosPoly(double z) { return 1 - 0.5*z + z*z*(C1 + z*(C2 + z*(C3 + z*(C4 + z*(C5 + z*C6))))); }
+    static double atanPoly(double t) {
+        double z = t*t, w = z*z;
+        double s1 = z*(AT0 + w*(AT2 + w*(AT4 + w*(AT6 + w*(AT8 + w*AT10)))));
+        double s2 = w*(AT1 + w*(AT3 + w*(AT5 + w*(AT7 + w*AT9))));
+        return t - t*(s1 + s2);
+    }
+};
+
+template <> struct TrigPoly<float> {
+    // pi/2 in three parts (Cody-Waite) so k * PIO2_HI & k * PIO2_MID are exact for |k| < 2^12
+    static constexpr float PIO2_HI  = 1.5703125f;
+    static constexpr float PIO2_MID = 4.837512969970703125e-4f;
+    static constexpr float PIO2_LO  = 7.54978995489188216e-8f;
+    static constexpr float TWO_OPI  = 0.636619772f;
+    static constexpr float MAX_RED  = 6433.98f;     // 2^12 * pi/2
+    // FreeBSD __kernel_sindf / __kernel_cosdf, |x| <= pi/4
+    static constexpr float S1 = -0.166666666416f, S2 = 0.0083333293858f, S3 = -0.000198393348361f,
+                           S4 = 0.0000027183114940f;
+    static constexpr float C0 = -0.499999997251f, C1 = 0.0416666233237f, C2 = -0.00138867637746f,
+                           C3 = 0.0000243904487963f;
+    // fdlibm atanf, |t| <= 7/16
+    static constexpr float AT0 = 3.3333328366e-01f, AT1 = -1.9999158382e-01f, AT2 = 1.4253635705e-01f,
+                           AT3 = -1.0648017377e-01f, AT4 = 6.1687607318e-02f;
+    static constexpr float PIO4 = 0.785398185f, PIO4_LO = -2.18556949e-8f;
+    static constexpr float PIO2 = 1.57079637f,  PIO2_TAIL = -4.37113883e-8f;
+    static constexpr float PI_  = 3.14159274f,  PI_LO = -8.74227766e-8f;
+    static constexpr float TAN_PIO8 = 0.414213562f;
+
+    static float reduce(float x, float k) { return ((x - k*PIO2_HI) - k*PIO2_MID) - k*PIO2_LO; }
+
+    static float sinPoly(float x, float z) { return x + x*z*(S1 + z*(S2 + z*(S3 + z*S4))); }
+    static float cosPoly(float z) { return 1 + z*(C0 + z*(C1 + z*(C2 + z*C3))); }
+    static float atanPoly(float t) {
+        float z = t*t, w = z*z;
+        float s1 = z*(AT0 + w*(AT2 + w*AT4));
+        float s2 = w*(AT1 + w*AT3);
+        return t - t*(s1 + s2);
+    }
+};
+
+// sin & cos of one angle from a single quadrant reduction
+template <typename T>
+void fastSinCos(T x, T& s, T& c) {
+    typedef TrigPoly<T> P;
+    if (!(fabs(x) <= P::MAX_RED)) {
+        s = sin(x);
+        c = cos(x);
+        return;
+    }
+    T kf = T(x * P::TWO_OPI);
+    kf = kf < 0 ? T(int32_t(kf - T(0.5))) : T(int32_t(kf + T(0.5)));
+    int32_t k = int32_t(kf);
+    T r = P::reduce(x, kf);
+    T z = r*r;
+    T sr = P::sinPoly(r, z), cr = P::cosPoly(z);
+    switch (k & 3) {
+        case 0: s = sr;  c = cr;  break;
+        case 1: s = cr;  c = -sr; break;
+        case 2: s = -sr; c = -cr; break;
+        default: s = -cr; c = sr; break;
+    }
+}
+
+// Quadrant-correct arctangent of y/x from an octant reduction
+template <typename T>
+T fastAtan2(T y, T x) {
+    typedef TrigPoly<T> P;
+    T ax = fabs(x), ay = fabs(y);
+    if (!(ax < INFINITY && ay < INFINITY) || (ax == 0 && ay == 0)) return atan2(y, x);
+
+    // atan of the ratio <= 1 in the first octant, then reflect
+    bool swap = ay > ax;
+    T t = swap ? ax / ay : ay / ax;
+    T a = t > P::TAN_PIO8 ? P::PIO4 + (P::PIO4_LO + P::atanPoly((t - 1) / (t + 1))) : P::atanPoly(t);
+    if (swap) a = (P::PIO2 - a) + P::PIO2_TAIL;
+    if (x < 0) a = (P::PI_ - a) + P::PI_LO;
+    return y < 0 || (y == 0 && signbit(y)) ? -a : a;
+}
+
+// Dispatch used by the math core; fixed point & other scalars provide their own sin/cos/atan2 or sinCos overloads
+template <typename T>
+void sinCos(T x, T& s, T& c) {
+    s = sin(x);
+    c = cos(x);
+}
+
+template <typename T>
+T arcTan2(T y, T x) { return atan2(y, x); }
+
+#if FAST_TRIG
+inline void sinCos(double x, double& s, double& c) { fastSinCos(x, s, c); }
+inline void sinCos(float x, float& s, float& c) { fastSinCos(x, s, c); }
+inline double arcTan2(double y, double x) { return fastAtan2(y, x); }
+inline float arcTan2(float y, float x) { return fastAtan2(y, x); }
+#endif
@@ -0,0 +1,193 @@
+/*
+  fixed_point.h - Signed 64-bit Q-format scalar for the templated math core
+    FixedQ<F> keeps F fractional bits; products & quotients go through 128-bit intermediates built from
+    32-bit halves, so nothing needs __int128 or an FPU. sqrt is bitwise, sin/cos/atan2 are 30-step CORDIC
+    in Q30. Fixed (Q39.24) is meant for the ECI -> az/el pointing chain in kilometres: squares stay in range
+    out to ~740,000 km, resolution is 0.06 mm & 60 nrad. In metres the squared range of a satellite on the far
+    side of the Earth overflows. It is too coarse for orbit propagation, which should stay in double.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define CORDIC_ITERS    30
+#define CORDIC_BITS     30
+#define CORDIC_PI       3373259426LL    // pi in Q30
+#define CORDIC_TWO_PI   6746518852LL
+#define CORDIC_HALF_PI  1686629713LL
+#define CORDIC_GAIN     652032874LL     // prod 1/sqrt(1 + 2^-2i) in Q30
+
+static const int64_t cordicAtan[CORDIC_ITERS] = {
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437, 4194283, 2097149,
+    1048576, 524288, 262144, 131072, 65536, 32768, 16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 2
+};
+
+template <int F>
+struct FixedQ {
+    int64_t v;
+
+    FixedQ() = default;
+    constexpr FixedQ(int i) : v(int64_t(i) * (int64_t(1) << F)) {}
+    constexpr FixedQ(double d) : v(int64_t(d * double(int64_t(1) << F) + (d < 0 ? -0.5 : 0.5))) {}
+    static FixedQ raw(int64_t r) { FixedQ q; q.v = r; return q; }
+    explicit operator double() const { return double(v) / double(int64_t(1) << F); }
+
+    // |a * b| >> F from four 32x32 partial products
+    static int64_t mulShift(int64_t a, int64_t b) {
+        bool neg = (a < 0) != (b < 0);
+        uint64_t ua = a < 0 ? -uint64_t(a) : uint64_t(a), ub = b < 0 ? -uint64_t(b) : uint64_t(b);
+        uint64_t al = ua & 0xFFFFFFFFu, ah = ua >> 32, bl = ub & 0xFFFFFFFFu, bh = ub >> 32;
+        uint64_t ll = al*bl, lh = al*bh, hl = ah*bl, hh = ah*bh;
+        uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+        uint64_t lo = (ll & 0xFFFFFFFFu) | (mid << 32);
+        uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+        uint64_t r = (lo >> F) | (hi << (64 - F));
+        return neg ? -int64_t(r) : int64_t(r);
+    }
+
+    // (a << F) / b by integer division then F steps of long division on the remainder
+    static int64_t divShift(int64_t a, int64_t b) {
+        bool neg = (a < 0) != (b < 0);
+        uint64_t ua = a < 0 ? -uint64_t(a) : uint64_t(a), ub = b < 0 ? -uint64_t(b) : uint64_t(b);
+        if (ub == 0) return neg ? INT64_MIN : INT64_MAX;
+        uint64_t q = ua / ub, r = ua % ub;
+        for (int i = 0; i < F; ++i) {
+            r <<= 1;
+            q <<= 1;
+            if (r >= ub) {
+                r -= ub;
+                q |= 1;
+            }
+        }
+        return neg ? -int64_t(q) : int64_t(q);
+    }
+
+    friend FixedQ operator+(FixedQ a, FixedQ b) { return raw(a.v + b.v); }
+    friend FixedQ operator-(FixedQ a, FixedQ b) { return raw(a.v - b.v); }
+    friend FixedQ operator*(FixedQ a, FixedQ b) { return raw(mulShift(a.v, b.v)); }
+    friend FixedQ operator/(FixedQ a, FixedQ b) { return raw(divShift(a.v, b.v)); }
+    FixedQ operator-() const { return raw(-v); }
+    FixedQ& operator+=(FixedQ b) { v += b.v; return *this; }
+    FixedQ& operator-=(FixedQ b) { v -= b.v; return *this; }
+    FixedQ& operator*=(FixedQ b) { v = mulShift(v, b.v); return *this; }
+    FixedQ& operator/=(FixedQ b) { v = divShift(v, b.v); return *this; }
+
+    friend bool operator<(FixedQ a, FixedQ b) { return a.v < b.v; }
+    friend bool operator>(FixedQ a, FixedQ b) { return a.v > b.v; }
+    friend bool operator<=(FixedQ a, FixedQ b) { return a.v <= b.v; }
+    friend bool operator>=(FixedQ a, FixedQ b) { return a.v >= b.v; }
+    friend bool operator==(FixedQ a, FixedQ b) { return a.v == b.v; }
+    friend bool operator!=(FixedQ a, FixedQ b) { return a.v != b.v; }
+};
+
+typedef FixedQ<24> Fixed;
+
+// Bitwise integer square root
+inline uint64_t isqrt64(uint64_t n) {
+    uint64_t r = 0, bit = 1ULL << 62;
+    while (bit > n) bit >>= 2;
+    while (bit) {
+        if (n >= r + bit) {
+            n -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+template <int F>
+FixedQ<F> sqrt(FixedQ<F> a) {
+    if (a.v <= 0) return FixedQ<F>::raw(0);
+    // sqrt(v << F), pre-shifting v as far as fits and applying the rest of the shift to the root
+    uint64_t u = uint64_t(a.v);
+    int s = 0;
+    while (s < F && u < (1ULL << 60)) {
+        u <<= 2;
+        s += 2;
+    }
+    return FixedQ<F>::raw(int64_t(isqrt64(u) << ((F - s) / 2)));
+}
+
+template <int F>
+FixedQ<F> fabs(FixedQ<F> a) { return FixedQ<F>::raw(a.v < 0 ? -a.v : a.v); }
+
+template <int F>
+FixedQ<F> fmod(FixedQ<F> a, FixedQ<F> b) { return FixedQ<F>::raw(a.v % b.v); }
+
+// CORDIC rotation of (gain, 0) by a Q30 angle reduced to [-pi/2, pi/2]
+inline void cordicSinCos(int64_t z, int64_t& s, int64_t& c) {
+    z %= CORDIC_TWO_PI;
+    if (z > CORDIC_PI) z -= CORDIC_TWO_PI;
+    if (z < -CORDIC_PI) z += CORDIC_TWO_PI;
+    int64_t sign = 1;
+    if (z > CORDIC_HALF_PI) { z -= CORDIC_PI; sign = -1; }
+    else if (z < -CORDIC_HALF_PI) { z += CORDIC_PI; sign = -1; }
+
+    int64_t x = CORDIC_GAIN, y = 0;
+    for (int i = 0; i < CORDIC_ITERS; ++i) {
+        int64_t xs = x >> i, ys = y >> i;
+        if (z >= 0) { x -= ys; y += xs; z -= cordicAtan[i]; }
+        else        { x += ys; y -= xs; z += cordicAtan[i]; }
+    }
+    s = sign * y;
+    c = sign * x;
+}
+
+template <int F>
+int64_t cordicAngle(FixedQ<F> a) { return F < CORDIC_BITS ? a.v * (int64_t(1) << (CORDIC_BITS - F)) : a.v >> (F - CORDIC_BITS); }
+
+template <int F>
+FixedQ<F> cordicOut(int64_t q30) {
+    return FixedQ<F>::raw(F < CORDIC_BITS ? (q30 + (int64_t(1) << (CORDIC_BITS - F - 1))) >> (CORDIC_BITS - F)
+                                          : q30 * (int64_t(1) << (F - CORDIC_BITS)));
+}
+
+template <int F>
+FixedQ<F> sin(FixedQ<F> a) {
+    int64_t s, c;
+    cordicSinCos(cordicAngle(a), s, c);
+    return cordicOut<F>(s);
+}
+
+template <int F>
+FixedQ<F> cos(FixedQ<F> a) {
+    int64_t s, c;
+    cordicSinCos(cordicAngle(a), s, c);
+    return cordicOut<F>(c);
+}
+
+// Both from one CORDIC rotation, picked over the generic sinCos in fast_math.h
+template <int F>
+void sinCos(FixedQ<F> a, FixedQ<F>& s, FixedQ<F>& c) {
+    int64_t qs, qc;
+    cordicSinCos(cordicAngle(a), qs, qc);
+    s = cordicOut<F>(qs);
+    c = cordicOut<F>(qc);
+}
+
+// CORDIC vectoring: rotate (x, y) onto the x axis, accumulating the angle
+template <int F>
+FixedQ<F> atan2(FixedQ<F> fy, FixedQ<F> fx) {
+    int64_t x = fx.v, y = fy.v, z = 0;
+    if (x == 0 && y == 0) return FixedQ<F>::raw(0);
+    if (x < 0) {
+        z = y >= 0 ? CORDIC_PI : -CORDIC_PI;
+        x = -x;
+        y = -y;
+    }
+    // Scale up for resolution, leaving headroom for the CORDIC gain
+    uint64_t m = uint64_t(x) | uint64_t(y < 0 ? -y : y);
+    while (m < (1ULL << 58)) {
+        m <<= 1;
+        x *= 2;
+        y *= 2;
+    }
+    for (int i = 0; i < CORDIC_ITERS; ++i) {
+        int64_t xs = x >> i, ys = y >> i;
+        if (y > 0) { x += ys; y -= xs; z += cordicAtan[i]; }
+        else       { x -= ys; y += xs; z -= cordicAtan[i]; }
+    }
+    return cordicOut<F>(z);
+}
@@ -0,0 +1,96 @@
+/*
+  ground_track.cpp - Ground track over the next orbit, built a few points at a time
+ */
+#include "ground_track.h"
+
+// Orbit's mean motion is in rad/s, Sgp4's in rad/min
+double orbitPeriodSec(const Orbit& orb) {
+    return TWO_PI / orb.n;
+}
+
+double orbitPeriodSec(const Sgp4& orb) {
+    return TWO_PI / orb.n * 60;
+}
+
+void GroundTrack::begin() {
+    valid = false;
+    building = false;
+    nComputed = 0;
+}
+
+// True if the track is missing, from other elements, or the satellite is far enough along it
+bool GroundTrack::needsUpdate(const OrbitModel& orb, UtcTime now) const {
+    if (!valid || orb.epoch.ns != epoch.ns || now.ns < start.ns) return true;
+    int64_t refresh_ns = int64_t(orbitPeriodSec(orb) * GT_REFRESH_ORBITS * 1e9);
+    return now.ns - start.ns >= refresh_ns;
+}
+
+// One display tick's share of the work: start a new track when due, or restart it if the elements changed
+// under it, then add GT_POINTS_PER_TICK points. Returns true when a new track replaced the one on the map
+bool GroundTrack::update(OrbitModel& orb, UtcTime now) {
+    if (building && orb.epoch.ns != nextEpoch.ns) building = false;
+    if (!building) {
+        if (!needsUpdate(orb, now)) return false;
+        startBuild(orb, now);
+    }
+    return buildPoints(orb, GT_POINTS_PER_TICK);
+}
+
+// Begin a track from now over GT_WINDOW_ORBITS, replacing any build in progress
+void GroundTrack::startBuild(const OrbitModel& orb, UtcTime now) {
+    nextStart = now;
+    nextEpoch = orb.epoch;
+    nextStep_ns = int64_t(orbitPeriodSec(orb) * GT_WINDOW_ORBITS / (GT_POINTS - 1) * 1e9);
+    clk.set(nextStart);
+    nBuilt = 0;
+    building = true;
+}
+
+// Add up to maxPoints sub-satellite points to the track being built. Returns true when that completed it
+bool GroundTrack::buildPoints(OrbitModel& orb, uint16_t maxPoints) {
+    if (!building) return false;
+    for (uint16_t i = 0; i < maxPoints && nBuilt < GT_POINTS; ++i, ++nBuilt) {
+        UtcTime t = nextStart + int64_t(nBuilt) * nextStep_ns;
+        Vec3 posECI;
+        orb.calcPosECI_UTC(t, posECI);
+        clk.advanceTo(t);
+        Vec3 lla = ecef2lla(eci2ecef(posECI, -clk.angle()), DEGREES);
+        nextLat[nBuilt] = float(lla.x);
+        nextLon[nBuilt] = float(lla.y);
+    }
+    if (nBuilt < GT_POINTS) return false;
+
+    start = nextStart;
+    epoch = nextEpoch;
+    step_ns = nextStep_ns;
+    memcpy(lat, nextLat, sizeof(lat));
+    memcpy(lon, nextLon, sizeof(lon));
+    valid = true;
+    building = false;
+    nComputed++;
+    return true;
+}
+
+// Whole track from now in one call
+void GroundTrack::compute(OrbitModel& orb, UtcTime now) {
+    startBuild(orb, now);
+    buildPoints(orb, GT_POINTS);
+}
+
+// Position at t, interpolated between track points across the antimeridian. False outside the track
+bool GroundTrack::subPoint(UtcTime t, float& latDeg, float& lonDeg) const {
+    if (!valid || t.ns < start.ns) return false;
+    int64_t dt = t.ns - start.ns;
+    int64_t k = dt / step_ns;
+    if (k >= GT_POINTS - 1) return false;
+
+    float f = float(dt - k * step_ns) / float(step_ns);
+    float dLon = lon[k+1] - lon[k];
+    if (dLon > 180) dLon -= 360;
+    else if (dLon < -180) dLon += 360;
+    latDeg = lat[k] + f * (lat[k+1] - lat[k]);
+    lonDeg = lon[k] + f * dLon;
+    if (lonDeg >= 180) lonDeg -= 360;
+    else if (lonDeg < -180) lonDeg += 360;
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+  ground_track.h - Sub-satellite points over the next orbit, for the map screen
+    Each point is calcPosECI_UTC at evenly spaced times, eci2ecef with an EraClock stepped along the same grid,
+    then ecef2lla. The track spans GT_WINDOW_ORBITS from the time it was started and is only redone when the
+    elements change or the satellite is GT_REFRESH_ORBITS into it, so at least one full orbit ahead is always
+    on the map. Between points the current position is interpolated.
+    A point is a full double-precision chain, milliseconds of soft float on the M0, so the firmware builds a
+    new track GT_POINTS_PER_TICK points per display tick into a second buffer, the way the Chebyshev cache fits
+    one segment per tick. The old track stays on the map until the new one is complete.
+ */
+#pragma once
+#include <Arduino.h>
+#include "coord.h"
+#include "pointing.h"
+
+#define GT_POINTS           96
+#define GT_WINDOW_ORBITS    1.5
+#define GT_REFRESH_ORBITS   0.5
+#define GT_POINTS_PER_TICK  2       // Points built per update(), ~10 ms on the M0
+
+struct GroundTrack {
+    // Track on the map
+    UtcTime start;
+    int64_t step_ns;
+    UtcTime epoch;              // Epoch of the elements the track was computed from
+    float lat[GT_POINTS];       // [deg]
+    float lon[GT_POINTS];       // [deg], in [-180, 180)
+    bool valid;
+    uint32_t nComputed;
+
+    // Track being built, copied over the one on the map once complete
+    UtcTime nextStart;
+    int64_t nextStep_ns;
+    UtcTime nextEpoch;
+    float nextLat[GT_POINTS];
+    float nextLon[GT_POINTS];
+    EraClock clk;
+    uint16_t nBuilt;
+    bool building;
+
+    void begin();
+    void invalidate() { valid = building = false; }
+    bool needsUpdate(const OrbitModel& orb, UtcTime now) const;
+    bool update(OrbitModel& orb, UtcTime now);
+    void startBuild(const OrbitModel& orb, UtcTime now);
+    bool buildPoints(OrbitModel& orb, uint16_t maxPoints);
+    void compute(OrbitModel& orb, UtcTime now);
+    bool subPoint(UtcTime t, float& latDeg, float& lonDeg) const;
+};
+
+double orbitPeriodSec(const Orbit& orb);
+double orbitPeriodSec(const Sgp4& orb);
@@ -0,0 +1,42 @@
+/*
+  heap_guard.cpp - Allocator trap for the zero-heap mode
+ */
+#include "heap_guard.h"
+
+HeapGuard heapGuard = {false, 0, 0};
+
+// End of setup(): from here on any allocator call is a violation
+void heapLock() {
+    // newlib's float formatter keeps a free list of big-number buffers, filled on its first uses.
+    // Fill it now for the magnitudes the debug prints use
+    char buf[32];
+    static const double warm[] = {0.001, 1., 360., 7e6, 1e15};
+    for (double v : warm) snprintf(buf, sizeof(buf), "%0.8f %e", v, v);
+
+    heapGuard.nCalls = 0;
+    heapGuard.locked = true;
+}
+
+// Called by the allocator hook
+void heapNote() {
+    if (!heapGuard.locked) return;
+    if (heapGuard.nCalls++ == 0) heapGuard.firstMillis = millis();
+}
+
+#if ZERO_HEAP && defined(ARDUINO)
+#include <reent.h>
+
+// newlib takes this lock on every malloc, free, realloc & calloc. The default is an empty stub in libc,
+// so this definition replaces it at link time
+extern "C" void __malloc_lock(struct _reent*) {
+    heapNote();
+#if ZERO_HEAP_HALT
+    if (heapGuard.locked) {
+        noInterrupts();
+        while (true) {}
+    }
+#endif
+}
+
+extern "C" void __malloc_unlock(struct _reent*) {}
+#endif
@@ -0,0 +1,22 @@
+/*
+  heap_guard.h - Zero-heap mode: no allocation once setup() has returned
+    Every buffer the tasks use after setup() is static: the TLE lines, the HTTP stream parser state & its
+    read chunk, the NTP packet, the display fields & map track. Only library setup (the display framebuffer,
+    WiFi) allocates. With ZERO_HEAP set, newlib's allocator lock hook, which malloc, free, realloc & calloc all
+    take, reports to heapNote(), so any allocator call after heapLock() is caught rather than slowly
+    fragmenting the 32 KB of RAM over days of uptime.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+struct HeapGuard {
+    bool locked;
+    uint32_t nCalls;            // Allocator calls since heapLock()
+    uint32_t firstMillis;       // When the first of them happened
+};
+
+extern HeapGuard heapGuard;
+
+void heapLock();
+void heapNote();
@@ -0,0 +1,220 @@
+/*
+  http_tle_stream.cpp - Byte-at-a-time HTTP/TLE state machine
+ */
+#include "http_tle_stream.h"
+
+// Case-insensitive check that the line starts with prefix
+static bool startsWithNoCase(const char* line, uint8_t len, const char* prefix) {
+    for (uint8_t i = 0; prefix[i]; ++i) {
+        if (i >= len) return false;
+        char c = line[i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        if (c != prefix[i]) return false;
+    }
+    return true;
+}
+
+// Value of a hex digit, -1 if c is not one
+static int8_t hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parse a decimal value following a "name:" header prefix
+static int32_t headerValue(const char* line, uint8_t len, uint8_t prefixLen) {
+    int32_t v = 0;
+    for (uint8_t i = prefixLen; i < len; ++i) {
+        if (line[i] >= '0' && line[i] <= '9') v = v*10 + (line[i] - '0');
+        else if (line[i] != ' ') break;
+    }
+    return v;
+}
+
+// Reset for a new response
+void HttpTleStream::begin(TleRecordCallback _onRecord, void* _ctx) {
+    onRecord = _onRecord;
+    ctx = _ctx;
+    state = HTS_STATUS;
+    status = 0;
+    chunked = false;
+    contentLength = -1;
+    remaining = 0;
+    lineLen = 0;
+    titleLen = 0;
+    haveTitle = false;
+    haveLine1 = false;
+    nRecords = 0;
+    nBad = 0;
+}
+
+// Handle a complete status or header line in line[0..lineLen)
+void HttpTleStream::headerLine() {
+    if (state == HTS_STATUS) {
+        // "HTTP/1.1 200 OK"
+        if (!startsWithNoCase(line, lineLen, "http/") || lineLen < 12) {
+            state = HTS_ERROR;
+            return;
+        }
+        status = (line[9] - '0')*100 + (line[10] - '0')*10 + (line[11] - '0');
+        state = status == 200 ? HTS_HEADERS : HTS_ERROR;
+    } else if (state == HTS_TRAILER) {
+        if (lineLen == 0) endBody();
+    } else if (lineLen == 0) {
+        // Blank line ends the headers
+        if (chunked) {
+            state = HTS_CHUNK_SIZE;
+            remaining = 0;
+        } else if (contentLength == 0) {
+            endBody();
+        } else {
+            state = HTS_BODY;
+            remaining = uint32_t(contentLength);
+        }
+    } else if (startsWithNoCase(line, lineLen, "content-length:")) {
+        contentLength = headerValue(line, lineLen, 15);
+    } else if (startsWithNoCase(line, lineLen, "transfer-encoding:")) {
+        // Only chunked is expected here; anything else is passed through as identity
+        for (uint8_t i = 18; i + 7 <= lineLen; ++i)
+            if (startsWithNoCase(line + i, lineLen - i, "chunked")) chunked = true;
+    }
+    lineLen = 0;
+}
+
+// Handle a complete body line, tracking title / line 1 / line 2 and emitting records
+void HttpTleStream::bodyLine() {
+    if (lineLen >= TLE_LEN && line[0] == '1' && line[1] == ' ') {
+        memcpy(line1, line, TLE_LEN);
+        haveLine1 = true;
+    } else if (lineLen >= TLE_LEN && line[0] == '2' && line[1] == ' ' && haveLine1) {
+        if (tleChecksumOk(line1) && tleChecksumOk(line) && memcmp(line1 + 2, line + 2, 5) == 0) {
+            TleRecord rec = {haveTitle ? title : NULL, haveTitle ? titleLen : uint8_t(0), line1, line};
+            nRecords++;
+            if (onRecord) onRecord(ctx, rec);
+        } else {
+            nBad++;
+        }
+        haveLine1 = false;
+        haveTitle = false;
+    } else {
+        // Anything else is a candidate title for the next record
+        const char* p = line;
+        uint8_t n = lineLen;
+        if (n >= 2 && p[0] == '0' && p[1] == ' ') { p += 2; n -= 2; }
+        while (n > 0 && p[n-1] == ' ') n--;
+        if (n > TLE_TITLE_LEN) n = TLE_TITLE_LEN;
+        memcpy(title, p, n);
+        titleLen = n;
+        haveTitle = true;
+        haveLine1 = false;
+    }
+    lineLen = 0;
+}
+
+// Accumulate one decoded body byte
+void HttpTleStream::bodyByte(char c) {
+    if (c == '\n') {
+        bodyLine();
+    } else if (c != '\r' && lineLen < HTTP_LINE_LEN) {
+        line[lineLen++] = c;
+    }
+}
+
+// Flush a final unterminated body line and finish
+void HttpTleStream::endBody() {
+    if (lineLen > 0 && state != HTS_TRAILER) bodyLine();
+    lineLen = 0;
+    state = HTS_DONE;
+}
+
+// End of a chunk-size line. The zero-size chunk ends the body, so a last body line without its newline is
+// flushed here, before the trailer reuses the line buffer
+void HttpTleStream::chunkSizeLine() {
+    if (remaining) {
+        state = HTS_CHUNK_DATA;
+        return;
+    }
+    if (lineLen > 0) bodyLine();
+    lineLen = 0;
+    state = HTS_TRAILER;
+}
+
+// Consume received bytes. Returns the number used, which is less than len only once the response is done or failed
+size_t HttpTleStream::feed(const char* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        char c = data[i];
+        switch (state) {
+            case HTS_STATUS:
+            case HTS_HEADERS:
+            case HTS_TRAILER:
+                if (c == '\n') headerLine();
+                else if (c != '\r' && lineLen < HTTP_LINE_LEN) line[lineLen++] = c;
+                i++;
+                break;
+
+            case HTS_BODY: {
+                // Copy a run of bytes at once where Content-Length allows
+                size_t n = len - i;
+                if (contentLength >= 0 && n > remaining) n = remaining;
+                for (size_t k = 0; k < n; ++k) bodyByte(data[i + k]);
+                i += n;
+                if (contentLength >= 0) {
+                    remaining -= n;
+                    if (remaining == 0) endBody();
+                }
+                break;
+            }
+
+            case HTS_CHUNK_SIZE: {
+                int8_t d = hexDigit(c);
+                // A size that would overflow 32 bits is rejected rather than wrapped
+                if (d >= 0 && (remaining >> 28)) state = HTS_ERROR;
+                else if (d >= 0) remaining = remaining*16 + uint32_t(d);
+                else if (c == ';' || c == ' ') state = HTS_CHUNK_EXT;
+                else if (c == '\n') chunkSizeLine();
+                else if (c != '\r') state = HTS_ERROR;
+                i++;
+                break;
+            }
+
+            case HTS_CHUNK_EXT:
+                if (c == '\n') chunkSizeLine();
+                i++;
+                break;
+
+            case HTS_CHUNK_DATA: {
+                size_t n = len - i;
+                if (n > remaining) n = remaining;
+                for (size_t k = 0; k < n; ++k) bodyByte(data[i + k]);
+                i += n;
+                remaining -= n;
+                if (remaining == 0) state = HTS_CHUNK_DATA_END;
+                break;
+            }
+
+            case HTS_CHUNK_DATA_END:
+                if (c == '\n') {
+                    state = HTS_CHUNK_SIZE;
+                    remaining = 0;
+                } else if (c != '\r') {
+                    state = HTS_ERROR;
+                }
+                i++;
+                break;
+
+            default:
+                return i;
+        }
+    }
+    return i;
+}
+
+// Signal that the connection closed. Completes an identity body without Content-Length
+// Returns true if the response was received completely
+bool HttpTleStream::finish() {
+    if (state == HTS_BODY && contentLength < 0) endBody();
+    else if (state != HTS_DONE) state = HTS_ERROR;
+    return state == HTS_DONE;
+}
@@ -0,0 +1,66 @@
+/*
+  http_tle_stream.h - Incremental HTTP response parser that extracts TLE records as bytes arrive
+    Handles the status line, headers, Content-Length & chunked transfer encodings, and emits each validated
+    TLE record through a callback as soon as its second line completes. Memory use is fixed (one line buffer
+    plus the pending title & line 1), independent of the response size.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+#include "tle_catalog.h"
+
+#define HTTP_LINE_LEN   80  // Longer header or body lines are truncated, which is harmless for TLE data
+#define TLE_TITLE_LEN   32
+
+// Called for every valid record, the record views are only valid during the call
+typedef void (*TleRecordCallback)(void* ctx, const TleRecord& rec);
+
+// Parser states
+enum HttpTleState : uint8_t {
+    HTS_STATUS,         // Reading "HTTP/1.1 200 OK"
+    HTS_HEADERS,
+    HTS_BODY,           // Identity body, bounded by Content-Length or connection close
+    HTS_CHUNK_SIZE,     // Reading hex chunk size
+    HTS_CHUNK_EXT,      // Skipping chunk extensions up to end of line
+    HTS_CHUNK_DATA,
+    HTS_CHUNK_DATA_END, // CRLF after chunk data
+    HTS_TRAILER,        // Trailer headers after the last chunk
+    HTS_DONE,
+    HTS_ERROR
+};
+
+struct HttpTleStream {
+    TleRecordCallback onRecord;
+    void* ctx;
+
+    uint8_t state;
+    int status;
+    bool chunked;
+    int32_t contentLength;      // -1 if not given
+    uint32_t remaining;         // Bytes left in the current chunk or Content-Length body
+
+    char line[HTTP_LINE_LEN];
+    uint8_t lineLen;
+
+    char title[TLE_TITLE_LEN];
+    uint8_t titleLen;
+    bool haveTitle;
+    char line1[TLE_LEN];
+    bool haveLine1;
+
+    uint32_t nRecords;
+    uint32_t nBad;
+
+    void begin(TleRecordCallback onRecord, void* ctx);
+    size_t feed(const char* data, size_t len);
+    bool finish();
+    bool done() const { return state == HTS_DONE; }
+    bool failed() const { return state == HTS_ERROR; }
+
+    // Internal steps
+    void headerLine();
+    void bodyByte(char c);
+    void bodyLine();
+    void chunkSizeLine();
+    void endBody();
+};
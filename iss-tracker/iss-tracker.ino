@@ -9,9 +9,16 @@
 #include "arduino_secrets.h"
 #include "coord.h"
 #include "orbit_utils.h"
+#include "sgp4.h"
+#include "pointing.h"
+#include "orbit_snapshot.h"
+#include "scheduler.h"
 #include "wifi_utils.h"
+#include "net_link.h"
 #include "display_utils.h"
 #include "pedestal.h"
+#include "profile.h"
+#include "heap_guard.h"
 
 #include "defs.h"
 
@@ -25,16 +32,18 @@ Vec3 llaRef = {SECRET_LAT,SECRET_LON,0}; // Pedestal Lat/Lon
 NtpQueryHandler ntp{};
 TleQueryHandler tle{};
 Pedestal ped{};
-Orbit orb{};
+OrbitModel orb{};
+PointingSolver pointing{};
+OrbitSnapshot snapshot{};
+Scheduler sched{};
+NetLink net{};
 
 // Misc. variable declaration
-Vec3 posECI, velECI, posECEF, posLLA, posNED, posAER;
-double era;
 int wifiStatus = WL_IDLE_STATUS;
-uint32_t lastTleUpdateMillis, lastOrbitUpdateMillis, lastNtpUpdateMillis;
+int ntpTaskId;
 
-bool ntpPacketSent = false;
-bool tleQuerySent = false;
+bool orbitReady = false;        // orb holds elements, from Celestrak or the snapshot
+bool snapshotPending = false;   // Snapshot loaded, waiting for the clock to check its age
 
 void setup() {
     // Initialize serial and wait for port to open
@@ -55,10 +64,13 @@ void setup() {
     display.display();
     delay(1000);
     display.setRotation(1);
+    statusScreen.begin();
+    mapScreen.begin(llaRef);
     resetDisplay(0,0,1);
 
     // Initialize pedestal wrapper
     ped.begin();
+    pointing.begin(llaRef,orb);
 
     // Test pointer elevation range
     // Should point at 0 degrees, then -90, then +90, then back to 0
@@ -90,7 +102,7 @@ void setup() {
 
     // Reset stepper step count to zero to establish current step count as zero azimuth
     ped.stepper.setCurrentPosition(0);
-    
+
     // check for the WiFi module:
     WiFi.setPins(SPIWIFI_SS, SPIWIFI_ACK, ESP32_RESETN, ESP32_GPIO0, &SPIWIFI);
     while (WiFi.status() == WL_NO_MODULE) {
@@ -103,7 +115,7 @@ void setup() {
     }
 
     // Check Wifi Co-processor Firmware
-    String fv = WiFi.firmwareVersion();
+    const char* fv = WiFi.firmwareVersion();
     Serial.print("Found firmware "); Serial.println(fv);
 
     // List visible Wifi Networks
@@ -118,168 +130,264 @@ void setup() {
     display.println(ssid);
     display.display();
 
-    // Connect to WPA/WPA2 network
-    do {
-        wifiStatus = WiFi.begin(ssid, pass);
-        delay(10000);     // wait until connection is ready!
-    } while (wifiStatus != WL_CONNECTED);
+    // Load the last good elements. With them, tracking starts as soon as the clock is set rather than after
+    // Celestrak answers, and setup() only gives the network bounded waits before the tasks take over
+    snapshotPending = loadOrbitSnapshot(snapshot) == 0;
+    NetHooks hooks = {NULL, wifiBegin, wifiConnected, ntpSend, ntpReceive, tleSend, tleReceive, tleApply};
+    ntp.begin();
+    net.begin(hooks, ntp.clock);
 
-    Serial.println("Connected to wifi");
-    display.println("Connected to wifi");
-    display.display();
-    delay(1000);
+    if (net.associate(snapshotPending)) {
+        Serial.println("Connected to wifi");
+        display.println("Connected to wifi");
+        display.display();
+        delay(1000);
 
-    // Start NTP connection
-    ntp.begin();
-    Serial.println("\nStarting connection to NTP server...");
-    display.println("\nStarting connection to NTP server...");
-    display.display();
-    delay(100);
+        Serial.println("\nStarting connection to NTP server...");
+        display.println("\nStarting connection to NTP server...");
+        display.display();
+        delay(100);
+    } else {
+        Serial.println("Wifi not connected yet, continuing from the saved orbit");
+    }
+
+    // Get unix time. On a cold start there is nothing to track without it, so this waits for the reply
+    if (net.waitForNtp(snapshotPending)) {
+        displayCurrTime(0.0,0.0);
+        if (snapshotPending) useSnapshot();
+    }
 
-    // Get unix time
-    ntp.sendNTPpacket(); // send an NTP packet to the time server
-    // wait to see if a reply is available
-    while (!ntp.parsePacket()) {};
-    displayCurrTime(0.0,0.0);
+    // From here on WiFi.begin() must return immediately, connection progress is polled by wifiTask
+    WiFi.setTimeout(0);
+
+    // Register tasks. The stepper is serviced between every task, so each must return quickly
+    sched.begin(schedMillis, schedMicros, stepperIdle, NULL);
+    sched.add("wifi",    wifiTask,    NULL, WIFI_TASK_MS);
+    ntpTaskId = sched.add("ntp", ntpTask, NULL, NET_POLL_MS);
+    sched.add("tle",     tleTask,     NULL, NET_POLL_MS);
+    sched.add("orbit",   orbitTask,   NULL, ORBIT_REFRESH_DELAY_MS, ORBIT_REFRESH_DELAY_MS/2);
+    sched.add("ephem",   ephemTask,   NULL, EPHEM_TASK_MS);
+    sched.add("display", displayTask, NULL, DISPLAY_TASK_MS);
+    if (DO_PRINT_DEBUG || ZERO_HEAP) sched.add("stats", statsTask, NULL, STATS_TASK_MS);
+#if ENABLE_PROFILING
+    profileBegin();
+    sched.add("profile", profileTask, NULL, PROFILE_TASK_MS);
+#endif
+
+    // Everything the tasks need is allocated by now
+    heapLock();
+}
+
+void loop() {
+    sched.runOnce();
+}
 
-    // Send initial TLE query
+// Current UTC from the NTP-disciplined clock, corrected for millis() drift
+uint64_t currUTCms() {
+    return ntp.clock.utcMs(millis());
+}
+
+uint32_t schedMillis() { return millis(); }
+uint32_t schedMicros() { return micros(); }
+
+// Idle hook: advance the stepper between tasks
+void stepperIdle(void* ctx) {
+    ped.runStepper();
+}
+
+// Network hooks for the link sequencing
+bool wifiBegin(void* ctx) {
+    return (wifiStatus = WiFi.begin(ssid, pass)) == WL_CONNECTED;
+}
+
+bool wifiConnected(void* ctx) {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+void ntpSend(void* ctx) {
+    ntp.sendNTPpacket();
+}
+
+bool ntpReceive(void* ctx) {
+    return ntp.parsePacket();
+}
+
+void tleSend(void* ctx) {
     tle.sendQuery();
+}
 
-    // Wait for response
-    while (!tle.rcvData()){}
-    tle.readTLE();
+bool tleReceive(void* ctx) {
+    return tleRcvData();
+}
 
+// Use the TLE from a completed Celestrak response and persist it for the next boot
+bool tleApply(void* ctx) {
+    if (tle.readTLE() != 0) return false;
+    Serial.println("Updating Ephemeris");
     Serial.println(tle.line1);
     Serial.println(tle.line2);
-
-    // Parse received TLE
     tle.getOrbit(orb);
+    pointing.orbitUpdated();
+    orbitReady = true;
+    snapshotPending = false;
+    if (DO_PRINT_DEBUG) printOrbit();
+
+    snapshot.fill(tle.line1,tle.line2,uint32_t(currUTCms()/1000));
+    saveOrbitSnapshot(snapshot);
+    return true;
+}
 
-    if (DO_PRINT_DEBUG) {
-        Serial.println();
-        Serial.print("epoch: "); Serial.println(orb.epoch_J);
-        Serial.print("utc:   "); Serial.println(orb.epochUTC);
-        Serial.print("incl:  "); Serial.println(orb.incl,8);
-        Serial.print("a:     "); Serial.println(orb.a);
-        Serial.print("ecc:   "); Serial.println(orb.ecc,8);
-        Serial.print("Omega: "); Serial.println(orb.Omega,8);
-        Serial.print("omega: "); Serial.println(orb.omega,8);
-        Serial.print("M0:    "); Serial.println(orb.M0,8);
-        Serial.print("n:     "); Serial.println(orb.n,8);
-        Serial.print("n_dot: "); Serial.println(orb.n_dot,16);
-    }
-    
-    // Initialize timers
-    lastNtpUpdateMillis   = millis();
-    lastTleUpdateMillis   = lastNtpUpdateMillis;
-    lastOrbitUpdateMillis = lastNtpUpdateMillis;
-    delay(100);
+// Debug print of the orbital elements in use
+void printOrbit() {
+    Serial.println();
+    Serial.print("epoch: "); Serial.println(orb.epoch.julianUtc().value(), 6);
+    Serial.print("utc:   "); Serial.println(uint32_t(orb.epoch.unixSec()));
+    Serial.print("incl:  "); Serial.println(orb.incl,8);
+#if !USE_SGP4
+    Serial.print("a:     "); Serial.println(orb.a);
+#endif
+    Serial.print("ecc:   "); Serial.println(orb.ecc,8);
+    Serial.print("Omega: "); Serial.println(orb.Omega,8);
+    Serial.print("omega: "); Serial.println(orb.omega,8);
+    Serial.print("M0:    "); Serial.println(orb.M0,8);
+    Serial.print("n:     "); Serial.println(orb.n,8);
+#if USE_SGP4
+    Serial.print("bstar: "); Serial.println(orb.bstar,8);
+#else
+    Serial.print("n_dot: "); Serial.println(orb.n_dot,16);
+#endif
+}
 
-    if (DO_PRINT_DEBUG) {
-        Serial.print("In setup(): lastNtpUpdateMillis: ");
-        Serial.println(int32_t(lastTleUpdateMillis));
-        Serial.print("In setup(): lastTleUpdateMillis: ");
-        Serial.println(int32_t(lastTleUpdateMillis));
+// Start tracking from the loaded snapshot once the clock is set, unless its elements are too old
+void useSnapshot() {
+    snapshotPending = false;
+    if (!snapshot.fresh(uint32_t(currUTCms()/1000))) {
+        Serial.println("Saved orbit snapshot is stale, waiting for Celestrak");
+        return;
     }
+    orb.initFromTLE(snapshot.line1,snapshot.line2);
+    pointing.orbitUpdated();
+    orbitReady = true;
+    Serial.println("Loaded saved orbit snapshot");
+    if (DO_PRINT_DEBUG) printOrbit();
 }
 
-uint32_t currMillis, timeSinceNtpUpdate_ms, timeSinceTleUpdate_ms, timeSinceOrbitUpdate_ms;
+// Watch the WiFi link and reconnect without blocking
+void wifiTask(void* ctx) {
+    net.wifiTask();
+}
 
-void loop() {
-    // Get current time
-    currMillis = millis();
+// Query NTP at the interval the clock model asks for. While a reply is outstanding the socket is polled
+// on every scheduler pass, since the time it is noticed is taken as its arrival time
+void ntpTask(void* ctx) {
+    net.ntpTask();
+    sched.setPeriod(ntpTaskId, net.ntpPacketSent ? 0 : NET_POLL_MS);
+    if (snapshotPending && ntp.clock.synced) useSnapshot();
+}
 
-    // Try to catch overflow of millis() count and handle gracefully
-    if (currMillis < lastNtpUpdateMillis) {
-        lastNtpUpdateMillis = currMillis;
-        lastTleUpdateMillis = currMillis;
-        lastOrbitUpdateMillis = currMillis;
+// Fetch the first TLE, then refresh it regularly, consuming the response as it arrives
+void tleTask(void* ctx) {
+    net.tleTask();
+}
+
+// Feed whatever TLE response bytes have arrived to the parser
+bool tleRcvData() {
+    PROFILE_SCOPE(PROF_TLE_RCV);
+    return tle.rcvData();
+}
+
+// Refit the ephemeris cache after a TLE update, and top it up as it rolls forward, a few propagations per call
+void ephemTask(void* ctx) {
+    if (!orbitReady || !ntp.clock.synced) return;
+    pointing.fitEphem(currUTCms());
+}
 
-        Serial.println("Time counter overflow hit");
+// Update Az/El and the pedestal targets
+void orbitTask(void* ctx) {
+    if (!orbitReady || !ntp.clock.synced) return;
+    if (!pointing.solve(currUTCms())) {
+        // Elements can't be propagated (e.g. decayed), hold the last pointing until the next TLE update
+        if (DO_PRINT_DEBUG) Serial.printf("Orbit propagation error %i, holding pointing\n", pointing.orbErr);
+        ped.point(pointing.aer,pointing.rates);
+        return;
     }
 
-    timeSinceNtpUpdate_ms = (currMillis - lastNtpUpdateMillis);
-    timeSinceTleUpdate_ms = (currMillis - lastTleUpdateMillis);
-    timeSinceOrbitUpdate_ms = (currMillis - lastOrbitUpdateMillis);
+    if (DO_PRINT_DEBUG) {
+        Serial.printf("System Time: %04i-%02i-%02i  %02i:%02i:%02i\n",
+                    year(),month(),day(),hour(),minute(),second());
+
+        Serial.printf("timeSinceNtpUpdate_ms: %lu, timeSinceTleUpdate_ms: %lu\n",
+                        millis() - net.lastNtpUpdateMillis, millis() - net.lastTleUpdateMillis);
+        if (pointing.cached) {
+            Serial.printf("ephem cache: max fit error %0.3f m\n",pointing.ephem.maxErr);
+        } else {
+            const Vec3& posECI = pointing.posECI;
+            const Vec3& posECEF = pointing.posECEF;
+            const Vec3& posLLA = pointing.posLLA;
+            Serial.print("era:   "); Serial.println(pointing.era*RAD_TO_DEG,3);
+            Serial.printf("posECI:  [%0.3f,%0.3f,%0.3f]\n",posECI.x,posECI.y,posECI.z);
+            Serial.printf("posECEF: [%0.3f,%0.3f,%0.3f]\n",posECEF.x,posECEF.y,posECEF.z);
+            Serial.printf("posLLA:  [%0.3f,%0.3f,%0.3f]\n",posLLA.x,posLLA.y,posLLA.z/1e3);
+        }
+        const Vec3& posNED = pointing.posNED;
+        const Vec3& posAER = pointing.aer;
+        const Vec3& rateAER = pointing.rates;
+        Serial.printf("posNED:  [%0.3f,%0.3f,%0.3f]\n",posNED.x,posNED.y,posNED.z);
+        Serial.printf("posAER:  [%0.3f,%0.3f,%0.3f]\n",posAER.x,posAER.y,posAER.z);
+        Serial.printf("rateAER: [%0.4f,%0.4f,%0.1f]\n",rateAER.x,rateAER.y,rateAER.z);
+    }
 
-    // Advance stepper if necessary
-    ped.runStepper();
+    ped.point(pointing.aer,pointing.rates);
+}
 
-    // Recheck wifi connection status, and try to reconnect if disconnected
-    if (WiFi.status() != WL_CONNECTED) {
+// Display current date/time and Az/El (or the ground track), or the link state while reconnecting
+void displayTask(void* ctx) {
+    if (net.wifiConnecting) {
         resetDisplay(0,0,1);
         display.println("Wifi disconnected, attempting to reconnect...");
         display.display();
-        do {
-            wifiStatus = WiFi.begin(ssid, pass);
-            delay(10000);     // wait until connection is ready!
-        } while (wifiStatus != WL_CONNECTED);
-    }
-
-    // Resend NTP packet regularly to keep time synchronized
-    if (!ntpPacketSent && (timeSinceNtpUpdate_ms > (TIME_REFRESH_DELAY_MIN*60*1000))) {
-        ntp.sendNTPpacket();
-        ntpPacketSent = true;
-        Serial.println("NTP Packet Sent");
     } else {
-        if (ntp.parsePacket()) {
-            Serial.println("Parsed NTP Packet");
-            lastNtpUpdateMillis = millis();
-            ntpPacketSent = false;
-        }
+        PROFILE_SCOPE(PROF_DISPLAY);
+#if DISPLAY_GROUND_TRACK
+        // Until the first elements arrive there is no track to draw
+        if (orbitReady) displayGroundTrack(orb,currUTCms());
+        else displayCurrTime(pointing.aer[0],pointing.aer[1]);
+#else
+        displayCurrTime(pointing.aer[0],pointing.aer[1]);
+#endif
     }
+}
 
-    // Resend TLE Query regularly to get updated ephemeris
-    if (!tleQuerySent && (timeSinceTleUpdate_ms > (TLE_REFRESH_DELAY_MIN * 60*1000))) {
-        tle.sendQuery();
-        tleQuerySent = true;
-        Serial.println("TLE Query Sent");
-    } else if (tleQuerySent) {
-        if (tle.rcvData()) {
-            Serial.println("Updating Ephemeris");
-            tle.readTLE(); // Read received TLE data into separate lines
-            tle.getOrbit(orb); // Update orbit from received TLE data
-            lastTleUpdateMillis = millis();
-            tleQuerySent = false;
-        }
+// Report heap use caught after setup() and, in debug builds, per-task timing; the worst stepper service gap
+// bounds pointing jitter
+void statsTask(void* ctx) {
+#if ZERO_HEAP
+    // Heap use is reported in every build with ZERO_HEAP, each time more allocator calls have been caught
+    static uint32_t heapReported = 0;
+    if (heapGuard.nCalls != heapReported) {
+        heapReported = heapGuard.nCalls;
+        Serial.printf("HEAP USED after setup: %lu allocator calls, first at %lu ms\n", heapGuard.nCalls,
+                      heapGuard.firstMillis);
     }
+#endif
+    if (!DO_PRINT_DEBUG) return;
+
+    Serial.printf("max stepper gap: %lu us\n", sched.maxIdleGap_us);
+    Serial.printf("display: %lu flushes, %lu I2C bytes\n", statusScreen.regions.nFlushes, statusScreen.regions.nBytes);
+    for (uint8_t i = 0; i < sched.nTasks; ++i) {
+        const Task& t = sched.tasks[i];
+        Serial.printf("%-8s runs %lu  max %lu us  avg %lu us  late %lu ms  missed %lu\n", t.name, t.nRuns, t.maxRun_us,
+                      t.nRuns ? uint32_t(t.totalRun_us / t.nRuns) : 0UL, t.maxLate_ms, t.nMissed);
+    }
+}
 
-    uint64_t currUTC_ms = uint64_t(ntp.unixEpoch)*1000 + uint64_t(timeSinceNtpUpdate_ms);
-
-    // Update Az/El at regular rate
-    if (timeSinceOrbitUpdate_ms >= ORBIT_REFRESH_DELAY_MS) {
-        
-        // Calc Earth-Rotation-Angle for current UTC
-        era = getEraFromJulian(getJulianFromUnix(currUTC_ms/1000));
-        
-        // Calc ECI Pos/Vel for current UTC
-        orb.calcPosVelECI_UTC(currUTC_ms,posECI,velECI);
-        lastOrbitUpdateMillis = millis();
-        posECEF = eci2ecef(posECI,-era);
-        posLLA = ecef2lla(posECEF,DEGREES);
-        posNED = ecef2ned(posECEF,llaRef,DEGREES);
-        posAER = ned2AzElRng(posNED);
-
-        if (DO_PRINT_DEBUG) {
-            Serial.printf("System Time: %04i-%02i-%02i  %02i:%02i:%02i\n",
-                        year(),month(),day(),hour(),minute(),second());
-          
-            Serial.printf("timeSinceNtpUpdate_ms: %lu, timeSinceTleUpdate_ms: %lu\n",
-                            timeSinceNtpUpdate_ms, timeSinceTleUpdate_ms);
-            Serial.print("era:   "); Serial.println(era*RAD_TO_DEG,3);
-            Serial.printf("posECI:  [%0.3f,%0.3f,%0.3f]\n",posECI.x,posECI.y,posECI.z);
-            Serial.printf("posECEF: [%0.3f,%0.3f,%0.3f]\n",posECEF.x,posECEF.y,posECEF.z);
-            Serial.printf("posLLA:  [%0.3f,%0.3f,%0.3f]\n",posLLA.x,posLLA.y,posLLA.z/1e3);
-            Serial.printf("posNED:  [%0.3f,%0.3f,%0.3f]\n",posNED.x,posNED.y,posNED.z);
-            Serial.printf("posAER:  [%0.3f,%0.3f,%0.3f]\n",posAER.x,posAER.y,posAER.z);
-        }
-
-        // Update target azimuth only if reached current step target (to avoid interrupting smooth movement)
-        if (ped.stepper.distanceToGo() == 0)
-            ped.setTargetAz(posAER[0]);
-        ped.setElevation(90+posAER[1]);
-
-        // Display current date/time on screen
-        displayCurrTime(posAER[0],posAER[1]);
+#if ENABLE_PROFILING
+// Serial commands: 'p' dumps the stage latency histograms, 'r' clears them
+void profileTask(void* ctx) {
+    while (Serial.available()) {
+        int c = Serial.read();
+        if (c == 'p') profileDump();
+        else if (c == 'r') profileReset();
     }
 }
+#endif
@@ -0,0 +1,78 @@
+/*
+  map_screen.cpp - Equirectangular ground-track map with an incrementally moved satellite marker
+ */
+#include "map_screen.h"
+
+void MapScreen::begin(const Vec3& llaObs) {
+    track.begin();
+    regions.begin();
+    obsX = mapX(float(llaObs.y));
+    obsY = mapY(float(llaObs.x));
+    markX = markY = -1;
+    valid = false;
+    nRedraws = 0;
+}
+
+// Dotted graticule every 30 deg, the observer, then the track as line segments
+void MapScreen::drawBase(Adafruit_SH1107& d) const {
+    for (int16_t lat = -60; lat <= 60; lat += 30) {
+        int16_t y = mapY(lat), gap = lat == 0 ? 2 : 4;
+        for (int16_t x = 0; x < MAP_W; x += gap) d.drawPixel(x, y, SH110X_WHITE);
+    }
+    for (int16_t lon = -150; lon < 180; lon += 30) {
+        int16_t x = mapX(lon), gap = lon == 0 ? 2 : 4;
+        for (int16_t y = 0; y < MAP_H; y += gap) d.drawPixel(x, y, SH110X_WHITE);
+    }
+
+    d.drawFastHLine(obsX - MAP_OBS_R, obsY, 2*MAP_OBS_R + 1, SH110X_WHITE);
+    d.drawFastVLine(obsX, obsY - MAP_OBS_R, 2*MAP_OBS_R + 1, SH110X_WHITE);
+
+    // Segments crossing the antimeridian are drawn off one edge and again, shifted, off the other. Until
+    // the first track is built there is none to draw
+    const float scale = MAP_W / 360.f;
+    for (uint16_t k = 0; track.valid && k + 1 < GT_POINTS; ++k) {
+        float dLon = track.lon[k+1] - track.lon[k];
+        if (dLon > 180) dLon -= 360;
+        else if (dLon < -180) dLon += 360;
+        int16_t x0 = mapX(track.lon[k]), y0 = mapY(track.lat[k]), y1 = mapY(track.lat[k+1]);
+        int16_t x1 = x0 + int16_t(lroundf(dLon * scale));
+        d.drawLine(x0, y0, x1, y1, SH110X_WHITE);
+        if (x1 >= MAP_W) d.drawLine(x0 - MAP_W, y0, x1 - MAP_W, y1, SH110X_WHITE);
+        else if (x1 < 0) d.drawLine(x0 + MAP_W, y0, x1 + MAP_W, y1, SH110X_WHITE);
+    }
+}
+
+// Invert the marker square, which draws it or, done a second time, erases it
+void MapScreen::toggleMarker(Adafruit_SH1107& d, int16_t x, int16_t y) {
+    d.fillRect(x - MAP_MARK_R, y - MAP_MARK_R, 2*MAP_MARK_R + 1, 2*MAP_MARK_R + 1, SH110X_INVERSE);
+    regions.mark(d, x - MAP_MARK_R, y - MAP_MARK_R, 2*MAP_MARK_R + 1, 2*MAP_MARK_R + 1);
+}
+
+// Advance the track build, move the marker & send whatever changed. Returns the I2C bytes sent
+int MapScreen::update(Adafruit_SH1107& d, TwoWire& wire, OrbitModel& orb, UtcTime now) {
+    bool redraw = !valid;
+    if (track.update(orb, now)) redraw = true;
+    if (redraw) {
+        d.clearDisplay();
+        drawBase(d);
+        regions.markAll();
+        markX = markY = -1;
+        nRedraws++;
+    }
+
+    int16_t x = -1, y = -1;
+    float lat, lon;
+    if (track.subPoint(now, lat, lon)) {
+        x = mapX(lon);
+        y = mapY(lat);
+    }
+    if (x != markX || y != markY) {
+        if (markX >= 0) toggleMarker(d, markX, markY);
+        if (x >= 0) toggleMarker(d, x, y);
+        markX = x;
+        markY = y;
+    }
+
+    valid = true;
+    return regions.flush(d, wire);
+}
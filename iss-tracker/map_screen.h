@@ -0,0 +1,45 @@
+/*
+  map_screen.h - Ground track on a 128x64 equirectangular world map
+    The base layer (graticule, observer cross & the track) is drawn only when a new track is complete or
+    something else drew over the screen. In between, the satellite marker is the only thing that moves. It is
+    drawn inverted, so drawing it again at the old spot restores what was under it without keeping a copy of
+    the base layer. Frames go out through OledRegions, so a frame where the marker stays on the same pixel
+    sends nothing.
+ */
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SH110X.h>
+#include "display_frame.h"
+#include "ground_track.h"
+
+#define MAP_W           128
+#define MAP_H           64
+#define MAP_MARK_R      1       // Satellite marker is a (2R+1)^2 inverted square
+#define MAP_OBS_R       2       // Observer cross arm length
+
+// Map pixel of a longitude / latitude [deg]
+inline int16_t mapX(float lonDeg) {
+    int16_t x = int16_t(floorf((lonDeg + 180) * (MAP_W / 360.f)));
+    return constrain(x, 0, MAP_W - 1);
+}
+inline int16_t mapY(float latDeg) {
+    int16_t y = int16_t(floorf((90 - latDeg) * (MAP_H / 180.f)));
+    return constrain(y, 0, MAP_H - 1);
+}
+
+struct MapScreen {
+    GroundTrack track;
+    OledRegions regions;
+    int16_t obsX, obsY;
+    int16_t markX, markY;       // Marker as drawn, markX < 0 when not shown
+    bool valid;                 // Panel shows this screen, cleared when something else draws over it
+    uint32_t nRedraws;
+
+    void begin(const Vec3& llaObs);
+    void invalidate() { valid = false; }
+    int update(Adafruit_SH1107& d, TwoWire& wire, OrbitModel& orb, UtcTime now);
+    void drawBase(Adafruit_SH1107& d) const;
+    void toggleMarker(Adafruit_SH1107& d, int16_t x, int16_t y);
+};
@@ -1,55 +1,148 @@
 /*
   math_utils.h - Direction-Cosine-Matrix (DCM) and 3-Element Vector (Vec3) struct definitions
+    Header-only and templated on the scalar type so the math core can be instantiated in double, float or
+    fixed point (fixed_point.h). Vec3 & Dcm are the double instantiations used throughout the firmware.
+    Everything is constexpr (C++11 single-expression form, as the SAMD core still builds with gnu++11) and
+    noexcept so the coordinate pipeline inlines & constant-folds end to end. The fused forms (mulDiff, mulT,
+    rotZ) and the batch overloads skip the intermediate vectors & matrices of the operator spelling.
  */
 #pragma once
 #include <Arduino.h>
 
-// Direction-Cosine-Matrix Definition
-struct Dcm {
-    
-    double x00;
-    double x10;
-    double x20;
-    double x01;
-    double x11;
-    double x21;
-    double x02;
-    double x12;
-    double x22;
-
-    Dcm transpose(Dcm d);
-    Dcm operator*(Dcm D);
+// Blocks template argument deduction, so scalar operands convert to the vector's scalar type
+template <typename T> struct Identity { typedef T type; };
+
+// Direction-Cosine-Matrix Definition, column-major: m[3*col + row]
+template <typename T>
+struct DcmT {
+
+    T m[9];
+
+    // Element access by row & column
+    constexpr const T& operator()(uint8_t row, uint8_t col) const noexcept { return m[3*col + row]; }
+    T& operator()(uint8_t row, uint8_t col) noexcept { return m[3*col + row]; }
+
+    // DCM transposition
+    constexpr DcmT transpose() const noexcept { return DcmT{{m[0],m[3],m[6],m[1],m[4],m[7],m[2],m[5],m[8]}}; }
+
+    // DCM multiplication
+    constexpr DcmT operator*(const DcmT& D) const noexcept {
+        return DcmT {{
+            m[0]*D.m[0] + m[3]*D.m[1] + m[6]*D.m[2],
+            m[1]*D.m[0] + m[4]*D.m[1] + m[7]*D.m[2],
+            m[2]*D.m[0] + m[5]*D.m[1] + m[8]*D.m[2],
+            m[0]*D.m[3] + m[3]*D.m[4] + m[6]*D.m[5],
+            m[1]*D.m[3] + m[4]*D.m[4] + m[7]*D.m[5],
+            m[2]*D.m[3] + m[5]*D.m[4] + m[8]*D.m[5],
+            m[0]*D.m[6] + m[3]*D.m[7] + m[6]*D.m[8],
+            m[1]*D.m[6] + m[4]*D.m[7] + m[7]*D.m[8],
+            m[2]*D.m[6] + m[5]*D.m[7] + m[8]*D.m[8],
+        }};
+    }
 };
 
+// Convert a DCM to another scalar type
+template <typename T, typename U>
+constexpr DcmT<T> dcmCast(const DcmT<U>& d) noexcept {
+    return DcmT<T>{{T(d.m[0]),T(d.m[1]),T(d.m[2]),T(d.m[3]),T(d.m[4]),T(d.m[5]),T(d.m[6]),T(d.m[7]),T(d.m[8])}};
+}
+
 // 3-Element Vector Definition
-struct Vec3 {
-    
-    double x;
-    double y;
-    double z;
-
-    Vec3();
-    Vec3(double nx, double ny, double nz);
-
-    double operator[](uint8_t i);
-    double getMagnitude();
-    void normalize();
-    Vec3 getNormalized();
+template <typename T>
+struct Vec3T {
+
+    T x;
+    T y;
+    T z;
+
+    // Members in index order, so operator[] is a table lookup rather than a branch chain
+    static constexpr T Vec3T::* axes[3] = {&Vec3T::x, &Vec3T::y, &Vec3T::z};
+
+    constexpr Vec3T() noexcept : x(0), y(0), z(0) {}
+    constexpr Vec3T(T nx, T ny, T nz) noexcept : x(nx), y(ny), z(nz) {}
+    template <typename U>
+    constexpr explicit Vec3T(const Vec3T<U>& v) noexcept : x(T(v.x)), y(T(v.y)), z(T(v.z)) {}
+
+    // Vector3 element access
+    constexpr const T& operator[](uint8_t i) const noexcept { return this->*axes[i]; }
+    T& operator[](uint8_t i) noexcept { return this->*axes[i]; }
+
+    T getMagnitude() const noexcept { return sqrt(x*x + y*y + z*z); }
+    void normalize() noexcept { T m = getMagnitude(); x = x / m; y = y / m; z = z / m; }
+    Vec3T getNormalized() const noexcept { Vec3T v = *this; v.normalize(); return v; }
 };
 
+template <typename T>
+constexpr T Vec3T<T>::* Vec3T<T>::axes[3];
+
+typedef DcmT<double> Dcm;
+typedef Vec3T<double> Vec3;
+
+// Vector3 math operators
+template <typename T> constexpr Vec3T<T> operator*(const Vec3T<T>& a, const Vec3T<T>& b) noexcept { return Vec3T<T>{a.x*b.x,a.y*b.y,a.z*b.z};}
+template <typename T> constexpr Vec3T<T> operator/(const Vec3T<T>& a, const Vec3T<T>& b) noexcept { return Vec3T<T>{a.x/b.x,a.y/b.y,a.z/b.z};}
+template <typename T> constexpr Vec3T<T> operator+(const Vec3T<T>& a, const Vec3T<T>& b) noexcept { return Vec3T<T>{a.x+b.x,a.y+b.y,a.z+b.z};}
+template <typename T> constexpr Vec3T<T> operator-(const Vec3T<T>& a, const Vec3T<T>& b) noexcept { return Vec3T<T>{a.x-b.x,a.y-b.y,a.z-b.z};}
+
+template <typename T> constexpr Vec3T<T> operator*(const Vec3T<T>& a, typename Identity<T>::type b) noexcept { return Vec3T<T>{a.x*b,a.y*b,a.z*b};}
+template <typename T> constexpr Vec3T<T> operator/(const Vec3T<T>& a, typename Identity<T>::type b) noexcept { return Vec3T<T>{a.x/b,a.y/b,a.z/b};}
+template <typename T> constexpr Vec3T<T> operator+(const Vec3T<T>& a, typename Identity<T>::type b) noexcept { return Vec3T<T>{a.x+b,a.y+b,a.z+b};}
+template <typename T> constexpr Vec3T<T> operator-(const Vec3T<T>& a, typename Identity<T>::type b) noexcept { return Vec3T<T>{a.x-b,a.y-b,a.z-b};}
+
+// Vector3 dot product
+template <typename T> constexpr T dot(const Vec3T<T>& a, const Vec3T<T>& b) noexcept {return a.x*b.x + a.y*b.y + a.z*b.z;}
+// Vector3 normalization
+template <typename T> T norm(const Vec3T<T>& v) noexcept { return sqrt(v.x*v.x + v.y*v.y + v.z*v.z);}
+
+// DCM & Vector3 multiplication
+template <typename T>
+constexpr Vec3T<T> operator*(const DcmT<T>& d, const Vec3T<T>& v) noexcept {
+    return Vec3T<T> {
+        d.m[0]*v.x + d.m[3]*v.y + d.m[6]*v.z,
+        d.m[1]*v.x + d.m[4]*v.y + d.m[7]*v.z,
+        d.m[2]*v.x + d.m[5]*v.y + d.m[8]*v.z,
+    };
+}
 
-Vec3 operator*(Vec3 a, Vec3 b);
-Vec3 operator/(Vec3 a, Vec3 b);
-Vec3 operator+(Vec3 a, Vec3 b);
-Vec3 operator-(Vec3 a, Vec3 b);
+// Fused C * (a - b): rotate a relative to an origin b
+template <typename T>
+constexpr Vec3T<T> mulDiff(const DcmT<T>& d, const Vec3T<T>& a, const Vec3T<T>& b) noexcept {
+    return Vec3T<T> {
+        d.m[0]*(a.x - b.x) + d.m[3]*(a.y - b.y) + d.m[6]*(a.z - b.z),
+        d.m[1]*(a.x - b.x) + d.m[4]*(a.y - b.y) + d.m[7]*(a.z - b.z),
+        d.m[2]*(a.x - b.x) + d.m[5]*(a.y - b.y) + d.m[8]*(a.z - b.z),
+    };
+}
 
-Vec3 operator*(Vec3 a, double b);
-Vec3 operator/(Vec3 a, double b);
-Vec3 operator+(Vec3 a, double b);
-Vec3 operator-(Vec3 a, double b);
+// Fused C^T * v, the inverse rotation without forming the transpose
+template <typename T>
+constexpr Vec3T<T> mulT(const DcmT<T>& d, const Vec3T<T>& v) noexcept {
+    return Vec3T<T> {
+        d.m[0]*v.x + d.m[1]*v.y + d.m[2]*v.z,
+        d.m[3]*v.x + d.m[4]*v.y + d.m[5]*v.z,
+        d.m[6]*v.x + d.m[7]*v.y + d.m[8]*v.z,
+    };
+}
 
+// Rotation about z by the angle with cosine c & sine s, without building the DCM
+template <typename T>
+constexpr Vec3T<T> rotZ(const Vec3T<T>& v, typename Identity<T>::type c, typename Identity<T>::type s) noexcept {
+    return Vec3T<T>{c*v.x - s*v.y, s*v.x + c*v.y, v.z};
+}
 
-double dot(Vec3 a, Vec3 b);
-double norm(Vec3 v);
+// Batch DCM & Vector3 multiplication, out[i] = C * in[i]. in & out may be the same array
+template <typename T>
+void mul(const DcmT<T>& d, const Vec3T<T>* in, Vec3T<T>* out, size_t count) noexcept {
+    const DcmT<T> C = d;    // Local copy, so stores to out can't alias the matrix
+    for (size_t i = 0; i < count; ++i)
+        out[i] = C * in[i];
+}
 
-Vec3 operator*(Dcm d,Vec3 v);
+// Batch fused C * (in[i] - origin). in & out may be the same array
+template <typename T>
+void mulDiff(const DcmT<T>& d, const Vec3T<T>* in, const Vec3T<T>& origin, Vec3T<T>* out, size_t count) noexcept {
+    const DcmT<T> C = d;
+    const Vec3T<T> o = origin;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = mulDiff(C, in[i], o);
+}
@@ -0,0 +1,107 @@
+/*
+  net_link.cpp - WiFi, NTP & TLE link sequencing implementation
+ */
+#include "net_link.h"
+
+void NetLink::begin(const NetHooks& _hooks, NtpClock& _clock) {
+    hooks = _hooks;
+    clock = &_clock;
+    wifiConnecting = false;
+    wifiBeginMillis = 0;
+    ntpPacketSent = false;
+    ntpSentMillis = 0;
+    lastNtpUpdateMillis = 0;
+    tleQuerySent = false;
+    tleNeeded = true;
+    lastTleUpdateMillis = millis() - TLE_RETRY_DELAY_MS;
+}
+
+// Connect to the AP during setup(). The association call already waits, so only back off after a failure.
+// With bounded set (a warm start) a failed first attempt is left to wifiTask instead of retried here
+// Returns true once connected
+bool NetLink::associate(bool bounded) {
+    while (!hooks.wifiBegin(hooks.ctx)) {
+        if (bounded) {
+            wifiConnecting = true;
+            wifiBeginMillis = millis();
+            return false;
+        }
+        delay(WIFI_RETRY_DELAY_MS);
+    }
+    wifiConnecting = false;
+    return true;
+}
+
+// Get UTC during setup(), resending if the UDP reply is lost. With bounded set the wait ends after
+// BOOT_NTP_WAIT_MS and ntpTask keeps polling for the outstanding reply
+// Returns true once the clock is set
+bool NetLink::waitForNtp(bool bounded) {
+    uint32_t start = millis();
+    if (!wifiConnecting) {
+        hooks.ntpSend(hooks.ctx);
+        ntpSentMillis = start;
+        while (!hooks.ntpReceive(hooks.ctx)) {
+            if (bounded && millis() - start >= BOOT_NTP_WAIT_MS) break;
+            if (millis() - ntpSentMillis > NTP_RETRY_DELAY_MS) {
+                hooks.ntpSend(hooks.ctx);
+                ntpSentMillis = millis();
+            }
+        }
+    }
+    ntpPacketSent = !clock->synced;
+    if (clock->synced) lastNtpUpdateMillis = millis();
+    return clock->synced;
+}
+
+// Watch the WiFi link and reconnect without blocking
+void NetLink::wifiTask() {
+    if (hooks.wifiConnected(hooks.ctx)) {
+        wifiConnecting = false;
+        return;
+    }
+    if (!wifiConnecting || millis() - wifiBeginMillis >= WIFI_CONNECT_TIMEOUT_MS) {
+        Serial.println("Wifi disconnected, attempting to reconnect...");
+        hooks.wifiBegin(hooks.ctx);
+        wifiConnecting = true;
+        wifiBeginMillis = millis();
+    }
+}
+
+// Query NTP at the interval the clock model asks for. A reply still outstanding from setup() is resent
+// until it arrives, since nothing can be tracked before the clock is set
+void NetLink::ntpTask() {
+    if (wifiConnecting) return;
+    uint32_t now = millis();
+    if (ntpPacketSent) {
+        if (hooks.ntpReceive(hooks.ctx)) {
+            lastNtpUpdateMillis = now;
+            ntpPacketSent = false;
+        } else if (now - ntpSentMillis > NTP_RETRY_DELAY_MS) {
+            hooks.ntpSend(hooks.ctx);
+            ntpSentMillis = now;
+        }
+    } else if (now - lastNtpUpdateMillis > clock->pollInterval_ms()) {
+        hooks.ntpSend(hooks.ctx);
+        ntpPacketSent = true;
+        ntpSentMillis = now;
+    }
+}
+
+// Query Celestrak right away after boot and every TLE_RETRY_DELAY_MS until it answers, then every
+// TLE_REFRESH_DELAY_MIN, and consume the response as it arrives
+void NetLink::tleTask() {
+    if (wifiConnecting) return;
+    if (!tleQuerySent) {
+        uint32_t wait = tleNeeded ? uint32_t(TLE_RETRY_DELAY_MS) : uint32_t(TLE_REFRESH_DELAY_MIN)*60*1000;
+        if (millis() - lastTleUpdateMillis >= wait) {
+            hooks.tleSend(hooks.ctx);
+            tleQuerySent = true;
+            Serial.println("TLE Query Sent");
+        }
+    } else if (hooks.tleReceive(hooks.ctx)) {
+        if (hooks.tleApply(hooks.ctx)) tleNeeded = false;
+        else Serial.println("TLE query failed, keeping current ephemeris");
+        lastTleUpdateMillis = millis();
+        tleQuerySent = false;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+  net_link.h - WiFi, NTP & TLE link sequencing shared by setup() and the network tasks
+    Association retries, NTP resends, the boot timeouts and the TLE refresh schedule live here, apart from the
+    WiFiNINA calls, which are reached through NetHooks. On a warm start setup() gives the network one
+    association attempt and BOOT_NTP_WAIT_MS for the first NTP reply, then hands the rest to the tasks, so a slow
+    AP or time server delays tracking from the snapshot only until the clock is set instead of stalling boot.
+    The host benches run the same sequencing against scripted hooks on the virtual clock.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+#include "ntp_clock.h"
+
+// Network operations, the WiFiNINA wrappers on the board
+struct NetHooks {
+    void* ctx;
+    bool (*wifiBegin)(void* ctx);       // Start associating. Blocks until done during setup(), returns connected
+    bool (*wifiConnected)(void* ctx);
+    void (*ntpSend)(void* ctx);
+    bool (*ntpReceive)(void* ctx);      // True once a reply to the outstanding request was handled
+    void (*tleSend)(void* ctx);
+    bool (*tleReceive)(void* ctx);      // True once the response is complete or failed
+    bool (*tleApply)(void* ctx);        // Use the received TLE, false if the response didn't hold it
+};
+
+struct NetLink {
+    NetHooks hooks;
+    NtpClock* clock;
+
+    bool wifiConnecting;            // Association in progress, NTP & TLE traffic waits for it
+    uint32_t wifiBeginMillis;
+    bool ntpPacketSent;             // Reply outstanding
+    uint32_t ntpSentMillis;
+    uint32_t lastNtpUpdateMillis;
+    bool tleQuerySent;
+    bool tleNeeded;                 // No TLE from Celestrak yet, so queries are retried every TLE_RETRY_DELAY_MS
+    uint32_t lastTleUpdateMillis;
+
+    void begin(const NetHooks& hooks, NtpClock& clock);
+    bool associate(bool bounded);
+    bool waitForNtp(bool bounded);
+    void wifiTask();
+    void ntpTask();
+    void tleTask();
+};
@@ -0,0 +1,172 @@
+/*
+  ntp_clock.cpp - NTP exchange & drift-disciplined clock implementation
+ */
+#include "ntp_clock.h"
+
+// Big-endian 64-bit NTP timestamp to Unix microseconds. Seconds below 2^31 belong to era 1 (after 2036)
+int64_t ntpToUnixUs(const uint8_t* ts) {
+    uint32_t sec = uint32_t(ts[0]) << 24 | uint32_t(ts[1]) << 16 | uint32_t(ts[2]) << 8 | ts[3];
+    uint32_t frac = uint32_t(ts[4]) << 24 | uint32_t(ts[5]) << 16 | uint32_t(ts[6]) << 8 | ts[7];
+    int64_t secs = int64_t(sec) - int64_t(NTP_UNIX_OFFSET);
+    if (!(sec & 0x80000000UL)) secs += 1LL << 32;
+    return secs * 1000000 + int64_t((uint64_t(frac) * 1000000) >> 32);
+}
+
+void unixUsToNtp(int64_t unix_us, uint8_t* ts) {
+    int64_t secs = unix_us / 1000000;
+    int64_t us = unix_us - secs * 1000000;
+    if (us < 0) {
+        us += 1000000;
+        secs--;
+    }
+    uint32_t sec = uint32_t(secs + int64_t(NTP_UNIX_OFFSET));
+    uint32_t frac = uint32_t((uint64_t(us) << 32) / 1000000);
+    for (int i = 0; i < 4; ++i) {
+        ts[i] = uint8_t(sec >> (24 - 8*i));
+        ts[4 + i] = uint8_t(frac >> (24 - 8*i));
+    }
+}
+
+void NtpClock::begin() {
+    memset(this, 0, sizeof(*this));
+    poll_s = NTP_MIN_POLL_S;
+}
+
+// millis() extended to 64 bits. Must be called at least once per 49 days, which any polling loop does
+uint64_t NtpClock::localMs(uint32_t millisNow) {
+    if (millisNow < lastMillis) localHigh_ms += 1ULL << 32;
+    lastMillis = millisNow;
+    return localHigh_ms + millisNow;
+}
+
+int64_t NtpClock::predictOffset(int64_t local_us) const {
+    return refOffset_us + (local_us - refLocal_us) * drift_ppb / 1000000000LL;
+}
+
+// Current UTC [us] from the clock model, or the raw local clock before the first sample
+int64_t NtpClock::utcUs(uint32_t millisNow) {
+    int64_t local_us = int64_t(localMs(millisNow)) * 1000;
+    return synced ? local_us + predictOffset(local_us) : local_us;
+}
+
+// Fill a client request. The transmit timestamp is our best UTC estimate, tagged with a sequence number
+// in the low fraction bits so each reply can be matched to the request it answers
+void NtpClock::buildRequest(uint8_t* pkt, uint32_t millisNow) {
+    memset(pkt, 0, NTP_PACKET_SIZE);
+    pkt[0] = 0b00100011;    // LI 0, version 4, mode 3 (client)
+    pkt[2] = 6;             // Poll exponent, informational
+    pkt[3] = 0xEC;          // Precision, about 1 ms
+
+    txLocal_us = int64_t(localMs(millisNow)) * 1000;
+    unixUsToNtp(synced ? txLocal_us + predictOffset(txLocal_us) : txLocal_us, txStamp);
+    txStamp[7] = uint8_t(nSent);
+    memcpy(pkt + 40, txStamp, 8);
+    pending = true;
+    nSent++;
+}
+
+// Check a reply against the outstanding request, compute its offset & delay and update the clock model
+int NtpClock::processReply(const uint8_t* pkt, size_t len, uint32_t millisNow) {
+    int64_t rx_us = int64_t(localMs(millisNow)) * 1000;
+    uint8_t li = pkt[0] >> 6, version = (pkt[0] >> 3) & 7, mode = pkt[0] & 7, stratum = pkt[1];
+    if (len < NTP_PACKET_SIZE || !pending || mode != 4 || version < 3 || li == 3 || stratum > 15 ||
+        memcmp(pkt + 24, txStamp, 8) != 0) {
+        nInvalid++;
+        return NTP_INVALID;
+    }
+    pending = false;
+    if (stratum == 0) {
+        // Kiss-o'-death: the server wants us to query less often
+        poll_s = poll_s * 2 < NTP_MAX_POLL_S ? poll_s * 2 : NTP_MAX_POLL_S;
+        nInvalid++;
+        return NTP_INVALID;
+    }
+
+    int64_t t2 = ntpToUnixUs(pkt + 32), t3 = ntpToUnixUs(pkt + 40);
+    int64_t delay = (rx_us - txLocal_us) - (t3 - t2);
+    if (delay < 0) delay = 0;   // Local clock only resolves 1 ms
+    if (delay > NTP_MAX_DELAY_US || t3 < t2) {
+        nInvalid++;
+        return NTP_INVALID;
+    }
+    NtpSample s;
+    s.local_us = (txLocal_us + rx_us) / 2;
+    s.offset_us = ((t2 - txLocal_us) + (t3 - rx_us)) / 2;
+    s.delay_us = int32_t(delay);
+
+    // Queueing delay is rarely symmetric, so only samples near the recent minimum delay are trusted
+    delays[delayHead] = s.delay_us;
+    delayHead = (delayHead + 1) % NTP_FILTER_LEN;
+    if (nDelays < NTP_FILTER_LEN) nDelays++;
+    int32_t minDelay = s.delay_us;
+    for (uint8_t i = 0; i < nDelays; ++i) {
+        if (delays[i] < minDelay) minDelay = delays[i];
+    }
+    if (synced && s.delay_us > minDelay + NTP_DELAY_SLACK_US) {
+        nFiltered++;
+        return NTP_FILTERED;
+    }
+
+    int64_t residual = synced ? s.offset_us - predictOffset(s.local_us) : 0;
+    if (!synced || fitStale || residual > NTP_STEP_US || residual < -NTP_STEP_US) {
+        // First sample, a new server, or the clock is too far off to refine: start the model over at this offset
+        fitStale = false;
+        nFit = 0;
+        fitHead = 0;
+        drift_ppb = 0;
+        poll_s = NTP_MIN_POLL_S;
+    }
+    fit[fitHead] = s;
+    fitHead = (fitHead + 1) % NTP_FIT_LEN;
+    if (nFit < NTP_FIT_LEN) nFit++;
+    refit();
+    if (synced) adjustPoll(int32_t(residual));
+
+    lastResidual_us = int32_t(residual);
+    synced = true;
+    nAccepted++;
+    return NTP_ACCEPTED;
+}
+
+// The time server address changed. Its offset & path delay differ from the old one's, so the old samples
+// are dropped, but the clock keeps running on the current model until the new server answers
+void NtpClock::serverChanged() {
+    nDelays = 0;
+    delayHead = 0;
+    fitStale = true;
+}
+
+// Least-squares line through the accepted samples. The offset is anchored at their centroid,
+// and the slope (drift) is only taken once the samples span enough time to resolve it
+void NtpClock::refit() {
+    int64_t x0 = fit[(fitHead + NTP_FIT_LEN - 1) % NTP_FIT_LEN].local_us;
+    double sx = 0, sy = 0;
+    for (uint8_t i = 0; i < nFit; ++i) {
+        sx += double(fit[i].local_us - x0);
+        sy += double(fit[i].offset_us);
+    }
+    double mx = sx / nFit, my = sy / nFit;
+    double sxx = 0, sxy = 0, xMin = 0;
+    for (uint8_t i = 0; i < nFit; ++i) {
+        double dx = double(fit[i].local_us - x0) - mx;
+        sxx += dx * dx;
+        sxy += dx * (double(fit[i].offset_us) - my);
+        if (fit[i].local_us - x0 < xMin) xMin = double(fit[i].local_us - x0);
+    }
+    if (nFit >= 2 && -xMin >= NTP_MIN_FIT_SPAN_MS * 1000.0) {
+        double drift = sxy / sxx * 1e9;
+        drift_ppb = int32_t(constrain(drift, -NTP_MAX_DRIFT_PPB, NTP_MAX_DRIFT_PPB));
+    }
+    refLocal_us = x0 + int64_t(mx);
+    refOffset_us = int64_t(my);
+}
+
+// Back off while the model predicts well, tighten when it doesn't
+void NtpClock::adjustPoll(int32_t residual_us) {
+    int32_t err = residual_us < 0 ? -residual_us : residual_us;
+    if (err <= NTP_POLL_TIGHT_US && nFit >= 3) {
+        poll_s = poll_s * 2 < NTP_MAX_POLL_S ? poll_s * 2 : NTP_MAX_POLL_S;
+    } else if (err > 4 * NTP_POLL_TIGHT_US) {
+        poll_s = poll_s / 2 > NTP_MIN_POLL_S ? poll_s / 2 : NTP_MIN_POLL_S;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+  ntp_clock.h - NTP client exchange & a disciplined UTC clock on top of millis()
+    Each reply yields the offset of UTC from the local clock and the round-trip delay, from all four
+    timestamps (RFC 5905). Replies that don't answer the outstanding request are rejected, and samples
+    whose delay is well above the recent minimum are dropped since queueing makes them asymmetric.
+    Accepted offsets feed a least-squares fit of offset against local time, whose slope is the crystal
+    drift, so the clock stays within milliseconds and the poll interval can back off towards NTP_MAX_POLL_S.
+    The fit assumes a single server, so the caller pins one address and reports a change with serverChanged().
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+#define NTP_PACKET_SIZE     48
+#define NTP_UNIX_OFFSET     2208988800ULL   // Seconds from 1900 to 1970
+#define NTP_FILTER_LEN      8       // Recent raw samples kept for the minimum delay
+#define NTP_FIT_LEN         5       // Accepted samples in the drift fit
+#define NTP_DELAY_SLACK_US  4000    // Delay above the recent minimum still accepted
+#define NTP_MAX_DELAY_US    1000000
+#define NTP_STEP_US         128000  // Prediction error that restarts the model instead of refining it
+#define NTP_MIN_FIT_SPAN_MS 30000   // Local time the fit must span before a drift is estimated
+#define NTP_MAX_DRIFT_PPB   500000
+#define NTP_POLL_TIGHT_US   1000    // Prediction error at which the poll interval is doubled, 4x halves it
+
+// Reply classification
+enum NtpResult : int8_t {
+    NTP_INVALID = -1,       // Malformed, unsynchronized server, kiss-o'-death or not our request
+    NTP_ACCEPTED = 0,       // Clock model updated
+    NTP_FILTERED = 1        // Valid, but delayed too much to be trusted
+};
+
+struct NtpSample {
+    int64_t local_us;       // Local clock at the midpoint of the exchange
+    int64_t offset_us;      // UTC - local
+    int32_t delay_us;
+};
+
+struct NtpClock {
+    // 64-bit local clock extended from millis()
+    uint32_t lastMillis;
+    uint64_t localHigh_ms;
+
+    // Outstanding request
+    bool pending;
+    uint8_t txStamp[8];     // Transmit timestamp sent, echoed back as the originate timestamp
+    int64_t txLocal_us;
+
+    // Raw samples, for the delay gate
+    int32_t delays[NTP_FILTER_LEN];
+    uint8_t nDelays;
+    uint8_t delayHead;
+
+    // Accepted samples & the fitted model: utc = local + refOffset + drift * (local - refLocal)
+    NtpSample fit[NTP_FIT_LEN];
+    uint8_t nFit;
+    uint8_t fitHead;
+    bool synced;
+    int64_t refLocal_us;
+    int64_t refOffset_us;
+    int32_t drift_ppb;
+    int32_t lastResidual_us;    // Last accepted sample against the model's prediction
+    bool fitStale;              // Samples are from a previous server, the next accepted one starts the fit over
+
+    uint32_t poll_s;
+    uint32_t nSent, nAccepted, nFiltered, nInvalid;
+
+    void begin();
+    uint64_t localMs(uint32_t millisNow);
+    int64_t utcUs(uint32_t millisNow);
+    uint64_t utcMs(uint32_t millisNow) { return uint64_t(utcUs(millisNow) / 1000); }
+    uint32_t pollInterval_ms() const { return poll_s * 1000; }
+
+    void buildRequest(uint8_t* pkt, uint32_t millisNow);
+    int processReply(const uint8_t* pkt, size_t len, uint32_t millisNow);
+    void serverChanged();
+
+    // Internal steps
+    int64_t predictOffset(int64_t local_us) const;
+    void refit();
+    void adjustPoll(int32_t residual_us);
+};
+
+// NTP <-> Unix timestamp conversion [us], valid from 1968 to 2104
+int64_t ntpToUnixUs(const uint8_t* ts);
+void unixUsToNtp(int64_t unix_us, uint8_t* ts);
@@ -0,0 +1,102 @@
+/*
+  orbit_snapshot.cpp - Orbit snapshot record and its flash / file storage
+ */
+#include <stddef.h>
+#include "orbit_snapshot.h"
+#include "tle_catalog.h"
+#include "orbit_utils.h"
+
+#ifdef ARDUINO
+#include <FlashStorage.h>
+FlashStorage(snapshotFlash, OrbitSnapshot);
+#else
+#include <stdio.h>
+#endif
+
+// Bitwise CRC-32 (IEEE 802.3, reflected). Tableless to save flash, only run at boot & TLE updates
+uint32_t crc32(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= p[i];
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+// Populate the record from a pair of TLE lines & seal it with its CRC
+void OrbitSnapshot::fill(const char* _line1, const char* _line2, uint32_t _savedUnix) {
+    memset(this, 0, sizeof(*this));
+    magic = SNAPSHOT_MAGIC;
+    version = SNAPSHOT_VERSION;
+    size = sizeof(*this);
+    savedUnix = _savedUnix;
+    memcpy(line1, _line1, TLE_LEN);
+    memcpy(line2, _line2, TLE_LEN);
+    crc = crc32(this, offsetof(OrbitSnapshot, crc));
+}
+
+// Check header, CRC and the TLE line checksums
+bool OrbitSnapshot::valid() const {
+    return magic == SNAPSHOT_MAGIC && version == SNAPSHOT_VERSION && size == sizeof(*this) &&
+           crc == crc32(this, offsetof(OrbitSnapshot, crc)) && tleChecksumOk(line1) && tleChecksumOk(line2);
+}
+
+// Check the age of the elements, from their TLE epoch, against the current Unix time (s). An epoch in the
+// future means the clock or the record is wrong, so it is not trusted either
+bool OrbitSnapshot::fresh(uint32_t nowUnix) const {
+    int64_t epochUnix = getEpochFromTLE(line1).unixSec();
+    return epochUnix <= int64_t(nowUnix) && int64_t(nowUnix) - epochUnix <= int64_t(SNAPSHOT_MAX_AGE_H) * 3600;
+}
+
+// Check whether both records hold the same element set, whatever their save times
+bool OrbitSnapshot::sameTle(const OrbitSnapshot& other) const {
+    return memcmp(line1, other.line1, TLE_LEN) == 0 && memcmp(line2, other.line2, TLE_LEN) == 0;
+}
+
+#ifdef ARDUINO
+
+// Write the snapshot to flash, skipping the erase/write cycle if it already holds the same TLE
+int saveOrbitSnapshot(const OrbitSnapshot& snap) {
+    OrbitSnapshot stored = snapshotFlash.read();
+    if (stored.valid() && stored.sameTle(snap)) return 0;
+    snapshotFlash.write(snap);
+    return 0;
+}
+
+// Read the snapshot from flash. Returns -1 if blank or invalid
+int loadOrbitSnapshot(OrbitSnapshot& snap) {
+    snap = snapshotFlash.read();
+    return snap.valid() ? 0 : -1;
+}
+
+#else
+
+// Write the snapshot to SNAPSHOT_PATH, via a temporary file so a crash mid-write leaves the old copy.
+// Skipped if it already holds the same TLE, like the flash version
+int saveOrbitSnapshot(const OrbitSnapshot& snap) {
+    OrbitSnapshot stored;
+    if (loadOrbitSnapshot(stored) == 0 && stored.sameTle(snap)) return 0;
+
+    FILE* fp = fopen(SNAPSHOT_PATH ".tmp", "wb");
+    if (!fp) return -1;
+    bool ok = fwrite(&snap, sizeof(snap), 1, fp) == 1;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(SNAPSHOT_PATH ".tmp", SNAPSHOT_PATH) != 0) {
+        remove(SNAPSHOT_PATH ".tmp");
+        return -1;
+    }
+    return 0;
+}
+
+// Read the snapshot from SNAPSHOT_PATH. Returns -1 if missing, short or invalid
+int loadOrbitSnapshot(OrbitSnapshot& snap) {
+    FILE* fp = fopen(SNAPSHOT_PATH, "rb");
+    if (!fp) return -1;
+    bool ok = fread(&snap, sizeof(snap), 1, fp) == 1;
+    fclose(fp);
+    return ok && snap.valid() ? 0 : -1;
+}
+
+#endif
@@ -0,0 +1,34 @@
+/*
+  orbit_snapshot.h - Persistent copy of the last good TLE for warm starts without network access
+    The record is versioned and CRC-protected so a blank, corrupted or outdated-layout store is
+    rejected instead of producing a bogus orbit. A valid record whose TLE epoch is more than SNAPSHOT_MAX_AGE_H
+    before the current time is kept but not trusted for a warm start, since the elements have decayed by then.
+    Stored in MCU flash on target, in a file on the host. Saving the same TLE again doesn't rewrite it, so
+    hourly refreshes only cost a flash erase when Celestrak publishes new elements.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+#define SNAPSHOT_MAGIC      0x31535349UL    // "ISS1"
+#define SNAPSHOT_VERSION    1
+#define SNAPSHOT_PATH       "orbit_snapshot.bin"   // Host only
+
+struct OrbitSnapshot {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;          // sizeof(OrbitSnapshot), catches layout changes within a version
+    uint32_t savedUnix;     // Unix time (s) of the first save of these elements, from the NTP-disciplined clock
+    char line1[TLE_LEN];    // TLE lines rather than parsed elements, so Orbit & Sgp4 can both be rebuilt
+    char line2[TLE_LEN];
+    uint32_t crc;           // CRC-32 of all preceding bytes, including padding
+
+    void fill(const char* line1, const char* line2, uint32_t savedUnix);
+    bool valid() const;
+    bool fresh(uint32_t nowUnix) const;
+    bool sameTle(const OrbitSnapshot& other) const;
+};
+
+uint32_t crc32(const void* data, size_t len);
+int saveOrbitSnapshot(const OrbitSnapshot& snap);
+int loadOrbitSnapshot(OrbitSnapshot& snap);
@@ -0,0 +1,103 @@
+/*
+  orbit_tracker.cpp - Warm-started incremental propagation
+ */
+#include "orbit_tracker.h"
+
+// Earth-fixed velocity for a given ERA, the stateless counterpart of OrbitTracker::eciVel2ecef
+Vec3 eciVel2ecef(const Vec3& posECI, const Vec3& velECI, double era) {
+    return eci2ecef(Vec3{velECI.x + EARTH_ROT_RATE*posECI.y,
+                         velECI.y - EARTH_ROT_RATE*posECI.x,
+                         velECI.z}, -era);
+}
+
+// Cache orbit-constant terms & reset tick state
+void OrbitTracker::init(Orbit& _orb) {
+    orb = &_orb;
+
+    double cos_w, sin_w, cos_O, sin_O, cos_i, sin_i;
+    sinCos(orb->omega, sin_w, cos_w);
+    sinCos(orb->Omega, sin_O, cos_O);
+    sinCos(orb->incl, sin_i, cos_i);
+    dcm_plane2ECI = Dcm{cos_w*cos_O - sin_w*cos_i*sin_O,
+                        cos_w*sin_O + sin_w*cos_i*cos_O,
+                        sin_w*sin_i,
+                        -(sin_w*cos_O + cos_w*cos_i*sin_O),
+                        (cos_w*cos_i*cos_O - sin_w*sin_O),
+                        cos_w*sin_i,
+                        0, 0, 0};
+
+    sqrt1me2 = sqrt(1. - orb->ecc*orb->ecc);
+    velScale = sqrt(MU_EARTH * orb->a);
+    primed = false;
+}
+
+// Propagate to UTC_ms, reusing the previous tick's eccentric anomaly & ERA
+void OrbitTracker::update(uint64_t UTC_ms, Vec3& posECI, Vec3& velECI) {
+    UtcTime t = UtcTime::fromUnixMs(UTC_ms);
+    double dt = t.secondsSince(orb->epoch);
+    double ecc = orb->ecc;
+    double M_t = orb->M0 + (orb->n + orb->n_dot*dt)*dt;
+
+    bool restart = !primed || UTC_ms < lastUTC_ms || (UTC_ms - lastUTC_ms) > TRACKER_MAX_GAP_MS
+                   || ticksSinceResync >= TRACKER_RESYNC_TICKS;
+
+    if (restart) {
+        // Cold start from the stateless solution
+        E = eccAnomalyFromMean(M_t, ecc);
+        sinCos(E, sinE, cosE);
+        eraClock.set(t);
+        era = eraClock.angle();
+        sinCos(era, sinEra, cosEra);
+        ticksSinceResync = 0;
+        primed = true;
+    } else {
+        // Seed Newton with the previous E advanced by the change in mean anomaly, i.e. dE = dM/(dM/dE)
+        double M_prev = E - ecc*sinE;
+        double E_seed = E + (M_t - M_prev) / (1. - ecc*cosE);
+        double dE = 1.;
+        for (int iter = 0; iter < 4 && fabs(dE) > 1e-12; ++iter) {
+            sinCos(E_seed, sinE, cosE);
+            dE = (E_seed - ecc*sinE - M_t) / (1. - ecc*cosE);
+            E_seed -= dE;
+        }
+        // Last correction is tiny, so update sin/cos to first order instead of re-evaluating them
+        double sinPrev = sinE;
+        sinE -= cosE*dE;
+        cosE += sinPrev*dE;
+        E = E_seed;
+
+        // Step ERA exactly, then rotate its sin/cos by the step. The angle is < 5e-3 rad within
+        // TRACKER_MAX_GAP_MS, so short Taylor series are exact to double precision
+        double dEra = turnsToDeltaRad(eraClock.advanceTo(t));
+        double d2 = dEra*dEra;
+        double c = 1. - d2/2.*(1. - d2/12.*(1. - d2/30.));
+        double s = dEra*(1. - d2/6.*(1. - d2/20.*(1. - d2/42.)));
+        double cNew = cosEra*c - sinEra*s;
+        sinEra = sinEra*c + cosEra*s;
+        cosEra = cNew;
+        era = eraClock.angle();
+        ticksSinceResync++;
+    }
+    lastUTC_ms = UTC_ms;
+
+    // In-plane position & velocity directly from E, no true anomaly needed
+    double r_c = orb->a*(1. - ecc*cosE);
+    Vec3 posPlane = {orb->a*(cosE - ecc), orb->a*sqrt1me2*sinE, 0};
+    double v = velScale/r_c;
+    Vec3 velPlane = {-v*sinE, v*sqrt1me2*cosE, 0};
+
+    posECI = dcm_plane2ECI * posPlane;
+    velECI = dcm_plane2ECI * velPlane;
+}
+
+// Rotate ECI to ECEF with the ERA of the last update, equivalent to ::eci2ecef(eci, -era)
+Vec3 OrbitTracker::eci2ecef(const Vec3& eci) const {
+    return rotZ(eci, cosEra, -sinEra);
+}
+
+// Earth-fixed velocity: rotate the inertial velocity less the frame rotation term w x r
+Vec3 OrbitTracker::eciVel2ecef(const Vec3& posECI, const Vec3& velECI) const {
+    return eci2ecef(Vec3{velECI.x + EARTH_ROT_RATE*posECI.y,
+                         velECI.y - EARTH_ROT_RATE*posECI.x,
+                         velECI.z});
+}
@@ -0,0 +1,39 @@
+/*
+  orbit_tracker.h - Stateful propagator for closely spaced ticks
+    Caches everything Orbit::calcPosVelECI recomputes per call, warm-starts the Kepler solve from the previous tick,
+    and steps the Earth-Rotation-Angle with an EraClock, rotating its sin/cos by the per-tick angle instead of
+    re-evaluating them.
+ */
+#pragma once
+#include <Arduino.h>
+#include "orbit_utils.h"
+
+// Re-derive the ERA sin/cos from the absolute time every this many ticks to stop rounding drift accumulating
+#define TRACKER_RESYNC_TICKS  1000
+// Gaps between ticks longer than this [ms], or going backward, restart from the stateless solution
+#define TRACKER_MAX_GAP_MS    60000
+
+Vec3 eciVel2ecef(const Vec3& posECI, const Vec3& velECI, double era);
+
+// Incremental propagator bound to one Orbit
+struct OrbitTracker {
+    Orbit* orb;
+
+    // Constant per orbit
+    Dcm dcm_plane2ECI;
+    double sqrt1me2;    // sqrt(1 - ecc^2)
+    double velScale;    // sqrt(MU_EARTH * a)
+
+    // State carried between ticks
+    bool primed;
+    uint64_t lastUTC_ms;
+    uint32_t ticksSinceResync;
+    double E, sinE, cosE;
+    EraClock eraClock;
+    double era, cosEra, sinEra;
+
+    void init(Orbit& orb);
+    void update(uint64_t UTC_ms, Vec3& posECI, Vec3& velECI);
+    Vec3 eci2ecef(const Vec3& eci) const;
+    Vec3 eciVel2ecef(const Vec3& posECI, const Vec3& velECI) const;
+};
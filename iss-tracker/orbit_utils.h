@@ -1,43 +1,174 @@
 /*
-  orbit_utils.h - Utilities to handle orbit initialization and propagation, and time conversions
+  orbit_utils.h - Utilities to handle orbit initialization and propagation
+    Propagation is templated on the scalar type like the rest of the math core; Orbit is the double
+    instantiation. The epoch is a UtcTime (time_utils.h), so elapsed time since it is exact before it is rounded
+    to T.
  */
 #pragma once
 #include <Arduino.h>
+#include <float.h>
 #include <time.h>
 #include "coord.h"
+#include "time_utils.h"
 
 #define EARTH_ROT_RATE 7.2921159e-5
 #define MU_EARTH 3.986004418e14
-#define J2000 2451545.5
-#define J1900 (J2000 - 36525. - 1.)
 #define SECONDS_PER_DAY 86400.
 #define SECONDS_PER_DAY_SQ (SECONDS_PER_DAY*SECONDS_PER_DAY)
-#define J2U 2440587.5
+#define KEPLER_MAX_ITER 30  // Newton converges in <10 iterations for any ecc < 0.9; caps narrow types at their noise floor
 
-double getJulianFromUnix( long unixSecs );
-long getUnixSecFromJulian(double julian);
-double getEraFromJulian(double julian);
-double eccAnomalyFromMean(double M0, double ecc);
-double trueAnomalyFromEcc(double E, double ecc);
-double trueAnomalyFromMean(double M0, double ecc);
+// Kepler solver tolerance: 1e-8 rad, or a few ulps where the type can't resolve that
+template <typename T> struct KeplerTol { static T value() { return T(1e-8); } };
+template <> struct KeplerTol<float> { static float value() { return 8 * FLT_EPSILON; } };
+
+// Calculate Eccentric Anomaly from Mean Anomaly
+template <typename T>
+T eccAnomalyFromMean(T M0, T ecc) {
+    T E = M0, dE = 1, sinE, cosE;
+    // Iterative Newton-Raphson solution for eccentic anomaly
+    for (int i = 0; i < KEPLER_MAX_ITER && fabs(dE) > KeplerTol<T>::value(); ++i) {
+        sinCos(E, sinE, cosE);
+        dE = (E - ecc*sinE - M0)/(1 - ecc*cosE);
+        E = E - dE;
+    }
+    return E;
+}
+
+// Calculate True Anomaly from Eccentric Anomaly
+template <typename T>
+T trueAnomalyFromEcc(T E, T ecc) {
+    T sinHalf, cosHalf;
+    sinCos(E/2, sinHalf, cosHalf);
+    return 2*arcTan2(sqrt(1+ecc)*sinHalf,sqrt(1-ecc)*cosHalf);
+}
+
+// Calculate True Anomaly from Mean Anomaly
+template <typename T>
+T trueAnomalyFromMean(T M0, T ecc) {
+    T E = eccAnomalyFromMean(M0,ecc);
+    return trueAnomalyFromEcc(E,ecc);
+}
 
 // Struct holding orbital elements
-struct Orbit {
-    double epoch_J;
-    uint32_t epochUTC;
-    double incl;
-    double a;
-    double ecc;
-    double Omega;
-    double omega;
-    double M0;
-    double n;
-
-    double n_dot;
-
-    void initFromTLE(char* line1, char* line2);
-    void calcPosECI(double dt_sec, Vec3& posECI);
-    void calcPosECI_UTC(uint64_t UTC_ms, Vec3& posECI);
-    void calcPosVelECI(double dt_sec, Vec3& posECI, Vec3& velECI);
-    void calcPosVelECI_UTC(uint64_t UTC_ms, Vec3& posECI, Vec3& velECI);
+template <typename T>
+struct OrbitT {
+    UtcTime epoch;
+    T incl;
+    T a;
+    T ecc;
+    T Omega;
+    T omega;
+    T M0;
+    T n;
+
+    T n_dot;
+
+    void initFromTLE(const char* line1, const char* line2);
+    void calcPosECI(T dt_sec, Vec3T<T>& posECI);
+    void calcPosECI_UTC(UtcTime t, Vec3T<T>& posECI);
+    void calcPosVelECI(T dt_sec, Vec3T<T>& posECI, Vec3T<T>& velECI);
+    void calcPosVelECI_UTC(UtcTime t, Vec3T<T>& posECI, Vec3T<T>& velECI);
 };
+
+typedef OrbitT<double> Orbit;
+
+UtcTime getEpochFromTLE(const char* line1);
+void parseTLE(const char* line1, const char* line2, Orbit& orb);
+
+// Initialize orbital elements from Two-Line-Element (TLE), parsed in double and rounded to T
+template <typename T>
+void OrbitT<T>::initFromTLE(const char* line1, const char* line2) {
+    Orbit d;
+    parseTLE(line1, line2, d);
+    epoch = d.epoch;
+    incl = T(d.incl);
+    a = T(d.a);
+    ecc = T(d.ecc);
+    Omega = T(d.Omega);
+    omega = T(d.omega);
+    M0 = T(d.M0);
+    n = T(d.n);
+    n_dot = T(d.n_dot);
+}
+
+// Rotation from the orbit plane (x toward perigee) to ECI, from the current angular elements
+template <typename T>
+DcmT<T> dcmPlane2ECI(const OrbitT<T>& orb) {
+    T cos_w, cos_O, cos_i;
+    T sin_w, sin_O, sin_i;
+    sinCos(orb.omega, sin_w, cos_w);
+    sinCos(orb.Omega, sin_O, cos_O);
+    sinCos(orb.incl, sin_i, cos_i);
+
+    return DcmT<T>{cos_w*cos_O - sin_w*cos_i*sin_O,
+                   cos_w*sin_O + sin_w*cos_i*cos_O,
+                   sin_w*sin_i,
+                   -(sin_w*cos_O + cos_w*cos_i*sin_O),
+                   (cos_w*cos_i*cos_O - sin_w*sin_O),
+                   cos_w*sin_i,
+                   0, 0, 0};
+}
+
+// Calculate Earth-Centered-Inertial (ECI) position at some delta-T seconds in the future from the orbital epoch
+template <typename T>
+void OrbitT<T>::calcPosECI(T dt_sec, Vec3T<T>& posECI) {
+    T n_t = n + n_dot*dt_sec;
+
+    T M_t = M0 + n_t*dt_sec;
+
+    T E_t = eccAnomalyFromMean(M_t,ecc);
+    // Get true anomaly
+    T v_t = trueAnomalyFromEcc(E_t,ecc);
+    // Get distance from center
+    T sinV, cosV;
+    sinCos(v_t, sinV, cosV);
+    T r_c = a*(1-ecc*cos(E_t));
+
+    Vec3T<T> posPlane = {r_c*cosV,r_c*sinV,0};
+
+    posECI = dcmPlane2ECI(*this) * posPlane;
+}
+
+// Calculate Earth-Centered-Inertial (ECI) position at a specific UTC time
+template <typename T>
+void OrbitT<T>::calcPosECI_UTC(UtcTime t, Vec3T<T>& posECI) {
+    calcPosECI(T(t.secondsSince(epoch)),posECI);
+}
+
+// Calculate Earth-Centered-Inertial (ECI) position & velocity at some delta-T seconds in the future from the orbital epoch
+template <typename T>
+void OrbitT<T>::calcPosVelECI(T dt_sec, Vec3T<T>& posECI, Vec3T<T>& velECI) {
+    T n_t = n + n_dot*dt_sec;
+
+    T M_t = M0 + n_t*dt_sec;
+
+    T E_t = eccAnomalyFromMean(M_t,ecc);
+    // Get true anomaly
+    T v_t = trueAnomalyFromEcc(E_t,ecc);
+    // Get distance from center
+    T sinE, cosE, sinV, cosV;
+    sinCos(E_t, sinE, cosE);
+    sinCos(v_t, sinV, cosV);
+    T r_c = a*(1-ecc*cosE);
+
+    DcmT<T> dcm_plane2ECI = dcmPlane2ECI(*this);
+
+    T o_x = r_c*cosV;
+    T o_y = r_c*sinV;
+
+    T v = sqrt(T(MU_EARTH) * a)/r_c;
+    T v_x = v * -sinE;
+    T v_y = v * (sqrt(1 - (ecc*ecc)) * cosE);
+
+    Vec3T<T> posPlane = {o_x,o_y,0};
+    Vec3T<T> velPlane = {v_x,v_y,0};
+
+    posECI = dcm_plane2ECI * posPlane;
+    velECI = dcm_plane2ECI * velPlane;
+}
+
+// Calculate Earth-Centered-Inertial (ECI) position & velocity at a specific UTC time
+template <typename T>
+void OrbitT<T>::calcPosVelECI_UTC(UtcTime t, Vec3T<T>& posECI, Vec3T<T>& velECI) {
+    calcPosVelECI(T(t.secondsSince(epoch)),posECI,velECI);
+}
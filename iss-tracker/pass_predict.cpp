@@ -0,0 +1,204 @@
+/*
+  pass_predict.cpp - Pass prediction by adaptive coarse stepping on elevation, bracketing of mask crossings,
+    and root/extremum refinement
+ */
+#include "pass_predict.h"
+
+// Context for evaluating look angles relative to a fixed start time, with propagation & frame math in T.
+// Search state and times stay in double
+template <typename T>
+struct PassSearch {
+    OrbitT<T>* orb;
+    ObserverFrameT<T> obs;
+    uint64_t startUTC_ms;
+    double elMask;
+    double maxCentralRate;  // Upper bound on the sub-satellite point's angular rate [rad/s]
+    uint32_t nEvals;
+
+    // Az/El/Range at t seconds after start, optionally also the central angle to the observer beyond
+    // which the satellite can't be above the mask [rad]
+    Vec3 aer(double t, double* psiMargin=NULL) {
+        UtcTime utc = UtcTime::fromUnixMs(startUTC_ms + uint64_t(llround(t * 1e3)));
+        Vec3T<T> posECI;
+        orb->calcPosECI_UTC(utc, posECI);
+        double era = utc.era();
+        Vec3T<T> posECEF = eci2ecef(posECI, T(-era));
+        nEvals++;
+
+        if (psiMargin) {
+            Vec3 pos = Vec3(posECEF), obsPos = Vec3(obs.ecef);
+            double r = norm(pos);
+            double cosPsi = dot(pos, obsPos) / (r * norm(obsPos));
+            double elMaskRad = elMask * DEG_TO_RAD;
+            double psiMax = acos(constrain(a * cos(elMaskRad) / r, -1.0, 1.0)) - elMaskRad;
+            *psiMargin = acos(constrain(cosPsi, -1.0, 1.0)) - psiMax - PASS_PSI_PAD_RAD;
+        }
+        return Vec3(obs.lookAngles(posECEF));
+    }
+
+    // Elevation above the mask at t seconds after start
+    double elAboveMask(double t) { return aer(t).y - elMask; }
+};
+
+// Refine a mask crossing bracketed by [t0,t1] with the Illinois variant of regula falsi
+template <typename T>
+static double refineCrossing(PassSearch<T>& s, double t0, double f0, double t1, double f1) {
+    int side = 0;
+    double t = t0;
+    for (int iter = 0; iter < 50 && (t1 - t0) > PASS_TIME_TOL_S; ++iter) {
+        t = (t0*f1 - t1*f0) / (f1 - f0);
+        double f = s.elAboveMask(t);
+        if (f * f1 > 0) {
+            t1 = t; f1 = f;
+            if (side == -1) f0 /= 2;
+            side = -1;
+        } else if (f0 * f > 0) {
+            t0 = t; f0 = f;
+            if (side == 1) f1 /= 2;
+            side = 1;
+        } else {
+            return t;
+        }
+        // Exit early once the estimate stops moving, the bracket may stay wide on one side
+        if (fabs(f) < 1e-6) break;
+    }
+    return t;
+}
+
+// Find time of peak elevation within [t0,t1] with Brent's method (golden section + parabolic interpolation)
+template <typename T>
+static double refineCulmination(PassSearch<T>& s, double t0, double t1) {
+    const double cGold = 0.3819660112501051;
+    double x = t0 + cGold*(t1 - t0), w = x, v = x;
+    double fx = -s.elAboveMask(x), fw = fx, fv = fx;
+    double d = 0, e = 0;
+
+    for (int iter = 0; iter < 50; ++iter) {
+        double xm = 0.5*(t0 + t1);
+        double tol2 = 2*PASS_CULM_TOL_S;
+        if (fabs(x - xm) <= tol2 - 0.5*(t1 - t0)) break;
+
+        bool golden = true;
+        if (fabs(e) > PASS_CULM_TOL_S) {
+            // Try a parabolic step through x, w & v
+            double r = (x - w)*(fx - fv);
+            double q = (x - v)*(fx - fw);
+            double p = (x - v)*q - (x - w)*r;
+            q = 2*(q - r);
+            if (q > 0) p = -p;
+            q = fabs(q);
+            if (fabs(p) < fabs(0.5*q*e) && p > q*(t0 - x) && p < q*(t1 - x)) {
+                e = d;
+                d = p/q;
+                golden = false;
+            }
+        }
+        if (golden) {
+            e = (x >= xm) ? t0 - x : t1 - x;
+            d = cGold*e;
+        }
+
+        double u = x + (fabs(d) >= PASS_CULM_TOL_S ? d : (d > 0 ? PASS_CULM_TOL_S : -PASS_CULM_TOL_S));
+        double fu = -s.elAboveMask(u);
+        if (fu <= fx) {
+            if (u >= x) t0 = x; else t1 = x;
+            v = w; fv = fw;
+            w = x; fw = fx;
+            x = u; fx = fu;
+        } else {
+            if (u < x) t0 = u; else t1 = u;
+            if (fu <= fw || w == x) {
+                v = w; fv = fw;
+                w = u; fw = fu;
+            } else if (fu <= fv || v == x || v == w) {
+                v = u; fv = fu;
+            }
+        }
+    }
+    return x;
+}
+
+// Coarse step that can't skip over the visibility cone
+// The sub-satellite point can't move faster than maxCentralRate, so the central-angle distance to the edge of the
+// cone bounds how long the satellite needs to enter it. Near & inside the cone, a fixed step is used and low passes
+// that peak between samples are caught by checking local elevation maxima.
+template <typename T>
+static double safeStep(const PassSearch<T>& s, double psiMargin) {
+    double step = PASS_NEAR_STEP_S;
+    if (psiMargin > 0)
+        step = fmax(step, psiMargin / s.maxCentralRate);
+    return fmin(step, PASS_MAX_STEP_S);
+}
+
+// Fill in a pass record from refined AOS, culmination & LOS times
+template <typename T>
+static void recordPass(PassSearch<T>& s, Pass& p, double tAos, double tMax, double tLos) {
+    p.aosUTC_ms = s.startUTC_ms + uint64_t(llround(tAos * 1e3));
+    p.maxUTC_ms = s.startUTC_ms + uint64_t(llround(tMax * 1e3));
+    p.losUTC_ms = s.startUTC_ms + uint64_t(llround(tLos * 1e3));
+    p.aosAz = s.aer(tAos).x;
+    p.losAz = s.aer(tLos).x;
+    Vec3 aerMax = s.aer(tMax);
+    p.maxAz = aerMax.x;
+    p.maxEl = aerMax.y;
+}
+
+template <typename T>
+static int predictPassesT(OrbitT<T>& orbit, const Vec3& observerLLA, uint64_t startUTC_ms, double horizon_sec,
+                          Pass* passes, int maxPasses, double elMaskDeg, uint32_t* nEvals) {
+    // Fastest the orbit can sweep across the ground: angular rate at perigee plus Earth rotation
+    double ecc = double(orbit.ecc);
+    double perigeeRate = double(orbit.n) * (1 + ecc)*(1 + ecc) / pow(1 - ecc*ecc, 1.5);
+    PassSearch<T> s = {&orbit, ObserverFrameT<T>{}, startUTC_ms, elMaskDeg, perigeeRate + EARTH_ROT_RATE, 0};
+    s.obs.init(observerLLA, DEGREES);
+    int nPasses = 0;
+
+    double psi;
+    double t = 0;
+    double f = s.aer(t, &psi).y - elMaskDeg;
+    double tPrev = -1, fPrev = 0;
+    double tAos = f >= 0 ? 0 : -1;
+
+    while (t < horizon_sec && nPasses < maxPasses) {
+        double tNext = fmin(t + safeStep(s, psi), horizon_sec);
+        double fNext = s.aer(tNext, &psi).y - elMaskDeg;
+
+        if (f < 0 && fNext >= 0) {
+            // Rising through the mask
+            tAos = refineCrossing(s, t, f, tNext, fNext);
+        } else if (f >= 0 && fNext < 0 && tAos >= 0) {
+            // Setting through the mask, pass complete
+            double tLos = refineCrossing(s, t, f, tNext, fNext);
+            recordPass(s, passes[nPasses++], tAos, refineCulmination(s, tAos, tLos), tLos);
+            tAos = -1;
+        } else if (fNext < 0 && f < 0 && tPrev >= 0 && f > fPrev && f >= fNext && f > -PASS_GRAZE_DEG) {
+            // Elevation peaked just below the mask between samples, check if it briefly rose above it
+            double tMax = refineCulmination(s, tPrev, tNext);
+            double fMax = s.elAboveMask(tMax);
+            if (fMax >= 0) {
+                double tA = refineCrossing(s, tPrev, fPrev, tMax, fMax);
+                double tL = refineCrossing(s, tMax, fMax, tNext, fNext);
+                recordPass(s, passes[nPasses++], tA, tMax, tL);
+            }
+        }
+        tPrev = t; fPrev = f;
+        t = tNext; f = fNext;
+    }
+
+    if (nEvals) *nEvals = s.nEvals;
+    return nPasses;
+}
+
+// Predict passes within horizon_sec of startUTC_ms, writing up to maxPasses into passes
+// A pass already in progress at the start time is reported with AOS at the start time.
+// Returns the number of passes found, and optionally the number of look-angle evaluations it took
+int predictPasses(Orbit& orbit, const Vec3& observerLLA, uint64_t startUTC_ms, double horizon_sec,
+                  Pass* passes, int maxPasses, double elMaskDeg, uint32_t* nEvals) {
+    return predictPassesT(orbit, observerLLA, startUTC_ms, horizon_sec, passes, maxPasses, elMaskDeg, nEvals);
+}
+
+// Same search with single-precision propagation & look angles, about a third of the double cost in soft-float
+int predictPasses(OrbitT<float>& orbit, const Vec3& observerLLA, uint64_t startUTC_ms, double horizon_sec,
+                  Pass* passes, int maxPasses, double elMaskDeg, uint32_t* nEvals) {
+    return predictPassesT(orbit, observerLLA, startUTC_ms, horizon_sec, passes, maxPasses, elMaskDeg, nEvals);
+}
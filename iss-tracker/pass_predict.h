@@ -0,0 +1,42 @@
+/*
+  pass_predict.h - Predict upcoming passes (AOS, culmination, LOS) of an orbit over an observer
+    A week of ISS passes takes ~2.5k look-angle evaluations. At ~4.6 ms per double evaluation in soft-float that
+    is ~11 s on the M0, ~4 s with the float overload (bench_passes), so on the board it belongs in a background
+    job spread over many scheduler ticks, never in a single task run.
+ */
+#pragma once
+#include <Arduino.h>
+#include "coord.h"
+#include "orbit_utils.h"
+
+// Coarse search step near or inside the visibility cone, and upper limit far from it [s]
+#define PASS_NEAR_STEP_S  60.0
+#define PASS_MAX_STEP_S   1800.0
+
+// Local elevation maxima this close below the mask [deg] are refined in case the pass peaks between samples
+#define PASS_GRAZE_DEG    3.0
+
+// Extra central-angle margin on the visibility cone, covers Earth oblateness [rad]
+#define PASS_PSI_PAD_RAD  0.01
+
+// Refinement tolerance on AOS/LOS times [s]
+#define PASS_TIME_TOL_S   0.05
+
+// Refinement tolerance on culmination time [s], elevation is flat there so this can be looser
+#define PASS_CULM_TOL_S   0.5
+
+// A single pass of the satellite above the elevation mask
+struct Pass {
+    uint64_t aosUTC_ms;     // Acquisition of signal (rising through the mask)
+    uint64_t maxUTC_ms;     // Culmination
+    uint64_t losUTC_ms;     // Loss of signal (setting through the mask)
+    double aosAz;           // Azimuths at AOS & LOS [deg]
+    double losAz;
+    double maxEl;           // Peak elevation [deg]
+    double maxAz;           // Azimuth at peak elevation [deg]
+};
+
+int predictPasses(Orbit& orbit, const Vec3& observerLLA, uint64_t startUTC_ms, double horizon_sec,
+                  Pass* passes, int maxPasses, double elMaskDeg=0.0, uint32_t* nEvals=NULL);
+int predictPasses(OrbitT<float>& orbit, const Vec3& observerLLA, uint64_t startUTC_ms, double horizon_sec,
+                  Pass* passes, int maxPasses, double elMaskDeg=0.0, uint32_t* nEvals=NULL);
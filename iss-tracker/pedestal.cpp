@@ -2,16 +2,7 @@
   pedestal.cpp - Functions to control pedestal orientation and pointer elevation
  */
 #include "pedestal.h"
-
-// Convert # of steps in stepper motor to equivalent relative pedestal angle in degrees
-double steps2deg(long steps) {
-    return double(-steps) * 360.0 / STEPS_PER_REV;
-}
-
-// Convert pedestal angle in degrees to equivalent # of steps in stepper motor
-long deg2steps(double azDeg) {
-    return floor(-azDeg * STEPS_PER_REV / 360.0);
-}
+#include "profile.h"
 
 // Initialize Servo, Stepper, and Compass (if Active)
 void Pedestal::begin() {
@@ -23,6 +14,8 @@ void Pedestal::begin() {
     stepper = AccelStepper(AccelStepper::FULL4WIRE, STEP1, STEP2, STEP3, STEP4);
     stepper.setMaxSpeed(STEPPER_SPEED);
     stepper.setAcceleration(STEPPER_ACCEL);
+    track.begin();
+    feedForward = TRACK_FEED_FORWARD;
     
     // Initialise the compass
     compass = Adafruit_MMC5603(12345);
@@ -41,6 +34,7 @@ void Pedestal::zero() {
 
 // Set target pedestal azimuth
 void Pedestal::setTargetAz(double targetAzDeg) {
+    PROFILE_SCOPE(PROF_SET_TARGET_AZ);
     double currAz = steps2deg(stepper.currentPosition());
 
     currAz = fmod(currAz + 3600,360.0);
@@ -66,9 +60,41 @@ void Pedestal::setElevation(double el) {
     servo.writeMicroseconds(map(long(el*100),0,18000,SERVO_MIN_PWM,SERVO_MAX_PWM));
 }
 
-// Run stepper if needed
+// Follow a moving target from its Az/El [deg] and rates [deg/s] instead of stepping to fixed targets
+void Pedestal::setTrack(double az, double azRate, double el, double elRate) {
+    track.setTarget(az, azRate, el, elRate, millis());
+}
+
+// Point at a target from its Az/El [deg] and rates [deg/s], in the configured tracking mode
+void Pedestal::point(const Vec3& aer, const Vec3& rates) {
+    if (feedForward) {
+        // Stepper speed & servo are refreshed from the extrapolated target between ticks
+        setTrack(aer.x, rates.x, aer.y, rates.y);
+    } else {
+        // Coming off feed-forward: drop the track so runStepper() steps to targets again, from where it is now
+        if (track.active) {
+            track.begin();
+            stepper.moveTo(stepper.currentPosition());
+        }
+        // Update target azimuth only if reached current step target (to avoid interrupting smooth movement)
+        if (stepper.distanceToGo() == 0)
+            setTargetAz(aer.x);
+        setElevation(90 + aer.y);
+    }
+}
+
+// Run stepper if needed. While tracking, refresh the speed & elevation commands every TRACK_UPDATE_MS
 void Pedestal::runStepper() {
-    stepper.run();
+    if (track.active) {
+        uint32_t now = millis();
+        if (now - track.lastUpdate_ms >= TRACK_UPDATE_MS) {
+            stepper.setSpeed(track.speedCommand(stepper.currentPosition(), now));
+            setElevation(90 + track.elAt(now));
+        }
+        stepper.runSpeed();
+    } else {
+        stepper.run();
+    }
 }
 
 // Attempt to point pedestal northward based on average of multiple compass measurements
@@ -9,9 +9,7 @@
 #include <Adafruit_MMC56x3.h>
 #include "coord.h"
 #include "defs.h"
-
-double steps2deg(long steps);
-long deg2steps(double azDeg);
+#include "track_control.h"
 
 
 // Struct that wraps around pedestal control devices (Servo, Stepper, & Compass)
@@ -20,11 +18,15 @@ struct Pedestal {
     AccelStepper stepper;
     Adafruit_MMC5603 compass;
     sensors_event_t compassEvent;
+    TrackControl track;
+    bool feedForward;       // Follow with velocity feed-forward rather than fixed step targets
 
     void begin();
     void zero();
     void setTargetAz(double azDeg);
     void setElevation(double el);
+    void setTrack(double az, double azRate, double el, double elRate);
+    void point(const Vec3& aer, const Vec3& rates);
     void runStepper();
     void pointNorth();
     double getHeading();
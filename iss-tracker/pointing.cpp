@@ -0,0 +1,109 @@
+/*
+  pointing.cpp - Pointing solution implementation
+ */
+#include "pointing.h"
+#include "profile.h"
+
+// ECI position source for the ephemeris cache
+static int orbSource(void* ctx, double unixSec, Vec3& posECI) {
+    OrbitModel& orb = *((PointingSolver*)ctx)->orb;
+    Vec3 vel;
+#if USE_SGP4
+    return orb.calcPosVelECI_UTC(UtcTime::fromUnixSeconds(unixSec), posECI, vel);
+#else
+    orb.calcPosVelECI_UTC(UtcTime::fromUnixSeconds(unixSec), posECI, vel);
+    return 0;
+#endif
+}
+
+// Bind to the pedestal location & orbit model. Call orbitUpdated() once the orbit is initialized
+void PointingSolver::begin(const Vec3& _llaRef, OrbitModel& _orb) {
+    llaRef = _llaRef;
+    orb = &_orb;
+    observer.init(llaRef, DEGREES);
+    useCache = USE_EPHEM_CACHE;
+    ephemStale = true;
+    orbErr = 0;
+    cached = false;
+    rates = Vec3{0, 0, 0};
+}
+
+// Reset derived state after the orbit model has been re-initialized from a new TLE
+void PointingSolver::orbitUpdated() {
+#if !USE_SGP4
+    tracker.init(*orb);
+#endif
+    ephemStale = true;
+    orbErr = 0;
+}
+
+// Refit the ephemeris cache after an orbit update, and top it up as it rolls forward, a few propagations per call
+void PointingSolver::fitEphem(uint64_t UTC_ms) {
+    if (!useCache || orbErr) return;
+    if (ephemStale) {
+        ephem.begin(orbSource, this, llaRef, UTC_ms);
+        ephemStale = false;
+    }
+    PROFILE_SCOPE(PROF_EPHEM_FIT);
+    ephem.fitNextSegment(UTC_ms);
+    if (ephem.srcErr) {
+        orbErr = ephem.srcErr;
+        ephemStale = true;
+    }
+}
+
+// Az/El & rates at UTC_ms. Uses the cached fit if it covers that time, otherwise runs the full chain
+// Returns false if the orbit model can't be propagated, in which case aer is held with zero rates
+bool PointingSolver::solve(uint64_t UTC_ms) {
+    cached = false;
+    if (orbErr) {
+        rates = Vec3{0, 0, 0};
+        return false;
+    }
+    if (useCache && !ephemStale) {
+        PROFILE_SCOPE(PROF_CACHE_EVAL);
+        cached = ephem.eval(UTC_ms, posNED, velNED);
+    }
+    if (!cached) {
+        {
+            PROFILE_SCOPE(PROF_PROPAGATE);
+#if USE_SGP4
+            // Calc ECI Pos/Vel for current UTC. A decayed or otherwise invalid element set holds the last
+            // pointing rather than driving the pedestal from garbage, until the next TLE update
+            UtcTime t = UtcTime::fromUnixMs(UTC_ms);
+            Vec3 pos, vel;
+            int err = orb->calcPosVelECI_UTC(t, pos, vel);
+            if (err) {
+                orbErr = err;
+                ephemStale = true;
+                rates = Vec3{0, 0, 0};
+                return false;
+            }
+            posECI = pos;
+            velECI = vel;
+
+            // Calc Earth-Rotation-Angle for current UTC
+            era = t.era();
+            posECEF = eci2ecef(posECI, -era);
+            velNED = observer.ecefVel2ned(eciVel2ecef(posECI, velECI, era));
+#else
+            // Calc ECI Pos/Vel & ERA for current UTC, warm-started from the previous tick
+            tracker.update(UTC_ms, posECI, velECI);
+            era = tracker.era;
+            posECEF = tracker.eci2ecef(posECI);
+            velNED = observer.ecefVel2ned(tracker.eciVel2ecef(posECI, velECI));
+#endif
+        }
+        {
+            PROFILE_SCOPE(PROF_ECEF2LLA);
+            posLLA = ecef2lla(posECEF, DEGREES);
+        }
+        {
+            PROFILE_SCOPE(PROF_ECEF2NED);
+            posNED = observer.ecef2ned(posECEF);
+        }
+    }
+    aer = ned2AzElRng(posNED);
+    rates = ned2AzElRates(posNED, velNED);
+    return true;
+}
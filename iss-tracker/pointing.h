@@ -0,0 +1,44 @@
+/*
+  pointing.h - Observer-relative pointing solution, from the orbit model to Az/El and their rates
+    Owns the ephemeris cache and the direct propagation chain used whenever the cache doesn't cover the
+    current time, so the firmware tasks and the host pedestal simulation share exactly the same path.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+#include "coord.h"
+#include "orbit_utils.h"
+#include "orbit_tracker.h"
+#include "sgp4.h"
+#include "cheb_cache.h"
+
+#if USE_SGP4
+typedef Sgp4 OrbitModel;
+#else
+typedef Orbit OrbitModel;
+#endif
+
+struct PointingSolver {
+    OrbitModel* orb;
+#if !USE_SGP4
+    OrbitTracker tracker;
+#endif
+    Vec3 llaRef;
+    ObserverFrame observer;     // Pedestal ECEF position & NED frame
+    ChebCache ephem;
+    bool useCache;
+    bool ephemStale;
+    int orbErr;     // Propagation error from the orbit model, pointing is held until the next orbitUpdated()
+
+    // Last solution
+    Vec3 posECI, velECI, posECEF, posLLA, posNED, velNED;
+    Vec3 aer;       // [deg, deg, m]
+    Vec3 rates;     // [deg/s, deg/s, m/s]
+    double era;
+    bool cached;    // Solved from the ephemeris cache
+
+    void begin(const Vec3& llaRef, OrbitModel& orb);
+    void orbitUpdated();
+    void fitEphem(uint64_t UTC_ms);
+    bool solve(uint64_t UTC_ms);
+};
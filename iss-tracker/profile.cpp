@@ -0,0 +1,59 @@
+/*
+  profile.cpp - Histogram storage & Serial dump for the scoped timers
+ */
+#include "profile.h"
+
+#if ENABLE_PROFILING
+
+static const char* stageNames[PROF_N_STAGES] = {
+    "propagate", "ecef2lla", "ecef2ned", "cacheEval", "ephemFit", "setTargetAz", "display", "tleRcv"
+};
+
+ProfStage profStages[PROF_N_STAGES];
+
+// Add one sample, bucketed by the bit length of its duration in microseconds
+void ProfStage::record(uint32_t ticks) {
+    if (count == 0 || ticks < minTicks) minTicks = ticks;
+    if (ticks > maxTicks) maxTicks = ticks;
+    count++;
+    totalTicks += ticks;
+
+    uint32_t us = ticks / PROF_TICKS_PER_US;
+    int bucket = us ? 32 - __builtin_clz(us) : 0;
+    if (bucket >= PROF_N_BUCKETS) bucket = PROF_N_BUCKETS - 1;
+    hist[bucket]++;
+}
+
+// Start the cycle counter where one has to be enabled, and clear all stages
+void profileBegin() {
+#if defined(ARDUINO) && defined(DWT)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    profileReset();
+}
+
+void profileReset() {
+    memset(profStages, 0, sizeof(profStages));
+}
+
+// Print count, min/mean/max [us] and the non-empty histogram buckets of every stage that ran
+void profileDump() {
+    Serial.printf("stage        count    min us   mean us    max us  histogram [<us:count]\n");
+    for (uint8_t i = 0; i < PROF_N_STAGES; ++i) {
+        const ProfStage& s = profStages[i];
+        if (!s.count) continue;
+        Serial.printf("%-11s %6lu %9.1f %9.1f %9.1f ", stageNames[i], (unsigned long)s.count,
+                      double(s.minTicks) / PROF_TICKS_PER_US, double(s.totalTicks) / s.count / PROF_TICKS_PER_US,
+                      double(s.maxTicks) / PROF_TICKS_PER_US);
+        for (int k = 0; k < PROF_N_BUCKETS; ++k) {
+            if (!s.hist[k]) continue;
+            if (k == PROF_N_BUCKETS - 1) Serial.printf(" >=%lu:%lu", 1UL << (k - 1), (unsigned long)s.hist[k]);
+            else Serial.printf(" <%lu:%lu", 1UL << k, (unsigned long)s.hist[k]);
+        }
+        Serial.printf("\n");
+    }
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+  profile.h - Scoped hot-path timers with fixed log2-bucket latency histograms
+    Ticks come from the DWT cycle counter where the core has one, from SysTick on the Cortex-M0+ (which
+    doesn't), and from std::chrono on the host. With ENABLE_PROFILING false the macros expand to nothing
+    and no histogram storage is compiled in.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+// Instrumented stages
+enum ProfStageId : uint8_t {
+    PROF_PROPAGATE,     // Orbit propagation & ERA (direct chain)
+    PROF_ECEF2LLA,
+    PROF_ECEF2NED,
+    PROF_CACHE_EVAL,    // Chebyshev cache position & velocity
+    PROF_EPHEM_FIT,     // One cache fit step (CHEB_EVALS_PER_TICK propagations)
+    PROF_SET_TARGET_AZ, // Pedestal::setTargetAz incl. its Serial prints
+    PROF_DISPLAY,       // displayCurrTime
+    PROF_TLE_RCV,       // tle.rcvData
+    PROF_N_STAGES
+};
+
+#if ENABLE_PROFILING
+
+#define PROF_N_BUCKETS  20  // Bucket k holds [2^(k-1), 2^k) us, bucket 0 under 1 us, the last is open-ended
+
+#if !defined(ARDUINO)
+#include <chrono>
+#define PROF_TICKS_PER_US 1000
+inline uint32_t profTicks() {
+    return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#elif defined(DWT)
+#define PROF_TICKS_PER_US (F_CPU / 1000000)
+inline uint32_t profTicks() {
+    return DWT->CYCCNT;
+}
+#else
+// SysTick counts down from LOAD every millisecond; combine it with the millis() count it drives
+#define PROF_TICKS_PER_US (F_CPU / 1000000)
+inline uint32_t profTicks() {
+    uint32_t ms, val;
+    do {
+        ms = millis();
+        val = SysTick->VAL;
+    } while (ms != millis());
+    return ms * (SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+#endif
+
+struct ProfStage {
+    uint32_t count;
+    uint32_t minTicks;
+    uint32_t maxTicks;
+    uint64_t totalTicks;
+    uint32_t hist[PROF_N_BUCKETS];
+
+    void record(uint32_t ticks);
+};
+
+extern ProfStage profStages[PROF_N_STAGES];
+
+// Records the lifetime of the enclosing scope against one stage
+struct ProfScope {
+    uint8_t stage;
+    uint32_t t0;
+
+    ProfScope(uint8_t _stage) : stage(_stage), t0(profTicks()) {}
+    ~ProfScope() { profStages[stage].record(profTicks() - t0); }
+};
+
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) ProfScope PROF_CONCAT(profScope_, __LINE__)(stage)
+
+void profileBegin();
+void profileReset();
+void profileDump();
+
+#else
+
+#define PROFILE_SCOPE(stage)
+inline void profileBegin() {}
+inline void profileReset() {}
+inline void profileDump() {}
+
+#endif
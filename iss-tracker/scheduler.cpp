@@ -0,0 +1,97 @@
+/*
+  scheduler.cpp - Cooperative task scheduler implementation
+ */
+#include "scheduler.h"
+
+// Set the clocks & idle hook and drop all tasks
+void Scheduler::begin(SchedClock _clockMs, SchedClock _clockUs, TaskFn _idle, void* _idleCtx) {
+    clockMs = _clockMs;
+    clockUs = _clockUs;
+    idle = _idle;
+    idleCtx = _idleCtx;
+    nTasks = 0;
+    lastIdle_us = clockUs();
+    maxIdleGap_us = 0;
+}
+
+// Register a periodic task, first due immediately. Tasks run in registration order when due together
+// Returns the task id, or -1 if the table is full
+int Scheduler::add(const char* name, TaskFn fn, void* ctx, uint32_t period_ms, uint32_t deadline_ms, uint32_t budget_us) {
+    if (nTasks >= SCHED_MAX_TASKS) return -1;
+    Task& t = tasks[nTasks];
+    memset(&t, 0, sizeof(t));
+    t.name = name;
+    t.fn = fn;
+    t.ctx = ctx;
+    t.period_ms = period_ms;
+    t.next_ms = clockMs();
+    t.deadline_ms = deadline_ms;
+    t.budget_us = budget_us;
+    t.enabled = true;
+    return nTasks++;
+}
+
+// Make a task due on the next pass, e.g. after an event it should react to
+void Scheduler::runNow(int id) {
+    tasks[id].next_ms = clockMs();
+}
+
+// Pause or resume a task. Resumed tasks are due immediately
+void Scheduler::setEnabled(int id, bool enabled) {
+    if (enabled && !tasks[id].enabled) tasks[id].next_ms = clockMs();
+    tasks[id].enabled = enabled;
+}
+
+// Change a task's period. Called from within the task, the new period already sets its next due time
+void Scheduler::setPeriod(int id, uint32_t period_ms) {
+    tasks[id].period_ms = period_ms;
+}
+
+// Call the idle hook, tracking the longest gap since the previous call
+void Scheduler::runIdle() {
+    uint32_t gap = clockUs() - lastIdle_us;
+    if (gap > maxIdleGap_us) maxIdleGap_us = gap;
+    if (idle) idle(idleCtx);
+    lastIdle_us = clockUs();
+}
+
+// One scheduling pass: run each due task once, with the idle hook before every task
+void Scheduler::runOnce() {
+    runIdle();
+    for (uint8_t i = 0; i < nTasks; ++i) {
+        Task& t = tasks[i];
+        uint32_t now = clockMs();
+        if (!t.enabled || !timeReached(now, t.next_ms)) continue;
+
+        uint32_t late = now - t.next_ms;
+        if (late > t.maxLate_ms) t.maxLate_ms = late;
+        if (t.deadline_ms && late > t.deadline_ms) t.nMissed++;
+
+        uint32_t start = clockUs();
+        t.fn(t.ctx);
+        uint32_t run = clockUs() - start;
+
+        t.nRuns++;
+        t.totalRun_us += run;
+        if (run > t.maxRun_us) t.maxRun_us = run;
+        if (t.budget_us && run > t.budget_us) t.nOverruns++;
+
+        // Keep a fixed cadence, but skip missed slots rather than running a burst to catch up
+        t.next_ms += t.period_ms;
+        if (timeReached(clockMs(), t.next_ms)) t.next_ms = clockMs() + t.period_ms;
+
+        runIdle();
+    }
+}
+
+// Clear accounting, e.g. once setup() blocking work is out of the way
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < nTasks; ++i) {
+        Task& t = tasks[i];
+        t.nRuns = t.nMissed = t.nOverruns = 0;
+        t.maxLate_ms = t.maxRun_us = 0;
+        t.totalRun_us = 0;
+    }
+    lastIdle_us = clockUs();
+    maxIdleGap_us = 0;
+}
@@ -0,0 +1,60 @@
+/*
+  scheduler.h - Cooperative, non-preemptive task scheduler for loop()
+    Tasks run at fixed periods from a 32-bit millisecond clock, with all time math done on unsigned
+    differences so millis() wraparound is harmless. An idle hook (stepper servicing) runs between every
+    task, so its worst-case latency is bounded by the longest single task, which is tracked per task.
+    Clocks are injected so the same code runs against millis()/micros() on target or a virtual clock on the host.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define SCHED_MAX_TASKS 8
+
+typedef uint32_t (*SchedClock)();
+typedef void (*TaskFn)(void* ctx);
+
+// True once `now` has reached `t`, valid while the two are within 2^31 ticks of each other
+inline bool timeReached(uint32_t now, uint32_t t) {
+    return int32_t(now - t) >= 0;
+}
+
+struct Task {
+    const char* name;
+    TaskFn fn;
+    void* ctx;
+    uint32_t period_ms;     // 0 runs on every pass
+    uint32_t next_ms;       // Next due time
+    uint32_t deadline_ms;   // Allowed start lateness, 0 to not track misses
+    uint32_t budget_us;     // Expected worst-case runtime, 0 to not track overruns
+    bool enabled;
+
+    // Accounting
+    uint32_t nRuns;
+    uint32_t nMissed;       // Started later than deadline_ms after being due
+    uint32_t nOverruns;     // Ran longer than budget_us
+    uint32_t maxLate_ms;
+    uint32_t maxRun_us;
+    uint64_t totalRun_us;
+};
+
+struct Scheduler {
+    Task tasks[SCHED_MAX_TASKS];
+    uint8_t nTasks;
+
+    SchedClock clockMs;
+    SchedClock clockUs;
+    TaskFn idle;
+    void* idleCtx;
+
+    uint32_t lastIdle_us;
+    uint32_t maxIdleGap_us;     // Longest time between idle hook calls
+
+    void begin(SchedClock clockMs, SchedClock clockUs, TaskFn idle, void* idleCtx);
+    int add(const char* name, TaskFn fn, void* ctx, uint32_t period_ms, uint32_t deadline_ms=0, uint32_t budget_us=0);
+    void runNow(int id);
+    void setEnabled(int id, bool enabled);
+    void setPeriod(int id, uint32_t period_ms);
+    void runOnce();
+    void resetStats();
+    void runIdle();
+};
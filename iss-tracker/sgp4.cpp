@@ -0,0 +1,276 @@
+/*
+  sgp4.cpp - Near-Earth SGP4 propagation
+    Reference: Vallado, Crawford, Hujsak & Kelso, "Revisiting Spacetrack Report #3", AIAA 2006-6753
+    Variable names follow the reference implementation so the two can be compared line by line.
+ */
+#include "sgp4.h"
+
+// Parse B* drag term from TLE line 1, columns 54-61, in the implied-decimal form " 28098-4"
+double getBstarFromTLE(const char* line1) {
+    char tbuff[6];
+    memcpy(tbuff, line1 + 54, 5);
+    tbuff[5] = '\0';
+    double bstar = atoi(tbuff) * 1e-5;
+
+    memcpy(tbuff, line1 + 59, 2);
+    tbuff[2] = '\0';
+    bstar *= pow(10., atoi(tbuff));
+
+    if (line1[53] == '-')
+        bstar *= -1.;
+    return bstar;
+}
+
+// Initialize from Two-Line-Element (TLE), reusing the Orbit TLE parser for the shared fields
+int Sgp4::initFromTLE(const char* line1, const char* line2) {
+    Orbit orb{};
+    orb.initFromTLE(line1, line2);
+    return initFromOrbit(orb, getBstarFromTLE(line1));
+}
+
+// Initialize from already-parsed TLE elements & precompute everything that doesn't depend on time
+int Sgp4::initFromOrbit(const Orbit& orb, double _bstar) {
+    const double x2o3 = 2.0 / 3.0;
+    const double j3oj2 = SGP4_J3 / SGP4_J2;
+
+    epoch = orb.epoch;
+    incl = orb.incl;
+    Omega = orb.Omega;
+    ecc = orb.ecc;
+    omega = orb.omega;
+    M0 = orb.M0;
+    bstar = _bstar;
+
+    // TLE mean motion (Kozai), rad/s -> rad/min
+    double no_kozai = orb.n * 60.;
+
+    // Recover original (Brouwer) mean motion & semi-major axis
+    double eccsq = ecc * ecc;
+    double omeosq = 1. - eccsq;
+    double rteosq = sqrt(omeosq);
+    cosio = cos(incl);
+    double cosio2 = cosio * cosio;
+
+    double ak = pow(SGP4_XKE / no_kozai, x2o3);
+    double d1 = 0.75 * SGP4_J2 * (3. * cosio2 - 1.) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    double adel = ak * (1. - del * del - del * (1. / 3. + 134. * del * del / 81.));
+    del = d1 / (adel * adel);
+    n = no_kozai / (1. + del);
+    if (n <= 0.) return SGP4_ERR_MEAN_MOT;
+
+    ao = pow(SGP4_XKE / n, x2o3);
+    sinio = sin(incl);
+    double po = ao * omeosq;
+    double con42 = 1. - 5. * cosio2;
+    con41 = -con42 - cosio2 - cosio2;
+    double posq = po * po;
+    double rp = ao * (1. - ecc);
+
+    if (TWO_PI / n >= 225.) return SGP4_ERR_DEEP_SPACE;
+
+    // Use the simplified drag model below 220 km perigee
+    isimp = rp < (220. / SGP4_RADIUS_KM + 1.);
+
+    // Atmospheric density parameters, adjusted for perigees below 156 km
+    double sfour = 78. / SGP4_RADIUS_KM + 1.;
+    double qzms24 = pow((120. - 78.) / SGP4_RADIUS_KM, 4);
+    double perige = (rp - 1.) * SGP4_RADIUS_KM;
+    if (perige < 156.) {
+        sfour = perige - 78.;
+        if (perige < 98.) sfour = 20.;
+        qzms24 = pow((120. - sfour) / SGP4_RADIUS_KM, 4);
+        sfour = sfour / SGP4_RADIUS_KM + 1.;
+    }
+
+    double pinvsq = 1. / posq;
+    double tsi = 1. / (ao - sfour);
+    eta = ao * ecc * tsi;
+    double etasq = eta * eta;
+    double eeta = ecc * eta;
+    double psisq = fabs(1. - etasq);
+    double coef = qzms24 * pow(tsi, 4);
+    double coef1 = coef / pow(psisq, 3.5);
+
+    double cc2 = coef1 * n * (ao * (1. + 1.5 * etasq + eeta * (4. + etasq)) +
+                 0.375 * SGP4_J2 * tsi / psisq * con41 * (8. + 3. * etasq * (8. + etasq)));
+    cc1 = bstar * cc2;
+    double cc3 = 0.;
+    if (ecc > 1.0e-4)
+        cc3 = -2. * coef * tsi * j3oj2 * n * sinio / ecc;
+    x1mth2 = 1. - cosio2;
+    cc4 = 2. * n * coef1 * ao * omeosq *
+          (eta * (2. + 0.5 * etasq) + ecc * (0.5 + 2. * etasq) -
+           SGP4_J2 * tsi / (ao * psisq) *
+           (-3. * con41 * (1. - 2. * eeta + etasq * (1.5 - 0.5 * eeta)) +
+            0.75 * x1mth2 * (2. * etasq - eeta * (1. + etasq)) * cos(2. * omega)));
+    cc5 = 2. * coef1 * ao * omeosq * (1. + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    // Secular rates from J2 & J4
+    double cosio4 = cosio2 * cosio2;
+    double temp1 = 1.5 * SGP4_J2 * pinvsq * n;
+    double temp2 = 0.5 * temp1 * SGP4_J2 * pinvsq;
+    double temp3 = -0.46875 * SGP4_J4 * pinvsq * pinvsq * n;
+    mdot = n + 0.5 * temp1 * rteosq * con41 +
+           0.0625 * temp2 * rteosq * (13. - 78. * cosio2 + 137. * cosio4);
+    argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7. - 114. * cosio2 + 395. * cosio4) +
+              temp3 * (3. - 36. * cosio2 + 49. * cosio4);
+    double xhdot1 = -temp1 * cosio;
+    nodedot = xhdot1 + (0.5 * temp2 * (4. - 19. * cosio2) + 2. * temp3 * (3. - 7. * cosio2)) * cosio;
+
+    omgcof = bstar * cc3 * cos(omega);
+    xmcof = 0.;
+    if (ecc > 1.0e-4)
+        xmcof = -x2o3 * coef * bstar / eeta;
+    nodecf = 3.5 * omeosq * xhdot1 * cc1;
+    t2cof = 1.5 * cc1;
+
+    // Avoid dividing by zero for 180 deg inclination
+    if (fabs(cosio + 1.) > 1.5e-12)
+        xlcof = -0.25 * j3oj2 * sinio * (3. + 5. * cosio) / (1. + cosio);
+    else
+        xlcof = -0.25 * j3oj2 * sinio * (3. + 5. * cosio) / 1.5e-12;
+    aycof = -0.5 * j3oj2 * sinio;
+    delmo = pow(1. + eta * cos(M0), 3);
+    sinmao = sin(M0);
+    x7thm1 = 7. * cosio2 - 1.;
+
+    // Higher-order drag terms
+    d2 = d3 = d4 = t3cof = t4cof = t5cof = 0.;
+    if (!isimp) {
+        double cc1sq = cc1 * cc1;
+        d2 = 4. * ao * tsi * cc1sq;
+        double temp = d2 * tsi * cc1 / 3.;
+        d3 = (17. * ao + sfour) * temp;
+        d4 = 0.5 * temp * ao * tsi * (221. * ao + 31. * sfour) * cc1;
+        t3cof = d2 + 2. * cc1sq;
+        t4cof = 0.25 * (3. * d3 + cc1 * (12. * d2 + 10. * cc1sq));
+        t5cof = 0.2 * (3. * d4 + 12. * cc1 * d3 + 6. * d2 * d2 + 15. * cc1sq * (2. * d2 + cc1sq));
+    }
+
+    return SGP4_OK;
+}
+
+// Calculate TEME position [m] & velocity [m/s] at some delta-T seconds from the TLE epoch
+int Sgp4::calcPosVelECI(double dt_sec, Vec3& posECI, Vec3& velECI) {
+    const double t = dt_sec / 60.;
+
+    // Secular gravity & atmospheric drag
+    double xmdf = M0 + mdot * t;
+    double argpdf = omega + argpdot * t;
+    double nodedf = Omega + nodedot * t;
+    double argpm = argpdf;
+    double mm = xmdf;
+    double t2 = t * t;
+    double nodem = nodedf + nodecf * t2;
+    double tempa = 1. - cc1 * t;
+    double tempe = bstar * cc4 * t;
+    double templ = t2cof * t2;
+
+    if (!isimp) {
+        double delomg = omgcof * t;
+        double delmtemp = 1. + eta * cos(xmdf);
+        double delm = xmcof * (delmtemp * delmtemp * delmtemp - delmo);
+        double temp = delomg + delm;
+        mm = xmdf + temp;
+        argpm = argpdf - temp;
+        double t3 = t2 * t;
+        double t4 = t3 * t;
+        tempa = tempa - d2 * t2 - d3 * t3 - d4 * t4;
+        tempe = tempe + bstar * cc5 * (sin(mm) - sinmao);
+        templ = templ + t3cof * t3 + t4 * (t4cof + t * t5cof);
+    }
+
+    double am = pow(SGP4_XKE / n, 2. / 3.) * tempa * tempa;
+    double nm = SGP4_XKE / pow(am, 1.5);
+    double em = ecc - tempe;
+    if (em >= 1. || em < -0.001) return SGP4_ERR_ECC;
+    if (em < 1.0e-6) em = 1.0e-6;
+
+    mm = mm + n * templ;
+    double xlm = mm + argpm + nodem;
+    nodem = fmod(nodem, TWO_PI);
+    argpm = fmod(argpm, TWO_PI);
+    xlm = fmod(xlm, TWO_PI);
+    mm = fmod(xlm - argpm - nodem, TWO_PI);
+
+    // Long-period periodics
+    double axnl = em * cos(argpm);
+    double temp = 1. / (am * (1. - em * em));
+    double aynl = em * sin(argpm) + temp * aycof;
+    double xl = mm + argpm + nodem + temp * xlcof * axnl;
+
+    // Solve Kepler's equation in the equinoctial form
+    double u = fmod(xl - nodem, TWO_PI);
+    double eo1 = u;
+    double tem5 = 9999.9;
+    double sineo1 = 0., coseo1 = 1.;
+    for (int ktr = 0; fabs(tem5) >= 1.0e-12 && ktr < 10; ++ktr) {
+        sineo1 = sin(eo1);
+        coseo1 = cos(eo1);
+        tem5 = 1. - coseo1 * axnl - sineo1 * aynl;
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+        if (fabs(tem5) >= 0.95)
+            tem5 = tem5 > 0. ? 0.95 : -0.95;
+        eo1 = eo1 + tem5;
+    }
+
+    // Short-period preliminary quantities
+    double ecose = axnl * coseo1 + aynl * sineo1;
+    double esine = axnl * sineo1 - aynl * coseo1;
+    double el2 = axnl * axnl + aynl * aynl;
+    double pl = am * (1. - el2);
+    if (pl < 0.) return SGP4_ERR_SEMILATUS;
+
+    double rl = am * (1. - ecose);
+    double rdotl = sqrt(am) * esine / rl;
+    double rvdotl = sqrt(pl) / rl;
+    double betal = sqrt(1. - el2);
+    temp = esine / (1. + betal);
+    double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = atan2(sinu, cosu);
+    double sin2u = (cosu + cosu) * sinu;
+    double cos2u = 1. - 2. * sinu * sinu;
+    temp = 1. / pl;
+    double temp1 = 0.5 * SGP4_J2 * temp;
+    double temp2 = temp1 * temp;
+
+    // Update for short-period periodics
+    double mrt = rl * (1. - 1.5 * temp2 * betal * con41) + 0.5 * temp1 * x1mth2 * cos2u;
+    su = su - 0.25 * temp2 * x7thm1 * sin2u;
+    double xnode = nodem + 1.5 * temp2 * cosio * sin2u;
+    double xinc = incl + 1.5 * temp2 * cosio * sinio * cos2u;
+    double mvt = rdotl - nm * temp1 * x1mth2 * sin2u / SGP4_XKE;
+    double rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u + 1.5 * con41) / SGP4_XKE;
+
+    if (mrt < 1.) return SGP4_ERR_DECAYED;
+
+    // Orientation vectors
+    double sinsu = sin(su), cossu = cos(su);
+    double snod = sin(xnode), cnod = cos(xnode);
+    double sini = sin(xinc), cosi = cos(xinc);
+    double xmx = -snod * cosi;
+    double xmy = cnod * cosi;
+    Vec3 uu = {xmx * sinsu + cnod * cossu, xmy * sinsu + snod * cossu, sini * sinsu};
+    Vec3 vv = {xmx * cossu - cnod * sinsu, xmy * cossu - snod * sinsu, sini * cossu};
+
+    // Earth radii -> meters, canonical velocity units -> m/s
+    const double r_m = SGP4_RADIUS_KM * 1e3;
+    const double v_ms = SGP4_RADIUS_KM * 1e3 * SGP4_XKE / 60.;
+    posECI = uu * (mrt * r_m);
+    velECI = (uu * mvt + vv * rvdot) * v_ms;
+
+    return SGP4_OK;
+}
+
+// Calculate TEME position & velocity at a specific UTC time
+int Sgp4::calcPosVelECI_UTC(UtcTime t, Vec3& posECI, Vec3& velECI) {
+    return calcPosVelECI(t.secondsSince(epoch), posECI, velECI);
+}
+
+// Calculate TEME position at a specific UTC time, for callers that share code with Orbit
+int Sgp4::calcPosECI_UTC(UtcTime t, Vec3& posECI) {
+    Vec3 velECI;
+    return calcPosVelECI(t.secondsSince(epoch), posECI, velECI);
+}
@@ -0,0 +1,47 @@
+/*
+  sgp4.h - SGP4 orbit propagator, usable as a drop-in alternative to the two-body Orbit model
+    Near-Earth SGP4 (period < 225 min) following Vallado et al., "Revisiting Spacetrack Report #3" (AIAA 2006-6753)
+    with WGS-72 constants. All epoch-dependent terms are computed once in initFromTLE.
+    Positions & velocities are in the TEME frame, which is treated as ECI throughout this project.
+ */
+#pragma once
+#include <Arduino.h>
+#include "orbit_utils.h"
+
+// WGS-72 constants used by SGP4 (the TLE fitting model), not to be mixed with wgs84.h
+#define SGP4_RADIUS_KM  6378.135
+#define SGP4_XKE        0.0743669161331734   // sqrt(GM) in earth radii^1.5 / min
+#define SGP4_J2         0.001082616
+#define SGP4_J3         -0.00000253881
+#define SGP4_J4         -0.00000165597
+
+// Error codes returned by Sgp4 methods
+#define SGP4_OK             0
+#define SGP4_ERR_ECC        1   // Mean eccentricity out of range
+#define SGP4_ERR_MEAN_MOT   2   // Mean motion <= 0
+#define SGP4_ERR_SEMILATUS  4   // Semi-latus rectum < 0
+#define SGP4_ERR_DECAYED    6   // Satellite has decayed
+#define SGP4_ERR_DEEP_SPACE 7   // Period >= 225 min, needs SDP4 which isn't implemented
+
+// Struct holding SGP4 mean elements & precomputed propagation constants
+struct Sgp4 {
+    UtcTime epoch;
+
+    // Mean elements at epoch (radians, radians/minute)
+    double incl, Omega, ecc, omega, M0, n, bstar;
+
+    // Epoch-dependent constants
+    bool isimp;
+    double ao, con41, x1mth2, x7thm1, cosio, sinio;
+    double eta, cc1, cc4, cc5, d2, d3, d4, delmo, sinmao;
+    double mdot, argpdot, nodedot, omgcof, xmcof, nodecf;
+    double t2cof, t3cof, t4cof, t5cof, xlcof, aycof;
+
+    int initFromTLE(const char* line1, const char* line2);
+    int initFromOrbit(const Orbit& orb, double bstar);
+    int calcPosVelECI(double dt_sec, Vec3& posECI, Vec3& velECI);
+    int calcPosVelECI_UTC(UtcTime t, Vec3& posECI, Vec3& velECI);
+    int calcPosECI_UTC(UtcTime t, Vec3& posECI);
+};
+
+double getBstarFromTLE(const char* line1);
@@ -0,0 +1,83 @@
+/*
+  time_utils.cpp - Time scale conversions & integer Earth-Rotation-Angle
+ */
+#include "time_utils.h"
+
+// High 64 bits of a * b, rounded, from four 32x32 partial products
+static uint64_t mulHi64(uint64_t a, uint64_t b) {
+    uint64_t al = a & 0xFFFFFFFFu, ah = a >> 32, bl = b & 0xFFFFFFFFu, bh = b >> 32;
+    uint64_t ll = al*bl, lh = al*bh, hl = ah*bl, hh = ah*bh;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32) + ((mid >> 31) & 1);
+}
+
+// Split nanoseconds since 1970 into a Julian date
+static JulianDate julianFromUnixNs(int64_t ns) {
+    int64_t days = floorDiv(ns, NS_PER_DAY);
+    return JulianDate{JD_UNIX_EPOCH + double(days), double(ns - days * NS_PER_DAY) / double(NS_PER_DAY)};
+}
+
+// From fractional Unix seconds, keeping the whole seconds out of the rounding
+UtcTime UtcTime::fromUnixSeconds(double sec) {
+    double whole = floor(sec);
+    return UtcTime{int64_t(whole) * NS_PER_SEC + llround((sec - whole) * 1e9)};
+}
+
+double UtcTime::unixSeconds() const {
+    int64_t sec = unixSec();
+    return double(sec) + double(ns - sec * NS_PER_SEC) / 1e9;
+}
+
+JulianDate UtcTime::julianUtc() const { return julianFromUnixNs(ns); }
+
+// Terrestrial Time = UTC + leap seconds + 32.184 s
+JulianDate UtcTime::julianTt() const {
+    return julianFromUnixNs(ns + TAI_MINUS_UTC_S * NS_PER_SEC + TT_MINUS_TAI_NS);
+}
+
+JulianDate UtcTime::julianUt1(int32_t dut1_us) const { return julianFromUnixNs(ns + int64_t(dut1_us) * 1000); }
+
+uint64_t UtcTime::eraTurns(int32_t dut1_us) const {
+    return ERA_TURNS_J2000 + eraDeltaTurns(ns + int64_t(dut1_us) * 1000 - J2000_UNIX_NS);
+}
+
+double UtcTime::era(int32_t dut1_us) const { return turnsToRad(eraTurns(dut1_us)); }
+
+// 00:00 UTC on a 1-based day of a Gregorian year
+UtcTime utcFromYearDay(int year, int32_t dayOfYear) {
+    int64_t y = year - 1;
+    int64_t daysBeforeYear = 365*y + floorDiv(y, 4) - floorDiv(y, 100) + floorDiv(y, 400) - 719162;   // 0001 -> 1970
+    return UtcTime{(daysBeforeYear + dayOfYear - 1) * NS_PER_DAY};
+}
+
+// Earth rotation over dt_ns of UT1 [Q64 turns], modulo one turn
+uint64_t eraDeltaTurns(int64_t dt_ns) {
+    uint64_t u = dt_ns < 0 ? -uint64_t(dt_ns) : uint64_t(dt_ns);
+    uint64_t d = u*ERA_RATE_INT + mulHi64(u, ERA_RATE_FRAC);
+    return dt_ns < 0 ? -d : d;
+}
+
+// Q64 turns to [0, 2pi)
+double turnsToRad(uint64_t turns) {
+    return double(turns >> 11) * (TWO_PI / 9007199254740992.);    // 2^53
+}
+
+// Q64 turn difference to a signed angle in [-pi, pi)
+double turnsToDeltaRad(uint64_t dTurns) {
+    return double(int64_t(dTurns)) * (TWO_PI / 18446744073709551616.);     // 2^64
+}
+
+// Exact ERA at t
+void EraClock::set(UtcTime _t, int32_t _dut1_us) {
+    t = _t;
+    dut1_us = _dut1_us;
+    turns = t.eraTurns(dut1_us);
+}
+
+// Step to t, returning the rotation since the previous tick [Q64 turns]
+uint64_t EraClock::advanceTo(UtcTime _t) {
+    uint64_t d = eraDeltaTurns(_t.ns - t.ns);
+    t = _t;
+    turns += d;
+    return d;
+}
@@ -0,0 +1,78 @@
+/*
+  time_utils.h - UTC instants, Julian dates in the UTC/TT/UT1 scales and the Earth-Rotation-Angle (ERA)
+    UtcTime is the single representation of an absolute time: signed 64-bit nanoseconds since 1970-01-01 UTC,
+    which spans 1678 to 2262 with no rounding. Like Unix time it does not count leap seconds. The millisecond
+    loop clock (NtpClock::utcMs) turns into a UtcTime where it meets the orbit code, with UtcTime::fromUnixMs.
+    Julian dates come out split into the preceding midnight plus a day fraction, both exact to one rounding.
+    ERA is kept as a Q64 fraction of a turn (2^64 = one turn): computing it from the time is integer-only, and
+    stepping it between ticks is an integer add whose overflow is the wrap at 2*pi, so nothing ever needs a
+    large-argument fmod.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define NS_PER_SEC      1000000000LL
+#define NS_PER_DAY      86400000000000LL
+#define JD_UNIX_EPOCH   2440587.5                   // Julian date of 1970-01-01 00:00
+#define J2000_UNIX_NS   946728000000000000LL        // 2000-01-01 12:00 (JD 2451545.0), the ERA reference
+#define TAI_MINUS_UTC_S 37                          // Leap seconds since 2017-01-01; bump at the next one
+#define TT_MINUS_TAI_NS 32184000000LL
+
+// ERA = 0.7790572732640 + 1.00273781191135448 * (JD_UT1 - 2451545.0) turns (IERS 2010), in Q64
+#define ERA_TURNS_J2000 0xC7704C26613B9137ULL       // 0.7790572732640 turns
+#define ERA_RATE_INT    214088ULL                   // Turns per ns in Q64: integer part
+#define ERA_RATE_FRAC   0x841DDB013390D864ULL       // and fraction, so the rate is exact to 2^-128 turn/ns
+
+// Division rounding toward -infinity, so instants before an epoch split into a whole part & a positive remainder
+inline int64_t floorDiv(int64_t a, int64_t b) { return a / b - (a % b < 0); }
+
+// Julian date as the preceding midnight (an exact .5 value) and the fraction of the day since then
+struct JulianDate {
+    double day;
+    double frac;
+
+    double value() const { return day + frac; }
+};
+
+// UTC instant in nanoseconds since the Unix epoch
+struct UtcTime {
+    int64_t ns;
+
+    static constexpr UtcTime fromUnixSec(int64_t sec) { return UtcTime{sec * NS_PER_SEC}; }
+    static constexpr UtcTime fromUnixMs(uint64_t ms) { return UtcTime{int64_t(ms) * 1000000}; }
+    static constexpr UtcTime fromUnixUs(int64_t us) { return UtcTime{us * 1000}; }
+    static UtcTime fromUnixSeconds(double sec);
+
+    int64_t unixSec() const { return floorDiv(ns, NS_PER_SEC); }
+    uint64_t unixMs() const { return uint64_t(floorDiv(ns, 1000000)); }
+    double unixSeconds() const;
+
+    // Elapsed time since t0 [s], to double precision however far both are from 1970
+    double secondsSince(UtcTime t0) const { return double(ns - t0.ns) / 1e9; }
+    UtcTime operator+(int64_t dns) const { return UtcTime{ns + dns}; }
+    UtcTime operator-(int64_t dns) const { return UtcTime{ns - dns}; }
+
+    JulianDate julianUtc() const;
+    JulianDate julianTt() const;
+    JulianDate julianUt1(int32_t dut1_us = 0) const;
+
+    // ERA [Q64 turns] & [rad, 0..2pi). dut1_us is UT1 - UTC, which is < 0.9 s; leaving it at 0 costs < 4 mdeg
+    uint64_t eraTurns(int32_t dut1_us = 0) const;
+    double era(int32_t dut1_us = 0) const;
+};
+
+UtcTime utcFromYearDay(int year, int32_t dayOfYear);
+uint64_t eraDeltaTurns(int64_t dt_ns);
+double turnsToRad(uint64_t turns);
+double turnsToDeltaRad(uint64_t dTurns);
+
+// Incremental ERA for closely spaced ticks: one exact set(), then integer steps between ticks
+struct EraClock {
+    UtcTime t;
+    uint64_t turns;
+    int32_t dut1_us;
+
+    void set(UtcTime t, int32_t dut1_us = 0);
+    uint64_t advanceTo(UtcTime t);
+    double angle() const { return turnsToRad(turns); }
+};
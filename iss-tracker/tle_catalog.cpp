@@ -0,0 +1,98 @@
+/*
+  tle_catalog.cpp - In-place TLE/3LE catalog scanning and validation
+    TLE Format: http://celestrak.org/columns/v04n03/#FAQ01
+ */
+#include "tle_catalog.h"
+
+// Verify the modulo-10 checksum in column 69: digits count as their value, '-' as 1, everything else 0
+bool tleChecksumOk(const char* line) {
+    int sum = 0;
+    for (int i = 0; i < TLE_LEN - 1; ++i) {
+        char c = line[i];
+        if (c >= '0' && c <= '9') sum += c - '0';
+        else if (c == '-') sum += 1;
+    }
+    return line[TLE_LEN - 1] == char('0' + sum % 10);
+}
+
+// Find the end of the line starting at p, not counting a trailing '\r'
+static const char* lineEnd(const char* p, const char* end, const char** next) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    const char* e = nl ? nl : end;
+    *next = nl ? nl + 1 : end;
+    if (e > p && e[-1] == '\r') e--;
+    return e;
+}
+
+// Check whether [p,e) has the shape of TLE line 1 or 2
+static bool isTleLine(const char* p, const char* e, char lineNo) {
+    return (e - p) >= TLE_LEN && p[0] == lineNo && p[1] == ' ';
+}
+
+void TleCatalogReader::begin(const char* _buf, size_t _len) {
+    buf = _buf;
+    len = _len;
+    pos = 0;
+    nRecords = 0;
+    nBad = 0;
+}
+
+// Advance to the next valid record. Lines that aren't part of a TLE pair are treated as candidate titles,
+// so HTTP headers or blank lines before the catalog are skipped naturally
+// Returns false at the end of the buffer
+bool TleCatalogReader::next(TleRecord& rec) {
+    const char* end = buf + len;
+    const char* p = buf + pos;
+    const char* title = NULL;
+    const char* titleEnd = NULL;
+
+    while (p < end) {
+        const char* next;
+        const char* e = lineEnd(p, end, &next);
+
+        if (isTleLine(p, e, '1') && next < end) {
+            const char* next2;
+            const char* e2 = lineEnd(next, end, &next2);
+            if (isTleLine(next, e2, '2')) {
+                pos = next2 - buf;
+                // Both lines must pass their checksums & agree on the catalog number (columns 3-7)
+                if (!tleChecksumOk(p) || !tleChecksumOk(next) || memcmp(p + 2, next + 2, 5) != 0) {
+                    nBad++;
+                    p = next2;
+                    title = NULL;
+                    continue;
+                }
+                rec.line1 = p;
+                rec.line2 = next;
+                rec.name = NULL;
+                rec.nameLen = 0;
+                if (title) {
+                    if (titleEnd - title >= 2 && title[0] == '0' && title[1] == ' ') title += 2;
+                    while (titleEnd > title && titleEnd[-1] == ' ') titleEnd--;
+                    rec.name = title;
+                    rec.nameLen = uint8_t(titleEnd - title > 255 ? 255 : titleEnd - title);
+                }
+                nRecords++;
+                return true;
+            }
+        }
+        title = p;
+        titleEnd = e;
+        p = next;
+    }
+    pos = len;
+    return false;
+}
+
+// Find the first valid record whose title starts with name
+// Returns 0 if found, -1 otherwise
+int findTLE(const char* buff, size_t len, const char* name, TleRecord& rec) {
+    size_t nameLen = strlen(name);
+    TleCatalogReader reader;
+    reader.begin(buff, len);
+    while (reader.next(rec)) {
+        if (rec.name && rec.nameLen >= nameLen && memcmp(rec.name, name, nameLen) == 0)
+            return 0;
+    }
+    return -1;
+}
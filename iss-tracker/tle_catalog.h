@@ -0,0 +1,31 @@
+/*
+  tle_catalog.h - Zero-copy scanner for TLE/3LE catalogs held in one contiguous buffer
+    Records are returned as views into the buffer, nothing is copied or allocated.
+    Works on a received HTTP body on the device or a memory-mapped Celestrak file on the host.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+// One satellite's entry, pointing into the scanned buffer. Lines are not null-terminated
+struct TleRecord {
+    const char* name;   // Title line with any "0 " prefix & trailing blanks stripped, NULL for 2LE records
+    uint8_t nameLen;
+    const char* line1;  // TLE_LEN characters each
+    const char* line2;
+};
+
+// Forward-only reader over a catalog buffer
+struct TleCatalogReader {
+    const char* buf;
+    size_t len;
+    size_t pos;
+    uint32_t nRecords;  // Valid records returned so far
+    uint32_t nBad;      // Line pairs rejected for bad checksums or mismatched catalog numbers
+
+    void begin(const char* buf, size_t len);
+    bool next(TleRecord& rec);
+};
+
+bool tleChecksumOk(const char* line);
+int findTLE(const char* buff, size_t len, const char* name, TleRecord& rec);
@@ -0,0 +1,75 @@
+/*
+  track_control.cpp - Feed-forward tracking law implementation
+ */
+#include "track_control.h"
+
+// Convert # of steps in stepper motor to equivalent relative pedestal angle in degrees
+double steps2deg(long steps) {
+    return double(-steps) * 360.0 / STEPS_PER_REV;
+}
+
+// Convert pedestal angle in degrees to equivalent # of steps in stepper motor
+long deg2steps(double azDeg) {
+    return floor(-azDeg * STEPS_PER_REV / 360.0);
+}
+
+// Wrap an angle difference to [-180,180)
+double wrapDeg180(double deg) {
+    deg = fmod(deg + 180.0, 360.0);
+    if (deg < 0) deg += 360.0;
+    return deg - 180.0;
+}
+
+// Start idle, with no target
+void TrackControl::begin() {
+    active = false;
+    speed = 0;
+    lastUpdate_ms = 0;
+}
+
+// New target Az/El & rates valid at now_ms
+void TrackControl::setTarget(double az, double _azRate, double el, double _elRate, uint32_t now_ms) {
+    az0 = az;
+    azRate = _azRate;
+    el0 = el;
+    elRate = _elRate;
+    t0_ms = now_ms;
+    active = true;
+}
+
+// Target azimuth extrapolated to now_ms [deg], not wrapped
+double TrackControl::azAt(uint32_t now_ms) const {
+    uint32_t dt = now_ms - t0_ms;
+    if (dt > TRACK_MAX_EXTRAP_MS) dt = TRACK_MAX_EXTRAP_MS;
+    return az0 + azRate * dt * 1e-3;
+}
+
+// Target elevation extrapolated to now_ms [deg]
+double TrackControl::elAt(uint32_t now_ms) const {
+    uint32_t dt = now_ms - t0_ms;
+    if (dt > TRACK_MAX_EXTRAP_MS) dt = TRACK_MAX_EXTRAP_MS;
+    return el0 + elRate * dt * 1e-3;
+}
+
+// Stepper speed [steps/s] to follow the target: feed-forward rate plus proportional error correction,
+// limited to STEPPER_SPEED and to STEPPER_ACCEL since the previous command
+float TrackControl::speedCommand(long currentSteps, uint32_t now_ms) {
+    float dt = (now_ms - lastUpdate_ms) * 1e-3f;
+    lastUpdate_ms = now_ms;
+    if (!active) {
+        speed = 0;
+        return speed;
+    }
+
+    double err = wrapDeg180(azAt(now_ms) - steps2deg(currentSteps));
+    double uncapped = azRate + TRACK_GAIN * err;
+    float cmd = float(-uncapped * STEPS_PER_REV / 360.0);
+
+    float dvMax = STEPPER_ACCEL * dt;
+    if (cmd > speed + dvMax) cmd = speed + dvMax;
+    if (cmd < speed - dvMax) cmd = speed - dvMax;
+    if (cmd > STEPPER_SPEED) cmd = STEPPER_SPEED;
+    if (cmd < -STEPPER_SPEED) cmd = -STEPPER_SPEED;
+    speed = cmd;
+    return speed;
+}
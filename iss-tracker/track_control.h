@@ -0,0 +1,33 @@
+/*
+  track_control.h - Velocity feed-forward azimuth/elevation tracking law for the pedestal
+    Each orbit tick supplies the target's Az/El and their rates. Between ticks the target is extrapolated
+    linearly, and the stepper speed is commanded as the azimuth rate plus a proportional correction of the
+    remaining error, so the pointer moves continuously instead of stopping at each step target.
+    Hardware-independent so the same law runs in the firmware and in host simulations.
+ */
+#pragma once
+#include <Arduino.h>
+#include "defs.h"
+
+#define TRACK_UPDATE_MS     20      // Speed & elevation command refresh interval
+#define TRACK_GAIN          2.0     // Proportional correction of azimuth error [1/s]
+#define TRACK_MAX_EXTRAP_MS 2000    // Hold the target rather than extrapolating further than this
+
+double steps2deg(long steps);
+long deg2steps(double azDeg);
+double wrapDeg180(double deg);
+
+struct TrackControl {
+    bool active;
+    uint32_t t0_ms;             // Time of the last target update
+    double az0, azRate;         // [deg], [deg/s] at t0_ms
+    double el0, elRate;
+    float speed;                // Last commanded stepper speed [steps/s]
+    uint32_t lastUpdate_ms;
+
+    void begin();
+    void setTarget(double az, double azRate, double el, double elRate, uint32_t now_ms);
+    double azAt(uint32_t now_ms) const;
+    double elAt(uint32_t now_ms) const;
+    float speedCommand(long currentSteps, uint32_t now_ms);
+};
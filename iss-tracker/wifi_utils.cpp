@@ -3,96 +3,89 @@
  */
 #include "wifi_utils.h"
 
-// Initialize UDP connection on local port
+// Reset the clock model. The UDP socket is opened and the server looked up on the first request, which may
+// come after setup() if the WiFi link wasn't up yet
 void NtpQueryHandler::begin() {
-    Udp.begin(localPort);
+    udpOpen = false;
+    serverIP = IPAddress(0, 0, 0, 0);
+    nUnanswered = 0;
+    clock.begin();
 }
 
-// Send an NTP request to the time server at the given address
+// Look up NTP_SERVER. It is a round-robin name, so a lookup may give a different server, whose samples must
+// not be mixed into the old one's drift fit. A failed lookup keeps the current address
+void NtpQueryHandler::resolveServer() {
+    nUnanswered = 0;
+    IPAddress ip;
+    if (WiFi.hostByName(NTP_SERVER, ip) != 1) return;
+    if (uint32_t(serverIP) != 0 && uint32_t(ip) != uint32_t(serverIP)) {
+        Serial.println("NTP server address changed, restarting the drift fit");
+        clock.serverChanged();
+    }
+    serverIP = ip;
+}
+
+// Send an NTP request to the pinned server, stamped so the reply can be matched to it. The name is only
+// looked up again after NTP_MAX_UNANSWERED requests in a row went unanswered
 void NtpQueryHandler::sendNTPpacket() {
-    // set all bytes in the buffer to 0
-    memset(packetBuffer, 0, NTP_PACKET_SIZE);
-    // Initialize values needed to form NTP request
-    packetBuffer[0] = 0b11100011;   // LI, Version, Mode
-    packetBuffer[1] = 0;     // Stratum, or type of clock
-    packetBuffer[2] = 6;     // Polling Interval
-    packetBuffer[3] = 0xEC;  // Peer Clock Precision
-    // 8 bytes of zero for Root Delay & Root Dispersion
-    packetBuffer[12]  = 49;
-    packetBuffer[13]  = 0x4E;
-    packetBuffer[14]  = 49;
-    packetBuffer[15]  = 52;
-
-    // all NTP fields have been given values, now
-    // you can send a packet requesting a timestamp:
-    Udp.beginPacket("time.nist.gov", 123); //NTP requests are to port 123
+    if (!udpOpen) udpOpen = Udp.begin(localPort);
+    if (clock.pending) nUnanswered++;
+    if (uint32_t(serverIP) == 0 || nUnanswered >= NTP_MAX_UNANSWERED) resolveServer();
+    if (uint32_t(serverIP) == 0) return;
+
+    clock.buildRequest(packetBuffer, millis());
+    Udp.beginPacket(serverIP, 123); //NTP requests are to port 123
     Udp.write(packetBuffer, NTP_PACKET_SIZE);
     Udp.endPacket();
 }
 
-// Check if UDP Packet received and if so, parse it
+// Check if UDP Packet received and if so, feed it to the clock model.
+// Returns true once a reply to the outstanding request was received, even if it was too delayed to use
 bool NtpQueryHandler::parsePacket() {
-    if (Udp.parsePacket()) {
-        Serial.println("packet received");
-        // We've received a packet, read the data from it
-        Udp.read(packetBuffer, NTP_PACKET_SIZE); // read the packet into the buffer
-
-        //the timestamp starts at byte 40 of the received packet and is four bytes,
-        // or two words, long. First, esxtract the two words:
-        unsigned long highWord = word(packetBuffer[40], packetBuffer[41]);
-        unsigned long lowWord = word(packetBuffer[42], packetBuffer[43]);
-        // combine the four bytes (two words) into a long integer
-        // this is NTP time (seconds since Jan 1 1900):
-        unsigned long secsSince1900 = highWord << 16 | lowWord;
-        Serial.print("Seconds since Jan 1 1900 = ");
-        Serial.println(secsSince1900);
-
-        // Unix time starts on Jan 1 1970. In seconds, that's 2208988800:
-        
-        // subtract seventy years:
-        unixEpoch = secsSince1900 - seventyYears;
-
-        // Set system time based on received packet
-        setTime(unixEpoch + timeZone * SECS_PER_HOUR);
-
-        // print Unix time:
-        Serial.println(int32_t(unixEpoch));
-        lastQueryTimeMillis = millis();
-
+    int len = Udp.parsePacket();
+    if (!len) return false;
+
+    // Stamp arrival before the SPI transfer from the WiFi co-processor
+    uint32_t rxMillis = millis();
+    len = Udp.read(packetBuffer, NTP_PACKET_SIZE);
+    int rc = clock.processReply(packetBuffer, len > 0 ? len : 0, rxMillis);
+    if (rc == NTP_INVALID) {
+        Serial.println("NTP reply rejected");
+        return false;
+    }
+    nUnanswered = 0;
+    if (rc == NTP_FILTERED) {
+        Serial.println("NTP reply delayed, ignored");
         return true;
     }
-    return false;
-}
 
-// Split full 3-Line-Element (3LE) string into Two-Line-Element components
-// TLE Format: http://celestrak.org/columns/v04n03/#FAQ01
-int read3LE(char* buff, char* line1, char* line2) {
+    // Set system time based on the disciplined clock
+    unixEpoch = time_t(clock.utcMs(rxMillis) / 1000);
+    setTime(unixEpoch + timeZone * SECS_PER_HOUR);
+    lastQueryTimeMillis = rxMillis;
 
-    int idx = 0;
-    String str = "";
+    Serial.printf("NTP delay %ld us, residual %ld us, drift %ld ppb, next poll %lu s\n",
+                  clock.fit[(clock.fitHead + NTP_FIT_LEN - 1) % NTP_FIT_LEN].delay_us, clock.lastResidual_us,
+                  clock.drift_ppb, clock.poll_s);
+    return true;
+}
 
-    // Read lines until header found
-    while (idx < MAX_BUFFER) {
-        str += *buff; // Read character from buffer into string
-        if (*buff == '\n') {
-            if (str.startsWith(HEADER_STR)) break;
-            else str = "";
-        }
-        buff++;
-        idx++;
-    }
-    
-    // If reached end of buffer, header not found
-    if (idx == MAX_BUFFER) return -1;
-    buff++;
-    memcpy(line1, buff, TLE_LEN);
-    memcpy(line2, buff+71, TLE_LEN);
-
-    return 0;
+// Keep the record titled HEADER_STR from the streamed catalog
+// TLE Format: http://celestrak.org/columns/v04n03/#FAQ01
+static void onTleRecord(void* ctx, const TleRecord& rec) {
+    TleQueryHandler* tle = (TleQueryHandler*)ctx;
+    size_t nameLen = strlen(HEADER_STR);
+    if (tle->found || !rec.name || rec.nameLen < nameLen || memcmp(rec.name, HEADER_STR, nameLen) != 0) return;
+
+    memcpy(tle->line1, rec.line1, TLE_LEN);
+    memcpy(tle->line2, rec.line2, TLE_LEN);
+    tle->found = true;
 }
 
 // Connect to Celestrak and send query for the latest ISS 3LE
 void TleQueryHandler::sendQuery() {
+    found = false;
+    stream.begin(onTleRecord, this);
     if (client.connect(SERVER, 80)) {
         Serial.println("connected to server");
         // Make a HTTP request:
@@ -104,26 +97,26 @@ void TleQueryHandler::sendQuery() {
     }
 }
 
-// Read received characters into a buffer and return true when we have received everything
+// Feed received characters to the stream parser and return true when the response is complete or failed
 bool TleQueryHandler::rcvData() {
-    if (!client.connected()){
+    uint8_t chunk[RCV_CHUNK];
+    int n;
+    while (!stream.done() && !stream.failed() && (n = client.read(chunk, RCV_CHUNK)) > 0)
+        stream.feed((const char*)chunk, n);
+
+    if (stream.done() || stream.failed() || !client.connected()) {
+        if (!stream.done() && !stream.failed()) stream.finish();
         Serial.println();
         Serial.println("disconnecting from server.");
         client.stop();
-        rcvBytes = 0;
-        return true; 
-    }
-    while (client.available()) {
-        char c = client.read();
-        rcvBuffer[rcvBytes]=c;
-        rcvBytes++;
+        return true;
     }
     return false;
 }
 
-// Parse characters in received buffer and store TLE lines
+// Return 0 if the last response held a valid HEADER_STR record, now stored in line1/line2
 int TleQueryHandler::readTLE() {
-    return read3LE(rcvBuffer,line1,line2);
+    return found ? 0 : -1;
 }
 
 // Create Orbit struct from parsed TLE strings
@@ -131,6 +124,11 @@ void TleQueryHandler::getOrbit(Orbit& orb) {
     orb.initFromTLE(line1,line2);
 }
 
+// Create SGP4 propagator from parsed TLE strings
+void TleQueryHandler::getOrbit(Sgp4& orb) {
+    orb.initFromTLE(line1,line2);
+}
+
 void printEncryptionType(int thisType) {
     // read the encryption type and print out the name:
     switch (thisType) {
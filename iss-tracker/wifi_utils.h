@@ -8,27 +8,30 @@
 #include <WiFiUdp.h>
 #include "defs.h"
 #include "orbit_utils.h"
+#include "sgp4.h"
+#include "http_tle_stream.h"
+#include "ntp_clock.h"
 #include "TimeLib.h"
 
-#define NTP_PACKET_SIZE 48
-
-const unsigned long seventyYears = 2208988800UL;
 const unsigned int localPort = 2390;      // local port to listen for UDP packets
 
 void printEncryptionType(int thisType);
 void listNetworks();
 
-int read3LE(char* buff, char* line1, char* line2);
-
 // Struct to handle UDP querying of NTP Time Server
 struct NtpQueryHandler {
     WiFiUDP Udp;
+    bool udpOpen;
+    IPAddress serverIP;     // NTP_SERVER, resolved once so every sample comes from the same server
+    uint8_t nUnanswered;
     byte packetBuffer[NTP_PACKET_SIZE];
+    NtpClock clock;         // Disciplined UTC, use this rather than extrapolating unixEpoch
 
     time_t unixEpoch;
     time_t lastQueryTimeMillis;
 
     void begin();
+    void resolveServer();
     void sendNTPpacket();
     bool parsePacket();
 };
@@ -37,8 +40,8 @@ struct NtpQueryHandler {
 struct TleQueryHandler {
     WiFiClient client;
 
-    char rcvBuffer[MAX_BUFFER];
-    uint32_t rcvBytes;
+    HttpTleStream stream;   // Parses the response as it arrives, no full-body buffer
+    bool found;             // HEADER_STR record seen in the current response
 
     char line1[TLE_LEN];
     char line2[TLE_LEN];
@@ -47,4 +50,5 @@ struct TleQueryHandler {
     bool rcvData();
     int readTLE();
     void getOrbit(Orbit& orb);
+    void getOrbit(Sgp4& orb);
 };